@@ -3,8 +3,14 @@
 #include "behavior.hpp"
 #include "common.hpp"
 #include "compensator.hpp"
+#include "debug_server.hpp"
 #include "hik_camera.hpp"
+#include "metrics.hpp"
 #include "robot.hpp"
+#include "thread_policy.hpp"
+#include "timer.hpp"
+#include "trace.hpp"
+#include "visualizer.hpp"
 
 class AutomaticAim : public App {
  private:
@@ -16,9 +22,22 @@ class AutomaticAim : public App {
 
   game::Arm arm_ = game::Arm::kUNKNOWN;
 
+  component::Recorder recorder_;
+  component::metrics::Exporter exporter_;
+  component::DebugServer server_;
+  Visualizer visualizer_;
+
  public:
-  AutomaticAim(const std::string& log_path) : App(log_path) {
+  AutomaticAim(const std::string& log_path)
+      : App(log_path),
+        exporter_("logs/aim_assitant.metrics", "/tmp/qdu_rm_ai.metrics"),
+        server_("127.0.0.1", 8080, &exporter_),
+        visualizer_("show", std::getenv("DISPLAY") == nullptr, 2, 10,
+                    &server_) {
     SPDLOG_WARN("***** Setting Up Auto Aiming System. *****");
+    component::trace::Enable(true);
+    component::trace::DumpOnExit("logs/aim_assitant.trace.json");
+    component::thread_policy::Load("../../../runtime/thread_policy.json");
     cam_.Open(0);
     cam_.Setup(480, 640);
 
@@ -29,6 +48,7 @@ class AutomaticAim : public App {
     assitant_.SetClassiferParam("../../../runtime/armor_classifier.onnx",
                                 "../../../runtime/armor_classifier_lable.json",
                                 cv::Size(28, 28));
+    assitant_.LoadSelectParams("../../../runtime/RMUT2022_Select.json");
 
     compensator_.LoadCameraMat("runtime/MV-CA016-10UC-6mm.json");
   }
@@ -45,6 +65,9 @@ class AutomaticAim : public App {
     assitant_.SetEnemyTeam(robot_.GetEnemyTeam());
     assitant_.SetRace(robot_.GetRace());
     assitant_.SetArm(arm_);
+    compensator_.SetArm(arm_);
+    /* 步兵会在装甲板和能量机关之间切换，两条流水线同时运行以免切换时预热 */
+    assitant_.SetConcurrent(arm_ == game::Arm::kINFANTRY);
     assitant_.SetTime(robot_.GetTime());
     manager_.Update(robot_.GetBaseHP(), robot_.GetSentryHP(),
                     robot_.GetBalletRemain());
@@ -57,6 +80,7 @@ class AutomaticAim : public App {
     assitant_.SetEnemyTeam(game::Team::kBLUE);
     assitant_.SetRace(game::Race::kRMUC);
     assitant_.SetArm(game::Arm::kSENTRY);
+    compensator_.SetArm(arm_);
     assitant_.SetTime(10);
     manager_.Update(robot_.GetBaseHP(), robot_.GetSentryHP(),
                     robot_.GetBalletRemain());
@@ -71,6 +95,7 @@ class AutomaticAim : public App {
   /* 运行的主程序 */
   void Run() {
     SPDLOG_WARN("***** Running Auto Aiming System. *****");
+    component::thread_policy::Apply("VisionLoop");
 
     while (1) {
       cv::Mat frame = cam_.GetFrame();
@@ -79,8 +104,11 @@ class AutomaticAim : public App {
       assitant_.SetRFID(robot_.GetRFID());
       auto armors = assitant_.Aim(frame);
 
-      if (armors.size() > 0) {
-        compensator_.Apply(armors, frame, robot_.GetEuler());
+      /* Aim 的结果已经过目标选择，只解算并瞄准第一个 */
+      compensator_.SetBalletSpeed(robot_.GetBalletSpeed());
+      if (armors.size() > 0 &&
+          compensator_.Apply(armors, frame,
+                             robot_.GetEulerAt(cam_.GetFrameStamp()), 1) > 0) {
         Armor armor = armors.front();
 
         if (arm_ == game::Arm::kSENTRY) {
@@ -90,14 +118,21 @@ class AutomaticAim : public App {
         }
 
         manager_.Aim(armor.GetAimEuler());
-        assitant_.VisualizeResult(frame, 10);
-        robot_.Pack(manager_.GetData(), armor.GetTransVec().at<double>(0, 2));
+        robot_.Pack(manager_.GetData(), armor.GetTransVec().at<double>(2, 0));
       }
 
-      cv::imshow("show", frame);
-      if (' ' == cv::waitKey(10)) {
-        cv::waitKey(0);
+      /* 绘制与显示在显示线程中进行，这里只提交快照 */
+      if (visualizer_.Wanted()) {
+        Visualizer::Snapshot snapshot;
+        snapshot.frame = frame;
+        snapshot.frame_id = cam_.frame_id_;
+        snapshot.armors = std::move(armors);
+        visualizer_.Post(std::move(snapshot));
       }
+      /* t 导出 trace */
+      if ('t' == visualizer_.TakeKey())
+        component::trace::Dump("logs/aim_assitant.trace.json");
+      recorder_.Record();
     }
   }
 };
@@ -1,36 +1,171 @@
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <string>
+
 #include "app.hpp"
 #include "armor_detector.hpp"
 #include "behavior.hpp"
 #include "compensator.hpp"
+#include "debug_server.hpp"
 #include "hik_camera.hpp"
+#include "metrics.hpp"
+#include "record.hpp"
+#include "replay_camera.hpp"
 #include "robot.hpp"
+#include "target_selector.hpp"
+#include "thread_policy.hpp"
+#include "trace.hpp"
+#include "visualizer.hpp"
+
+namespace {
+
+const char kREPLAY_OUTPUT[] = "logs/auto_aim.replay";
+const std::size_t kMAX_DIFFS = 5; /* 最多打印的不同行数 */
+/* 回放时不定期导出，直方图在结束时汇总整个回放 */
+const std::chrono::hours kREPLAY_EXPORT_PERIOD(24);
+
+}  // namespace
 
 class AutoAim : private App {
  private:
+  /* 先于 robot_ 构造，后于其析构 */
+  component::record::Writer record_;
   Robot robot_;
-  HikCamera cam_;
+  std::unique_ptr<Camera> cam_;
+  ReplayCamera* replay_ = nullptr; /* 回放时指向 cam_ */
   ArmorDetector detector_;
+  TargetSelector selector_;
   Compensator compensator_;
   Behavior manager_;
 
   component::Recorder recorder_;
+  component::metrics::Exporter exporter_;
+  component::DebugServer server_;
+  Visualizer visualizer_;
+
+  std::string baseline_;
+  std::ofstream commands_;
+  bool matched_ = true;
+
+  /* 每帧输出一行：帧号与指令的原始字节，没有指令时为 "-" */
+  void WriteCommand() {
+    Protocol_DownData_t command;
+    commands_ << cam_->frame_id_;
+    if (robot_.TakeCommand(command)) {
+      const auto* bytes = reinterpret_cast<const uint8_t*>(&command);
+      commands_ << ' ' << std::hex << std::setfill('0');
+      for (std::size_t i = 0; i < sizeof(command); ++i)
+        commands_ << std::setw(2) << static_cast<int>(bytes[i]);
+      commands_ << std::dec;
+    } else {
+      commands_ << " -";
+    }
+    commands_ << '\n';
+  }
+
+  /* 与基准输出逐行比对，检查改动是否影响结果 */
+  bool Compare(const std::string& output, const std::string& baseline) {
+    std::ifstream out(output), base(baseline);
+    if (!base) {
+      SPDLOG_ERROR("Can't open baseline {}.", baseline);
+      return false;
+    }
+    std::string line, expected;
+    std::size_t lines = 0, diffs = 0;
+    while (true) {
+      const bool has_line = static_cast<bool>(std::getline(out, line));
+      const bool has_expected = static_cast<bool>(std::getline(base, expected));
+      if (!has_line && !has_expected) break;
+      ++lines;
+      if (has_line && has_expected && line == expected) continue;
+      if (diffs++ < kMAX_DIFFS)
+        SPDLOG_WARN("Line {} differs. baseline: {}, output: {}", lines,
+                    has_expected ? expected : "<none>",
+                    has_line ? line : "<none>");
+    }
+    if (diffs > 0)
+      SPDLOG_ERROR("{} of {} frames differ from {}.", diffs, lines, baseline);
+    else
+      SPDLOG_WARN("All {} frames match {}.", lines, baseline);
+    return diffs == 0;
+  }
+
+  /* 汇总回放的帧率与各阶段耗时 */
+  void Report(std::size_t frames, std::chrono::duration<double> elapsed) {
+    SPDLOG_WARN("Replayed {} frames in {:.3f}s, {:.1f} fps.", frames,
+                elapsed.count(), frames / elapsed.count());
+    for (const char* name :
+         {"pipeline", "detect", "compensate", "pnp", "pack"}) {
+      const auto summary = component::metrics::GetHistogram(name).Collect();
+      SPDLOG_WARN(
+          "{:>10} : count {}, mean {:.1f}us, p50 {:.1f}us, p99 {:.1f}us, "
+          "max {:.1f}us",
+          name, summary.count, summary.mean / 1e3, summary.p50 / 1e3,
+          summary.p99 / 1e3, summary.max / 1e3);
+    }
+
+    commands_.close();
+    SPDLOG_WARN("Commands written to {}.", kREPLAY_OUTPUT);
+    if (!baseline_.empty()) matched_ = Compare(kREPLAY_OUTPUT, baseline_);
+  }
 
  public:
-  AutoAim(const std::string& log_path) : App(log_path) {
+  /**
+   * @brief Construct a new AutoAim object
+   *
+   * @param log_path 日志路径
+   * @param replay_path 回放的文件，为空时使用相机与串口
+   * @param realtime 是否按录制时的间隔回放，否则尽快处理每一帧
+   * @param baseline 与回放输出比对的基准文件，为空时不比对
+   */
+  AutoAim(const std::string& log_path, const std::string& replay_path = "",
+          bool realtime = false, const std::string& baseline = "")
+      : App(log_path),
+        record_(std::getenv("QDU_RECORD") ? std::getenv("QDU_RECORD") : ""),
+        exporter_("logs/auto_aim.metrics", "/tmp/qdu_rm_ai.metrics",
+                  replay_path.empty()
+                      ? std::chrono::milliseconds(std::chrono::seconds(1))
+                      : std::chrono::milliseconds(kREPLAY_EXPORT_PERIOD)),
+        server_("127.0.0.1", 8080, &exporter_),
+        visualizer_("show", std::getenv("DISPLAY") == nullptr, 2, 10,
+                    &server_),
+        baseline_(baseline) {
     SPDLOG_WARN("***** Setting Up Auto Aiming System. *****");
+    component::trace::Enable(true);
+    component::trace::DumpOnExit("logs/auto_aim.trace.json");
 
-    /* 初始化设备 */
-    robot_.Init("/dev/ttyACM0");
-    cam_.Open(0);
-    cam_.Setup(640, 480);
+    /* 初始化设备，回放时由录制的数据代替相机与串口 */
+    if (replay_path.empty()) {
+      /* 回放不绑核、不锁内存，也不会锁住整个录制文件的映射 */
+      component::thread_policy::Load("../../../../runtime/thread_policy.json");
+      cam_ = std::make_unique<HikCamera>();
+      robot_.Init("/dev/ttyACM0");
+    } else {
+      replay_ = new ReplayCamera(replay_path, realtime);
+      cam_.reset(replay_);
+      replay_->SetRobot(&robot_);
+      commands_.open(kREPLAY_OUTPUT);
+      if (realtime && !baseline_.empty())
+        SPDLOG_WARN("Realtime replay skips frames, output may differ.");
+    }
+    robot_.SetRecord(&record_);
+    cam_->Open(0);
+    cam_->Setup(640, 480);
     detector_.LoadParams("../../../../runtime/RMUL2022_Armor.json");
+    selector_.LoadParams("../../../../runtime/RMUT2022_Select.json");
     compensator_.LoadCameraMat("../../../../runtime/MV-CA016-10UC-6mm_1.json");
 
-    do {
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    } while (robot_.GetEnemyTeam() != game::Team::kUNKNOWN);
+    /* 回放时第一帧之前的裁判系统数据已注入 */
+    if (replay_ == nullptr) {
+      do {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      } while (robot_.GetEnemyTeam() != game::Team::kUNKNOWN);
+    }
 
     detector_.SetEnemyTeam(robot_.GetEnemyTeam());
+    compensator_.SetArm(robot_.GetArm());
     // detector_.SetEnemyTeam(game::Team::kBLUE);
   }
 
@@ -40,37 +175,84 @@ class AutoAim : private App {
     SPDLOG_WARN("***** Shuted Down Auto Aiming System. *****");
   }
 
+  /* 回放输出与基准一致，未比对时为 true */
+  bool Matched() const { return matched_; }
+
   /* 运行的主程序 */
   void Run() {
     SPDLOG_WARN("***** Running Auto Aiming System. *****");
+    component::thread_policy::Apply("VisionLoop");
 
-    while (1) {
-      cv::Mat frame = cam_.GetFrame();
+    const auto start = std::chrono::steady_clock::now();
+    std::size_t frames = 0;
+    while (replay_ == nullptr || !replay_->Finished()) {
+      cv::Mat frame = cam_->GetFrame();
       if (frame.empty()) continue;
-      auto armors = detector_.Detect(frame);
-
-      if (armors.size() != 0) {
-        compensator_.Apply(armors, frame, robot_.GetEuler());
-        manager_.Aim(armors.front().GetAimEuler());
-        robot_.Pack(manager_.GetData(), 9999);
+      ++frames;
+      record_.Write(frame, cam_->GetFrameStamp(), cam_->frame_id_);
+      tbb::concurrent_vector<Armor> armors;
+      {
+        METRICS_LATENCY("pipeline");
+        armors = detector_.Detect(frame);
 
-        detector_.VisualizeResult(frame, 10);
+        if (armors.size() != 0) {
+          /* 先选出目标，只解算选中的装甲板 */
+          const std::size_t selected = selector_.Select(armors, frame.size());
+          /* 回放时同步建表，否则前几帧是否有表取决于建表线程的快慢 */
+          compensator_.SetBalletSpeed(robot_.GetBalletSpeed(),
+                                      replay_ != nullptr);
+          const std::size_t solved = compensator_.Apply(
+              armors, frame, robot_.GetEulerAt(cam_->GetFrameStamp()),
+              selected);
+          if (solved > 0) {
+            manager_.Aim(armors.front().GetAimEuler());
+            robot_.Pack(manager_.GetData(), 9999);
+          }
+        }
       }
-      cv::imshow("show", frame);
-      if (' ' == cv::waitKey(10)) {
-        cv::waitKey(0);
+      if (replay_ != nullptr) WriteCommand();
+
+      /* 绘制与显示在显示线程中进行，这里只提交快照 */
+      if (visualizer_.Wanted()) {
+        Visualizer::Snapshot snapshot;
+        snapshot.frame = frame;
+        snapshot.frame_id = cam_->frame_id_;
+        snapshot.bars = detector_.GetLightBars();
+        snapshot.armors = std::move(armors);
+        visualizer_.Post(std::move(snapshot));
       }
+      /* t 导出 trace */
+      if ('t' == visualizer_.TakeKey())
+        component::trace::Dump("logs/auto_aim.trace.json");
       recorder_.Record();
     }
+    if (replay_ != nullptr)
+      Report(frames, std::chrono::steady_clock::now() - start);
   }
 };
 
+/**
+ * @brief auto_aim [replay_path] [--realtime] [--baseline=file]
+ *
+ * 指定回放文件时不连接相机与串口，回放结束后输出帧率与各阶段耗时，
+ * 指令写入 logs/auto_aim.replay，可作为之后比对的基准。
+ */
 int main(int argc, char const* argv[]) {
-  (void)argc;
-  (void)argv;
+  std::string replay_path, baseline;
+  bool realtime = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const std::string baseline_flag = "--baseline=";
+    if (arg == "--realtime")
+      realtime = true;
+    else if (arg.compare(0, baseline_flag.size(), baseline_flag) == 0)
+      baseline = arg.substr(baseline_flag.size());
+    else
+      replay_path = arg;
+  }
 
-  AutoAim auto_aim("logs/auto_aim.log");
+  AutoAim auto_aim("logs/auto_aim.log", replay_path, realtime, baseline);
   auto_aim.Run();
 
-  return EXIT_SUCCESS;
+  return auto_aim.Matched() ? EXIT_SUCCESS : EXIT_FAILURE;
 }
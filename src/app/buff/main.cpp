@@ -36,6 +36,7 @@ class BuffAim : private App {
     detector_.SetTeam(robot_.GetEnemyTeam());
     predictor_.SetTime(robot_.GetTime());
     predictor_.SetRace(robot_.GetRace());
+    compensator_.SetArm(robot_.GetArm());
     // detector_.SetTeam(game::Team::kRED);
     // predictor_.SetRace(game::Race::kRMUC);
     // predictor_.SetTime(10);
@@ -62,8 +63,10 @@ class BuffAim : private App {
       if (buffs.size() > 0) {
         predictor_.SetBuff(buffs.back());
         auto armors = predictor_.Predict();
-        if (armors.size() != 0) {
-          compensator_.Apply(armors, frame, robot_.GetEuler());
+        compensator_.SetBalletSpeed(robot_.GetBalletSpeed());
+        if (armors.size() != 0 &&
+            compensator_.Apply(armors, frame,
+                               robot_.GetEulerAt(cam_.GetFrameStamp())) > 0) {
           manager_.Aim(armors.front().GetAimEuler());
           robot_.Pack(manager_.GetData(), 9999);
 
@@ -0,0 +1,79 @@
+#include "app.hpp"
+#include "filter_tuner.hpp"
+#include "opencv2/core/utility.hpp"
+#include "timer.hpp"
+
+namespace {
+
+const std::string kKEYS =
+    "{help h   |                   | print this message           }"
+    "{@log     |                   | per-frame measurement log    }"
+    "{@output  | filter_tuned.json | tuned params in JSON         }"
+    "{mode     | grid              | search mode: grid or random  }"
+    "{steps    | 40                | grid samples per dimension   }"
+    "{count    | 2000              | random configurations        }"
+    "{seed     | 0                 | random seed                  }"
+    "{q_low    | 1e-5              | lower bound of Q coefficient }"
+    "{q_high   | 10                | upper bound of Q coefficient }"
+    "{r_low    | 1e-3              | lower bound of R coefficient }"
+    "{r_high   | 1e3               | upper bound of R coefficient }";
+
+}  // namespace
+
+class FilterTunerApp : private App {
+ private:
+  cv::CommandLineParser parser_;
+  FilterTuner tuner_;
+  component::Timer duration_tune_;
+
+ public:
+  FilterTunerApp(const std::string& log_path, int argc, char const* argv[])
+      : App(log_path), parser_(argc, argv, kKEYS) {
+    parser_.about("Offline filter tuning over recorded measurements.");
+    SPDLOG_TRACE("Constructed.");
+  }
+
+  ~FilterTunerApp() { SPDLOG_TRACE("Destructed."); }
+
+  /* 运行的主程序 */
+  void Run() {
+    if (parser_.has("help") || !parser_.has("@log")) {
+      parser_.printMessage();
+      return;
+    }
+    if (!tuner_.LoadLog(parser_.get<std::string>("@log"))) return;
+
+    const cv::Vec2d q_range(parser_.get<double>("q_low"),
+                            parser_.get<double>("q_high"));
+    const cv::Vec2d r_range(parser_.get<double>("r_low"),
+                            parser_.get<double>("r_high"));
+    if (parser_.get<std::string>("mode") == "random")
+      tuner_.RandomSearch(q_range, r_range, parser_.get<int>("count"),
+                          parser_.get<int>("seed"));
+    else
+      tuner_.GridSearch(q_range, r_range, parser_.get<int>("steps"));
+
+    /* 滤波器每帧都会输出日志，调参期间只保留错误信息 */
+    auto level = spdlog::get_level();
+    spdlog::set_level(spdlog::level::err);
+    duration_tune_.Start();
+    const TunerResult& best = tuner_.Run();
+    spdlog::set_level(level);
+    duration_tune_.Calc("Tune");
+
+    SPDLOG_WARN("Evaluated {} configurations in {} ms.",
+                tuner_.GetResults().size(), duration_tune_.Count());
+    SPDLOG_WARN("Best {} Q : {}, R : {}, rmse : {}, max error : {}",
+                best.config.method == Method::kKF ? "KF" : "Baseline",
+                best.config.process_noise, best.config.measurement_noise,
+                best.rmse, best.max_error);
+    tuner_.SaveParams(parser_.get<std::string>("@output"));
+  }
+};
+
+int main(int argc, char const* argv[]) {
+  FilterTunerApp tuner("logs/filter_tuner.log", argc, argv);
+  tuner.Run();
+
+  return EXIT_SUCCESS;
+}
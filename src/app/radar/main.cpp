@@ -1,8 +1,17 @@
 #include "app.hpp"
 #include "armor_detector.hpp"
 #include "compensator.hpp"
+#include "debug_server.hpp"
 #include "hik_camera.hpp"
+#include "metrics.hpp"
 #include "robot.hpp"
+#include "visualizer.hpp"
+
+namespace {
+
+const std::size_t kFRAME_BYTES = 1440 * 1080 * 3; /* 相机的最大分辨率 */
+
+}  // namespace
 
 class Radar : private App {
  private:
@@ -11,12 +20,24 @@ class Radar : private App {
   ArmorDetector detector_;
   Compensator compensator_;
 
+  component::metrics::Exporter exporter_;
+  component::DebugServer server_;
+  Visualizer visualizer_;
+
  public:
-  Radar(const std::string& log_path) : App(log_path) {
+  Radar(const std::string& log_path)
+      : App(log_path),
+        exporter_("logs/radar.metrics", "/tmp/qdu_rm_ai.metrics"),
+        server_("127.0.0.1", 8080, &exporter_),
+        visualizer_("show", std::getenv("DISPLAY") == nullptr, 2, 10,
+                    &server_) {
     SPDLOG_WARN("***** Setting Up Auto Aiming System. *****");
 
-    /* 初始化设备 */
+    /* 初始化设备，采集的帧发布到帧总线，其他进程可用 BusCamera 读取 */
     robot_.Init("/dev/ttyTHS2");
+    cam_.Share(Camera::BusName(0), kFRAME_BYTES);
+    base_cam_.Share(Camera::BusName(1), kFRAME_BYTES);
+    outpost_cam_.Share(Camera::BusName(2), kFRAME_BYTES);
     cam_.Open(0);
     base_cam_.Open(1);
     outpost_cam_.Open(2);
@@ -51,10 +72,22 @@ class Radar : private App {
       // target = predictor.Predict(armors, frame);
       // compensator_.Apply(target, frame, robot_.GetRotMat());
       // robot_.Aim(target.GetAimEuler(), false);
-      detector_.VisualizeResult(frame, 10);
-      cv::imshow("show", frame);
-      if (' ' == cv::waitKey(10)) {
-        cv::waitKey(0);
+
+      /* 检测结果按帧号发布，坐标以 frame 的尺寸为准 */
+      if (auto bus = cam_.GetBus()) {
+        std::vector<cv::RotatedRect> rects;
+        for (const auto& armor : armors) rects.emplace_back(armor.GetRect());
+        bus->PublishDetections(cam_.frame_id_, frame.size(), rects);
+      }
+
+      /* 绘制与显示在显示线程中进行，无界面时可通过 DebugServer 查看 */
+      if (visualizer_.Wanted()) {
+        Visualizer::Snapshot snapshot;
+        snapshot.frame = frame;
+        snapshot.frame_id = cam_.frame_id_;
+        snapshot.bars = detector_.GetLightBars();
+        snapshot.armors = std::move(armors);
+        visualizer_.Post(std::move(snapshot));
       }
     }
   }
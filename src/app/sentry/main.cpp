@@ -2,8 +2,11 @@
 #include "armor_detector.hpp"
 #include "behavior.hpp"
 #include "compensator.hpp"
+#include "debug_server.hpp"
 #include "hik_camera.hpp"
+#include "metrics.hpp"
 #include "robot.hpp"
+#include "visualizer.hpp"
 
 class SentryAim : private App {
  private:
@@ -12,8 +15,17 @@ class SentryAim : private App {
   ArmorDetector detector_;
   Compensator compensator_;
 
+  component::metrics::Exporter exporter_;
+  component::DebugServer server_;
+  Visualizer visualizer_;
+
  public:
-  SentryAim(const std::string& log_path) : App(log_path) {
+  SentryAim(const std::string& log_path)
+      : App(log_path),
+        exporter_("logs/sentry.metrics", "/tmp/qdu_rm_ai.metrics"),
+        server_("127.0.0.1", 8080, &exporter_),
+        visualizer_("show", std::getenv("DISPLAY") == nullptr, 2, 10,
+                    &server_) {
     SPDLOG_WARN("***** Setting Up Auto Aiming System. *****");
 
     /* 初始化设备 */
@@ -47,10 +59,15 @@ class SentryAim : private App {
       // target = predictor.Predict(armors, frame);
       // compensator_.Apply(target, frame, robot_.GetRotMat());
       // robot_.Aim(target.GetAimEuler(), false);
-      detector_.VisualizeResult(frame, 10);
-      cv::imshow("show", frame);
-      if (' ' == cv::waitKey(10)) {
-        cv::waitKey(0);
+
+      /* 绘制与显示在显示线程中进行，无界面时可通过 DebugServer 查看 */
+      if (visualizer_.Wanted()) {
+        Visualizer::Snapshot snapshot;
+        snapshot.frame = frame;
+        snapshot.frame_id = cam_.frame_id_;
+        snapshot.bars = detector_.GetLightBars();
+        snapshot.armors = std::move(armors);
+        visualizer_.Post(std::move(snapshot));
       }
     }
   }
@@ -4,7 +4,8 @@
 
 #include "spdlog/spdlog.h"
 
-Behavior::Behavior() {
+/* 指令清零，未设置的字段与填充字节在每次运行中都相同 */
+Behavior::Behavior() : data_() {
   status_.low_hp = false;
   status_.bullet_empty = false;
   status_.under_attack = false;
@@ -13,7 +14,8 @@ Behavior::Behavior() {
 }
 
 Behavior::Behavior(const bool &low_hp, const bool &under_attack,
-                   const bool &bullet_empty) {
+                   const bool &bullet_empty)
+    : data_() {
   status_.low_hp = low_hp;
   status_.under_attack = under_attack;
   status_.bullet_empty = bullet_empty;
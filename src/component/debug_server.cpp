@@ -0,0 +1,251 @@
+#include "debug_server.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "opencv2/imgcodecs.hpp"
+#include "opencv2/imgproc.hpp"
+#include "spdlog/spdlog.h"
+#include "thread_policy.hpp"
+
+namespace component {
+
+namespace {
+
+const int kPOLL_TIMEOUT = 100;     /* ms，超时后检查线程是否需要退出 */
+const int kREQUEST_TIMEOUT = 1000; /* ms，等待请求行的时间 */
+const int kMAX_STREAMS = 4;
+const std::size_t kREQUEST_BUFF = 1024;
+const timeval kSEND_TIMEOUT = {1, 0};
+
+const char kINDEX[] =
+    "<html><head><title>qdu_rm_ai</title></head><body style=\"margin:0\">"
+    "<img src=\"/stream\" style=\"width:100%\"></body></html>";
+
+bool SendAll(int client, const char *data, std::size_t size) {
+  while (size > 0) {
+    const ssize_t sent = send(client, data, size, MSG_NOSIGNAL);
+    if (sent <= 0) return false;
+    data += sent;
+    size -= sent;
+  }
+  return true;
+}
+
+bool SendResponse(int client, const char *status, const char *type,
+                  const std::string &body) {
+  const std::string header = fmt::format(
+      "HTTP/1.0 {}\r\nContent-Type: {}\r\nContent-Length: {}\r\n"
+      "Cache-Control: no-cache\r\nConnection: close\r\n\r\n",
+      status, type, body.size());
+  return SendAll(client, header.data(), header.size()) &&
+         SendAll(client, body.data(), body.size());
+}
+
+/* 读到请求行即可，不解析头部 */
+std::string ReadPath(int client) {
+  std::string request;
+  char buff[kREQUEST_BUFF];
+  while (request.find("\r\n") == std::string::npos &&
+         request.size() < kREQUEST_BUFF) {
+    struct pollfd pfd = {client, POLLIN, 0};
+    if (poll(&pfd, 1, kREQUEST_TIMEOUT) <= 0) return "";
+    const ssize_t len = recv(client, buff, sizeof(buff), 0);
+    if (len <= 0) return "";
+    request.append(buff, len);
+  }
+  if (request.compare(0, 4, "GET ") != 0) return "";
+  const std::size_t end = request.find_first_of(" ?\r", 4);
+  return request.substr(4, end == std::string::npos ? end : end - 4);
+}
+
+}  // namespace
+
+void DebugServer::ThreadAccept() {
+  SPDLOG_DEBUG("[ThreadAccept] Started.");
+  thread_policy::Apply("ThreadAccept");
+  while (running_) {
+    struct pollfd pfd = {listen_, POLLIN, 0};
+    if (poll(&pfd, 1, kPOLL_TIMEOUT) <= 0) continue;
+    const int client = accept4(listen_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) continue;
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &kSEND_TIMEOUT,
+               sizeof(kSEND_TIMEOUT));
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++sessions_;
+    }
+    std::thread(&DebugServer::ThreadSession, this, client).detach();
+  }
+  SPDLOG_DEBUG("[ThreadAccept] Stoped.");
+}
+
+void DebugServer::ThreadEncode() {
+  SPDLOG_DEBUG("[ThreadEncode] Started.");
+  thread_policy::Apply("ThreadEncode");
+  auto &encode_latency = metrics::GetHistogram("stream.encode");
+  const std::vector<int> params = {cv::IMWRITE_JPEG_QUALITY, quality_};
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_) {
+    frame_condition_.wait(lock,
+                          [this] { return !pending_.empty() || !running_; });
+    if (!running_) break;
+    cv::Mat frame;
+    cv::swap(frame, pending_);
+    lock.unlock();
+
+    auto jpeg = std::make_shared<std::vector<uint8_t>>();
+    {
+      metrics::LatencyTimer timer(encode_latency);
+      if (frame.cols > max_width_) {
+        cv::resize(frame, frame,
+                   cv::Size(max_width_, frame.rows * max_width_ / frame.cols),
+                   0., 0., cv::INTER_AREA);
+      }
+      cv::imencode(".jpg", frame, *jpeg, params);
+    }
+
+    lock.lock();
+    jpeg_ = std::move(jpeg);
+    ++jpeg_seq_;
+    jpeg_condition_.notify_all();
+  }
+  SPDLOG_DEBUG("[ThreadEncode] Stoped.");
+}
+
+void DebugServer::Stream(int client) {
+  const char header[] =
+      "HTTP/1.0 200 OK\r\nCache-Control: no-cache\r\nConnection: close\r\n"
+      "Content-Type: multipart/x-mixed-replace; boundary=frame\r\n\r\n";
+  if (!SendAll(client, header, sizeof(header) - 1)) return;
+
+  ++streams_;
+  uint64_t seq = 0;
+  while (running_) {
+    std::shared_ptr<const std::vector<uint8_t>> jpeg;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!jpeg_condition_.wait_for(
+              lock, std::chrono::milliseconds(kPOLL_TIMEOUT),
+              [this, seq] { return jpeg_seq_ != seq || !running_; }))
+        continue;
+      if (!running_) break;
+      jpeg = jpeg_;
+      seq = jpeg_seq_;
+    }
+
+    /* 发送期间不持有锁，其间编码的帧会被跳过 */
+    const std::string part = fmt::format(
+        "--frame\r\nContent-Type: image/jpeg\r\nContent-Length: {}\r\n\r\n",
+        jpeg->size());
+    if (!SendAll(client, part.data(), part.size()) ||
+        !SendAll(client, reinterpret_cast<const char *>(jpeg->data()),
+                 jpeg->size()) ||
+        !SendAll(client, "\r\n", 2))
+      break;
+  }
+  --streams_;
+}
+
+void DebugServer::ThreadSession(int client) {
+  const std::string path = ReadPath(client);
+  SPDLOG_DEBUG("GET '{}'", path);
+  if (path == "/stream") {
+    if (streams_ < kMAX_STREAMS)
+      Stream(client);
+    else
+      SendResponse(client, "503 Service Unavailable", "text/plain",
+                   "Too many streams.\n");
+  } else if (path == "/metrics") {
+    SendResponse(client, "200 OK", "application/json",
+                 exporter_ ? exporter_->Last() : "{}");
+  } else if (path == "/") {
+    SendResponse(client, "200 OK", "text/html", kINDEX);
+  } else {
+    SendResponse(client, "404 Not Found", "text/plain", "Not found.\n");
+  }
+  close(client);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (--sessions_ == 0) jpeg_condition_.notify_all();
+}
+
+DebugServer::DebugServer(const std::string &address, int port,
+                         metrics::Exporter *exporter, double max_fps,
+                         int max_width, int quality)
+    : address_(address),
+      port_(-1),
+      period_(static_cast<int64_t>(1e6 / max_fps)),
+      max_width_(max_width),
+      quality_(quality),
+      exporter_(exporter),
+      listen_(socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0)),
+      running_(true),
+      streams_(0),
+      jpeg_(std::make_shared<std::vector<uint8_t>>()),
+      jpeg_seq_(0),
+      sessions_(0) {
+  const int reuse = 1;
+  setsockopt(listen_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  socklen_t len = sizeof(addr);
+  if (listen_ < 0 ||
+      inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1 ||
+      bind(listen_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+      listen(listen_, kMAX_STREAMS) != 0 ||
+      getsockname(listen_, reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+    SPDLOG_ERROR("Can't listen on {}:{}: {}", address, port,
+                 std::strerror(errno));
+    running_ = false;
+  } else {
+    port_ = ntohs(addr.sin_port);
+    thread_accept_ = std::thread(&DebugServer::ThreadAccept, this);
+    thread_encode_ = std::thread(&DebugServer::ThreadEncode, this);
+    SPDLOG_INFO("Debug stream on http://{}:{}/", address, port_);
+  }
+  SPDLOG_TRACE("Constructed.");
+}
+
+DebugServer::~DebugServer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  frame_condition_.notify_all();
+  jpeg_condition_.notify_all();
+  if (thread_accept_.joinable()) thread_accept_.join();
+  if (thread_encode_.joinable()) thread_encode_.join();
+
+  /* 客户端线程已分离，等待其全部退出 */
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    jpeg_condition_.wait(lock, [this] { return sessions_ == 0; });
+  }
+  if (listen_ >= 0) close(listen_);
+  SPDLOG_TRACE("Destructed.");
+}
+
+bool DebugServer::Post(const cv::Mat &frame) {
+  if (streams_ == 0 || frame.empty()) return false;
+  const auto now = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (now - last_post_ < period_) return false;
+    last_post_ = now;
+    pending_ = frame;
+  }
+  frame_condition_.notify_one();
+  return true;
+}
+
+}  // namespace component
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics.hpp"
+#include "opencv2/core/mat.hpp"
+
+namespace component {
+
+/**
+ * @brief 调试用的 HTTP 服务，以 MJPEG 推送标注后的画面并提供运行指标
+ *
+ * GET /stream 为 multipart/x-mixed-replace 的 MJPEG 流，GET /metrics 为
+ * Exporter 最近一次导出的 JSON，GET / 为嵌入画面的页面。默认只监听本机，
+ * 远程查看可用 ssh -L 8080:localhost:8080 转发，或绑定到机器人所在的网段。
+ *
+ * Post 只保存帧的句柄并唤醒编码线程，没有客户端或超过限定帧率时直接返回。
+ * 每个客户端由单独的线程发送最新编码的帧，慢的客户端只会跳帧。
+ */
+class DebugServer {
+ private:
+  std::string address_;
+  int port_;
+  std::chrono::microseconds period_;
+  int max_width_, quality_;
+  metrics::Exporter *exporter_;
+
+  int listen_;
+  std::atomic<bool> running_;
+  std::atomic<int> streams_;
+  std::thread thread_accept_, thread_encode_;
+
+  std::mutex mutex_;
+  std::condition_variable frame_condition_, jpeg_condition_;
+  cv::Mat pending_;
+  std::chrono::steady_clock::time_point last_post_;
+  std::shared_ptr<const std::vector<uint8_t>> jpeg_;
+  uint64_t jpeg_seq_;
+  int sessions_; /* 仍在运行的客户端线程 */
+
+  void ThreadAccept();
+  void ThreadEncode();
+  void ThreadSession(int client);
+  void Stream(int client);
+
+ public:
+  /**
+   * @brief Construct a new DebugServer object
+   *
+   * @param address 监听地址，0.0.0.0 为所有网卡
+   * @param port 端口，0 时由系统分配
+   * @param exporter 提供 /metrics 的导出器，可为空
+   * @param max_fps 推流的最大帧率
+   * @param max_width 推流的最大宽度，超过时等比缩小
+   * @param quality JPEG 质量
+   */
+  DebugServer(const std::string &address, int port,
+              metrics::Exporter *exporter = nullptr, double max_fps = 15.,
+              int max_width = 640, int quality = 70);
+
+  /**
+   * @brief Destroy the DebugServer object
+   *
+   */
+  ~DebugServer();
+
+  /* 实际监听的端口，监听失败时为 -1 */
+  int GetPort() const { return port_; }
+
+  /* 是否有客户端在看画面，没有时调用方可以不必绘制 */
+  bool Streaming() const { return streams_ > 0; }
+
+  /**
+   * @brief 提交标注后的帧，不等待编码
+   *
+   * @param frame 帧，提交后调用方不应再写入
+   * @return true 将被编码推送
+   * @return false 没有客户端或被限速丢弃
+   */
+  bool Post(const cv::Mat &frame);
+};
+
+}  // namespace component
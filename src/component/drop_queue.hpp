@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace component {
+
+/**
+ * @brief 有界队列，满时丢弃最旧的元素
+ *
+ * 生产方不会因消费方过慢而阻塞，适合把调试输出交给其他线程处理。
+ */
+template <typename T>
+class DropQueue {
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<T> queue_;
+  std::size_t capacity_;
+  std::size_t dropped_;
+  bool interrupted_;
+
+ public:
+  /**
+   * @brief Construct a new DropQueue object
+   *
+   * @param capacity 最多保存的元素数，至少为 1
+   */
+  explicit DropQueue(std::size_t capacity)
+      : capacity_(capacity > 0 ? capacity : 1),
+        dropped_(0),
+        interrupted_(false) {}
+
+  DropQueue(const DropQueue &) = delete;
+  DropQueue &operator=(const DropQueue &) = delete;
+
+  /**
+   * @brief 放入新元素，已满时丢弃最旧的一个
+   *
+   * @param value 新元素
+   * @return true 有元素被丢弃
+   * @return false 没有丢弃
+   */
+  bool Push(T &&value) {
+    bool dropped = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (queue_.size() >= capacity_) {
+        queue_.pop_front();
+        ++dropped_;
+        dropped = true;
+      }
+      queue_.push_back(std::move(value));
+    }
+    condition_.notify_one();
+    return dropped;
+  }
+
+  /**
+   * @brief 等待并取出最旧的元素
+   *
+   * @param value 取到的元素
+   * @param timeout_ms 超时时间(ms)
+   * @return true 取到元素
+   * @return false 超时或被 Interrupt 唤醒
+   */
+  bool Pop(T &value, int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!condition_.wait_for(
+            lock, std::chrono::milliseconds(timeout_ms),
+            [this] { return !queue_.empty() || interrupted_; }))
+      return false;
+    if (interrupted_) {
+      interrupted_ = false;
+      return false;
+    }
+    value = std::move(queue_.front());
+    queue_.pop_front();
+    return true;
+  }
+
+  std::size_t Size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+  }
+
+  /* 累计丢弃的元素数 */
+  std::size_t Dropped() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+  }
+
+  /**
+   * @brief 唤醒等待方，用于退出
+   *
+   */
+  void Interrupt() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      interrupted_ = true;
+    }
+    condition_.notify_all();
+  }
+};
+
+}  // namespace component
@@ -0,0 +1,341 @@
+#include "frame_bus.hpp"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <new>
+
+#include "spdlog/spdlog.h"
+
+namespace component {
+
+namespace {
+
+const uint64_t kMAGIC = 0x5355424d415246; /* "FRAMBUS" */
+const uint32_t kVERSION = 1;
+const std::size_t kALIGN = 64;
+const std::size_t kPAGE = 4096;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "Atomics in shared memory must be lock free.");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "Futex word must be 32 bits.");
+
+std::size_t Align(std::size_t size, std::size_t align) {
+  return (size + align - 1) / align * align;
+}
+
+/* 进程间共享的 futex，不能使用 FUTEX_PRIVATE_FLAG */
+void FutexWake(std::atomic<uint32_t> &word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+}
+
+void FutexWait(std::atomic<uint32_t> &word, uint32_t value,
+               std::chrono::nanoseconds timeout) {
+  const auto secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+  const timespec ts = {secs.count(), (timeout - secs).count()};
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, value,
+          &ts, nullptr, 0);
+}
+
+}  // namespace
+
+/* 头部之后依次为帧槽、检测结果槽与帧数据，各部分按页对齐 */
+struct FrameBus::Header {
+  std::atomic<uint64_t> magic; /* 初始化完成后才写入 */
+  uint32_t version;
+  uint32_t slots;
+  uint64_t frame_bytes, detection_bytes;
+  uint64_t slot_offset, detection_offset, detection_stride;
+  uint64_t data_offset, data_stride;
+
+  alignas(kALIGN) std::atomic<uint64_t> head; /* 最新发布的序号，从 1 开始 */
+  std::atomic<uint32_t> futex; /* 每次发布加一，读者在其上等待 */
+  std::atomic<uint32_t> waiters;
+  std::atomic<uint32_t> closed;
+};
+
+/* 写入期间 seq 为 0，读者前后两次读到相同的 seq 才认为数据完整 */
+struct FrameBus::Slot {
+  alignas(kALIGN) std::atomic<uint64_t> seq;
+  std::atomic<int64_t> stamp;
+  std::atomic<uint64_t> frame_id;
+  std::atomic<int32_t> rows, cols, type;
+};
+
+/* 以帧号作为序号，数据紧随其后 */
+struct FrameBus::DetectionSlot {
+  alignas(kALIGN) std::atomic<uint64_t> frame_id;
+  std::atomic<int32_t> width, height;
+  std::atomic<uint64_t> bytes;
+};
+
+FrameBus::FrameBus() : base_(nullptr), size_(0), header_(nullptr) {}
+
+FrameBus::~FrameBus() {
+  Unmap();
+  SPDLOG_TRACE("Destructed.");
+}
+
+void FrameBus::Unmap() {
+  if (base_ != nullptr) munmap(base_, size_);
+  base_ = nullptr;
+  size_ = 0;
+  header_ = nullptr;
+}
+
+FrameBus::Slot &FrameBus::GetSlot(uint64_t seq) const {
+  return reinterpret_cast<Slot *>(base_ +
+                                  header_->slot_offset)[seq % header_->slots];
+}
+
+uint8_t *FrameBus::GetData(uint64_t seq) const {
+  return base_ + header_->data_offset +
+         seq % header_->slots * header_->data_stride;
+}
+
+FrameBus::DetectionSlot &FrameBus::GetDetection(uint64_t frame_id) const {
+  return *reinterpret_cast<DetectionSlot *>(
+      base_ + header_->detection_offset +
+      frame_id % header_->slots * header_->detection_stride);
+}
+
+bool FrameBus::PublishDetections(uint64_t frame_id, const cv::Size &size,
+                                 const void *data, std::size_t bytes) {
+  if (!Ok() || frame_id == 0 || bytes > header_->detection_bytes) {
+    SPDLOG_ERROR("Can't publish {} bytes of detections to '{}'.", bytes,
+                 name_);
+    return false;
+  }
+  auto &slot = GetDetection(frame_id);
+  slot.frame_id.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.width.store(size.width, std::memory_order_relaxed);
+  slot.height.store(size.height, std::memory_order_relaxed);
+  slot.bytes.store(bytes, std::memory_order_relaxed);
+  if (bytes > 0)
+    std::memcpy(reinterpret_cast<uint8_t *>(&slot) + sizeof(DetectionSlot),
+                data, bytes);
+  slot.frame_id.store(frame_id, std::memory_order_release);
+  return true;
+}
+
+bool FrameBus::ReadDetections(uint64_t frame_id, cv::Size &size,
+                              std::vector<uint8_t> &data) const {
+  if (!Ok() || frame_id == 0) return false;
+  const auto &slot = GetDetection(frame_id);
+  if (slot.frame_id.load(std::memory_order_acquire) != frame_id) return false;
+
+  const std::size_t bytes = slot.bytes.load(std::memory_order_relaxed);
+  if (bytes > header_->detection_bytes) return false;
+  data.resize(bytes);
+  if (bytes > 0)
+    std::memcpy(data.data(),
+                reinterpret_cast<const uint8_t *>(&slot) +
+                    sizeof(DetectionSlot),
+                bytes);
+  size = cv::Size(slot.width.load(std::memory_order_relaxed),
+                  slot.height.load(std::memory_order_relaxed));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.frame_id.load(std::memory_order_relaxed) == frame_id;
+}
+
+FrameWriter::FrameWriter(const std::string &name, std::size_t frame_bytes,
+                         std::size_t slots, std::size_t detection_bytes)
+    : seq_(0) {
+  name_ = name;
+  const std::size_t slot_offset = Align(sizeof(Header), kPAGE);
+  const std::size_t detection_offset =
+      slot_offset + Align(slots * sizeof(Slot), kPAGE);
+  const std::size_t detection_stride =
+      Align(sizeof(DetectionSlot) + detection_bytes, kALIGN);
+  const std::size_t data_offset =
+      detection_offset + Align(slots * detection_stride, kPAGE);
+  const std::size_t data_stride = Align(frame_bytes, kPAGE);
+  const std::size_t size = data_offset + slots * data_stride;
+
+  /* 删除上次异常退出时遗留的共享内存，已打开的读者仍持有旧的映射 */
+  shm_unlink(name.c_str());
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+  void *base = MAP_FAILED;
+  if (fd >= 0 && ftruncate(fd, size) == 0)
+    base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (fd >= 0) close(fd);
+  if (slots == 0 || base == MAP_FAILED) {
+    SPDLOG_ERROR("Can't create frame bus '{}' of {} bytes: {}", name, size,
+                 std::strerror(errno));
+    if (base != MAP_FAILED) munmap(base, size);
+    return;
+  }
+
+  base_ = static_cast<uint8_t *>(base);
+  size_ = size;
+  header_ = new (base_) Header();
+  header_->version = kVERSION;
+  header_->slots = slots;
+  header_->frame_bytes = frame_bytes;
+  header_->detection_bytes = detection_bytes;
+  header_->slot_offset = slot_offset;
+  header_->detection_offset = detection_offset;
+  header_->detection_stride = detection_stride;
+  header_->data_offset = data_offset;
+  header_->data_stride = data_stride;
+  header_->head.store(0);
+  header_->futex.store(0);
+  header_->waiters.store(0);
+  header_->closed.store(0);
+  for (std::size_t i = 0; i < slots; ++i) {
+    new (&GetSlot(i)) Slot();
+    GetSlot(i).seq.store(0);
+    new (&GetDetection(i)) DetectionSlot();
+    GetDetection(i).frame_id.store(0);
+  }
+  header_->magic.store(kMAGIC, std::memory_order_release);
+  SPDLOG_INFO("Frame bus '{}': {} slots of {} bytes.", name, slots,
+              frame_bytes);
+  SPDLOG_TRACE("Constructed.");
+}
+
+FrameWriter::~FrameWriter() {
+  if (Ok()) {
+    header_->closed.store(1);
+    header_->futex.fetch_add(1);
+    FutexWake(header_->futex);
+    Unmap();
+    shm_unlink(name_.c_str());
+  }
+}
+
+uint64_t FrameWriter::Publish(const cv::Mat &frame,
+                              std::chrono::steady_clock::time_point stamp,
+                              uint64_t frame_id) {
+  const std::size_t bytes = frame.total() * frame.elemSize();
+  if (!Ok() || frame.empty() || !frame.isContinuous() ||
+      bytes > header_->frame_bytes) {
+    SPDLOG_ERROR("Can't publish frame of {} bytes to '{}'.", bytes, name_);
+    return 0;
+  }
+
+  const uint64_t seq = ++seq_;
+  auto &slot = GetSlot(seq);
+  slot.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.stamp.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       stamp.time_since_epoch())
+                       .count(),
+                   std::memory_order_relaxed);
+  slot.frame_id.store(frame_id, std::memory_order_relaxed);
+  slot.rows.store(frame.rows, std::memory_order_relaxed);
+  slot.cols.store(frame.cols, std::memory_order_relaxed);
+  slot.type.store(frame.type(), std::memory_order_relaxed);
+  std::memcpy(GetData(seq), frame.data, bytes);
+  slot.seq.store(seq, std::memory_order_release);
+  header_->head.store(seq, std::memory_order_release);
+
+  /* 只有读者在等待时才进入内核 */
+  header_->futex.fetch_add(1);
+  if (header_->waiters.load() > 0) FutexWake(header_->futex);
+  return seq;
+}
+
+FrameReader::FrameReader() : next_(1), dropped_(0) {
+  SPDLOG_TRACE("Constructed.");
+}
+
+bool FrameReader::Open(const std::string &name) {
+  Unmap();
+  name_ = name;
+  const int fd = shm_open(name.c_str(), O_RDWR, 0);
+  struct stat st = {};
+  void *base = MAP_FAILED;
+  if (fd >= 0 && fstat(fd, &st) == 0 &&
+      static_cast<std::size_t>(st.st_size) >= sizeof(Header))
+    base = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                0);
+  if (fd >= 0) close(fd);
+  if (base == MAP_FAILED) {
+    SPDLOG_ERROR("Can't open frame bus '{}': {}", name, std::strerror(errno));
+    return false;
+  }
+
+  base_ = static_cast<uint8_t *>(base);
+  size_ = st.st_size;
+  header_ = static_cast<Header *>(base);
+  if (header_->magic.load(std::memory_order_acquire) != kMAGIC ||
+      header_->version != kVERSION || header_->slots == 0 ||
+      header_->data_offset + header_->slots * header_->data_stride > size_) {
+    SPDLOG_ERROR("Frame bus '{}' is not ready or incompatible.", name);
+    Unmap();
+    return false;
+  }
+  next_ = header_->head.load(std::memory_order_acquire) + 1;
+  dropped_ = 0;
+  return true;
+}
+
+bool FrameReader::Wait(View &view, int timeout_ms, bool latest) {
+  if (!Ok()) return false;
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_ms);
+  while (true) {
+    const uint64_t head = header_->head.load(std::memory_order_acquire);
+    if (head >= next_) {
+      /* 落后超过一圈的帧已被覆盖，直接跳到最新 */
+      const uint64_t seq =
+          (latest || head - next_ >= header_->slots) ? head : next_;
+      const auto &slot = GetSlot(seq);
+      if (slot.seq.load(std::memory_order_acquire) != seq) continue;
+
+      view.stamp = std::chrono::steady_clock::time_point(
+          std::chrono::nanoseconds(slot.stamp.load(std::memory_order_relaxed)));
+      view.frame_id = slot.frame_id.load(std::memory_order_relaxed);
+      view.image = cv::Mat(slot.rows.load(std::memory_order_relaxed),
+                           slot.cols.load(std::memory_order_relaxed),
+                           slot.type.load(std::memory_order_relaxed),
+                           GetData(seq));
+      view.seq = seq;
+      if (!Valid(view)) continue;
+
+      dropped_ += seq - next_;
+      next_ = seq + 1;
+      return true;
+    }
+
+    if (Closed()) return false;
+    const auto remain = deadline - std::chrono::steady_clock::now();
+    if (remain <= std::chrono::steady_clock::duration::zero()) return false;
+
+    /* 先登记再检查，写者看不到登记时必然已改变 futex 的值 */
+    header_->waiters.fetch_add(1);
+    const uint32_t futex = header_->futex.load();
+    if (header_->head.load() < next_ && !Closed())
+      FutexWait(header_->futex, futex, remain);
+    header_->waiters.fetch_sub(1);
+  }
+}
+
+bool FrameReader::Valid(const View &view) const {
+  if (!Ok()) return false;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return GetSlot(view.seq).seq.load(std::memory_order_relaxed) == view.seq;
+}
+
+bool FrameReader::Copy(const View &view, cv::Mat &image) const {
+  image = view.image.clone();
+  return Valid(view);
+}
+
+bool FrameReader::Closed() const {
+  return Ok() && header_->closed.load() != 0;
+}
+
+}  // namespace component
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "opencv2/core/mat.hpp"
+
+namespace component {
+
+/**
+ * @brief 进程间共享的帧总线，基于 POSIX 共享内存的环形帧槽
+ *
+ * 一个写者按序号发布帧，帧槽数固定，写者从不等待读者。读者各自记录下一个
+ * 要读的序号，落后超过一圈时直接跳到最新帧并计入丢帧。读者得到的图像直接
+ * 指向共享内存，使用完后用 Valid 确认期间没有被覆盖，或用 Copy 取得副本。
+ *
+ * 同一块共享内存中另有按帧号索引的检测结果旁路，单个写者，内容为平凡可复
+ * 制类型的数组，与帧槽一样不阻塞写者。
+ */
+class FrameBus {
+ public:
+  /* 共享内存中的结构，定义在源文件中 */
+  struct Header;
+  struct Slot;
+  struct DetectionSlot;
+
+ protected:
+  std::string name_;
+  uint8_t *base_;
+  std::size_t size_;
+  Header *header_;
+
+  Slot &GetSlot(uint64_t seq) const;
+  uint8_t *GetData(uint64_t seq) const;
+  DetectionSlot &GetDetection(uint64_t frame_id) const;
+
+  FrameBus();
+  void Unmap();
+
+ public:
+  FrameBus(const FrameBus &) = delete;
+  FrameBus &operator=(const FrameBus &) = delete;
+  virtual ~FrameBus();
+
+  /* 共享内存是否已映射 */
+  bool Ok() const { return header_ != nullptr; }
+
+  /**
+   * @brief 发布某一帧的检测结果，同一时刻只能有一个写者
+   *
+   * @param frame_id 帧号，大于 0
+   * @param size 检测所用图像的尺寸，坐标以此为准
+   * @param data 数据
+   * @param bytes 字节数，不超过创建时的容量
+   * @return true 发布成功
+   * @return false 未映射或超出容量
+   */
+  bool PublishDetections(uint64_t frame_id, const cv::Size &size,
+                         const void *data, std::size_t bytes);
+
+  /**
+   * @brief 读取某一帧的检测结果
+   *
+   * @param frame_id 帧号
+   * @param size 检测所用图像的尺寸
+   * @param data 数据，可能为空
+   * @return true 读到该帧的结果
+   * @return false 尚未发布、已被覆盖或读写重叠
+   */
+  bool ReadDetections(uint64_t frame_id, cv::Size &size,
+                      std::vector<uint8_t> &data) const;
+
+  template <typename T>
+  bool PublishDetections(uint64_t frame_id, const cv::Size &size,
+                         const std::vector<T> &items) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Detections must be trivially copyable.");
+    return PublishDetections(frame_id, size, items.data(),
+                             items.size() * sizeof(T));
+  }
+
+  template <typename T>
+  bool ReadDetections(uint64_t frame_id, cv::Size &size,
+                      std::vector<T> &items) const;
+};
+
+/**
+ * @brief 帧总线的写者，创建并独占共享内存
+ */
+class FrameWriter : public FrameBus {
+ private:
+  uint64_t seq_;
+
+ public:
+  /**
+   * @brief Construct a new FrameWriter object
+   *
+   * @param name 共享内存名，以 / 开头，如 /qdu_rm_ai.cam0
+   * @param frame_bytes 单帧的最大字节数
+   * @param slots 帧槽数
+   * @param detection_bytes 单帧检测结果的最大字节数
+   */
+  FrameWriter(const std::string &name, std::size_t frame_bytes,
+              std::size_t slots = 4, std::size_t detection_bytes = 4096);
+
+  /**
+   * @brief Destroy the FrameWriter object，通知读者并删除共享内存
+   *
+   */
+  ~FrameWriter();
+
+  /**
+   * @brief 复制一帧到下一个帧槽并发布，不等待读者
+   *
+   * @param frame 连续存储的图像
+   * @param stamp 采集时刻
+   * @param frame_id 帧号
+   * @return uint64_t 发布的序号，失败时为 0
+   */
+  uint64_t Publish(const cv::Mat &frame,
+                   std::chrono::steady_clock::time_point stamp,
+                   uint64_t frame_id);
+};
+
+/**
+ * @brief 帧总线的读者，可在任意进程中打开
+ */
+class FrameReader : public FrameBus {
+ public:
+  /* 一帧的视图，image 指向共享内存 */
+  struct View {
+    cv::Mat image;
+    std::chrono::steady_clock::time_point stamp;
+    uint64_t frame_id;
+    uint64_t seq;
+  };
+
+ private:
+  uint64_t next_;
+  uint64_t dropped_;
+
+ public:
+  FrameReader();
+
+  /**
+   * @brief 打开写者创建的共享内存，从其最新的帧开始读
+   *
+   * @param name 共享内存名
+   * @return true 打开成功
+   * @return false 不存在或格式不符
+   */
+  bool Open(const std::string &name);
+
+  /**
+   * @brief 等待下一帧
+   *
+   * @param view 帧的视图
+   * @param timeout_ms 超时时间
+   * @param latest 为 true 时跳过积压的帧，只取最新的
+   * @return true 得到一帧
+   * @return false 超时、未打开或写者已关闭
+   */
+  bool Wait(View &view, int timeout_ms, bool latest = false);
+
+  /**
+   * @brief 视图中的数据是否仍未被覆盖，在用完 image 之后调用
+   *
+   * @param view 帧的视图
+   * @return true 期间未被覆盖，读到的数据完整
+   * @return false 已被写者覆盖
+   */
+  bool Valid(const View &view) const;
+
+  /**
+   * @brief 复制视图中的图像
+   *
+   * @param view 帧的视图
+   * @param image 副本
+   * @return true 复制完成前未被覆盖
+   * @return false 已被覆盖，副本不可用
+   */
+  bool Copy(const View &view, cv::Mat &image) const;
+
+  /* 写者是否已关闭，关闭后需要重新 Open */
+  bool Closed() const;
+
+  /* 因落后被跳过的帧数 */
+  uint64_t Dropped() const { return dropped_; }
+};
+
+template <typename T>
+bool FrameBus::ReadDetections(uint64_t frame_id, cv::Size &size,
+                              std::vector<T> &items) const {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Detections must be trivially copyable.");
+  std::vector<uint8_t> buff;
+  if (!ReadDetections(frame_id, size, buff) || buff.size() % sizeof(T) != 0)
+    return false;
+  items.resize(buff.size() / sizeof(T));
+  if (!buff.empty()) std::memcpy(items.data(), buff.data(), buff.size());
+  return true;
+}
+
+}  // namespace component
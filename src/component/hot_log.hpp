@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+#include "spdlog/spdlog.h"
+
+namespace component {
+
+/**
+ * @brief 热路径日志，用于每帧、每个目标都会执行到的位置
+ *
+ * 宏的第一个参数为 SPDLOG_* 宏，仍受 SPDLOG_ACTIVE_LEVEL 的编译期过滤；
+ * 定义 DISABLE_HOT_LOG 时整体编译为空，参数也不会被求值。
+ */
+namespace hot_log {
+
+/* 每处调用各自的上次输出时刻，初值保证第一次一定输出 */
+constexpr int64_t kNEVER = std::numeric_limits<int64_t>::min() / 2;
+
+/**
+ * @brief 距上次输出超过周期时返回 true，多线程同时到达时只有一个成功
+ *
+ * @param last 上次输出的时刻(ms)
+ * @param period_ms 周期(ms)
+ */
+inline bool Throttle(std::atomic<int64_t> &last, int64_t period_ms) {
+  const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count();
+  int64_t prev = last.load(std::memory_order_relaxed);
+  if (now - prev < period_ms) return false;
+  return last.compare_exchange_strong(prev, now, std::memory_order_relaxed);
+}
+
+/**
+ * @brief 每 n 次返回一次 true，第一次一定为 true
+ *
+ * @param count 调用计数
+ * @param n 采样间隔
+ */
+inline bool Sample(std::atomic<uint64_t> &count, uint64_t n) {
+  return count.fetch_add(1, std::memory_order_relaxed) % n == 0;
+}
+
+}  // namespace hot_log
+
+}  // namespace component
+
+#ifdef DISABLE_HOT_LOG
+
+#define HOT_LOG(LOG, ...) (void)0
+#define HOT_LOG_EVERY_N(LOG, n, ...) (void)0
+#define HOT_LOG_EVERY_MS(LOG, ms, ...) (void)0
+
+#else
+
+/* 不限频，只随 DISABLE_HOT_LOG 一起去掉 */
+#define HOT_LOG(LOG, ...) LOG(__VA_ARGS__)
+
+/* 每处调用每 n 次输出一次，用于逐个轮廓、逐个目标的细节 */
+#define HOT_LOG_EVERY_N(LOG, n, ...)                           \
+  do {                                                         \
+    static std::atomic<uint64_t> hot_log_count(0);             \
+    if (component::hot_log::Sample(hot_log_count, (n))) {      \
+      LOG(__VA_ARGS__);                                        \
+    }                                                          \
+  } while (0)
+
+/* 每处调用每 ms 毫秒最多输出一次，用于持续出现的异常 */
+#define HOT_LOG_EVERY_MS(LOG, ms, ...)                         \
+  do {                                                         \
+    static std::atomic<int64_t> hot_log_last(                  \
+        component::hot_log::kNEVER);                           \
+    if (component::hot_log::Throttle(hot_log_last, (ms))) {    \
+      LOG(__VA_ARGS__);                                        \
+    }                                                          \
+  } while (0)
+
+#endif
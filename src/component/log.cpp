@@ -1,9 +1,36 @@
 #include "log.hpp"
 
+#include "spdlog/async.h"
+
 namespace component {
 
 namespace Logger {
 
+namespace {
+
+/* 队列预先分配，写满时覆盖最旧的日志，热路径上不会阻塞 */
+const std::size_t kQUEUE_SIZE = 8192;
+const std::chrono::seconds kFLUSH_PERIOD(1);
+
+void SetAsyncLogger(spdlog::sinks_init_list sinks) {
+  if (!spdlog::thread_pool()) spdlog::init_thread_pool(kQUEUE_SIZE, 1);
+  spdlog::set_default_logger(std::make_shared<spdlog::async_logger>(
+      "default", sinks, spdlog::thread_pool(),
+      spdlog::async_overflow_policy::overrun_oldest));
+
+  /* 由后台线程定期刷盘，只有错误立即刷 */
+  spdlog::flush_on(spdlog::level::err);
+  spdlog::flush_every(kFLUSH_PERIOD);
+
+#if (SPDLOG_ACTIVE_LEVEL == SPDLOG_LEVEL_DEBUG)
+  spdlog::set_level(spdlog::level::debug);
+#elif (SPDLOG_ACTIVE_LEVEL == SPDLOG_LEVEL_INFO)
+  spdlog::set_level(spdlog::level::info);
+#endif
+}
+
+}  // namespace
+
 const std::string fmt_default("%+");
 const std::string fmt_filelogger("[%Y-%m-%d %T.%3!u] %^[%l] [%!]%$ [%s:%#] %v");
 const std::string fmt_funcname(
@@ -32,17 +59,7 @@ void SetLogger(spdlog::level::level_enum level, FMT fmt,
     auto file_sink =
         std::make_shared<spdlog::sinks::basic_file_sink_mt>(path, true);
     file_sink->set_pattern(fmt_default);
-    spdlog::set_default_logger(std::make_shared<spdlog::logger>(
-        "default", spdlog::sinks_init_list{console_sink, file_sink}));
-
-#if (SPDLOG_ACTIVE_LEVEL == SPDLOG_LEVEL_DEBUG)
-    spdlog::flush_on(spdlog::level::debug);
-    spdlog::set_level(spdlog::level::debug);
-#elif (SPDLOG_ACTIVE_LEVEL == SPDLOG_LEVEL_INFO)
-    spdlog::flush_on(spdlog::level::info);
-    spdlog::set_level(spdlog::level::info);
-#endif
-
+    SetAsyncLogger({console_sink, file_sink});
   } else {
     spdlog::set_pattern(fmt_str);
     spdlog::set_level(level);
@@ -56,16 +73,7 @@ void SetLogger(const std::string& path, FMT fmt) {
   auto file_sink =
       std::make_shared<spdlog::sinks::basic_file_sink_mt>(path, true);
   file_sink->set_pattern(fmt_default);
-  spdlog::set_default_logger(std::make_shared<spdlog::logger>(
-      "default", spdlog::sinks_init_list{console_sink, file_sink}));
-
-#if (SPDLOG_ACTIVE_LEVEL == SPDLOG_LEVEL_DEBUG)
-  spdlog::flush_on(spdlog::level::debug);
-  spdlog::set_level(spdlog::level::debug);
-#elif (SPDLOG_ACTIVE_LEVEL == SPDLOG_LEVEL_INFO)
-  spdlog::flush_on(spdlog::level::info);
-  spdlog::set_level(spdlog::level::info);
-#endif
+  SetAsyncLogger({console_sink, file_sink});
   SPDLOG_DEBUG("Logging setted.");
 }
 
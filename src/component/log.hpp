@@ -12,6 +12,12 @@ namespace Logger {
 
 enum class FMT { kFMT_DEFAULT, kFMT_FILE, kFMT_TEST };
 
+/**
+ * @brief 设置默认日志器
+ *
+ * 写文件时为异步日志器：调用方只格式化并入队，由后台线程写入，每秒刷盘一次，
+ * 错误级别立即刷盘。队列写满时丢弃最旧的日志。
+ */
 void SetLogger(
     spdlog::level::level_enum level = spdlog::level::level_enum::debug,
     FMT fmt = FMT::kFMT_TEST, const std::string& path = "log/log.log");
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace component {
+
+/**
+ * @brief 只保存最新值的单槽信箱
+ *
+ * 投递方覆盖旧值并通过 eventfd 唤醒等待方，等待方在没有新值时阻塞在 poll
+ * 上，不占用 CPU。
+ */
+template <typename T>
+class Mailbox {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+ private:
+  std::mutex mutex_;
+  T value_;
+  Clock::time_point stamp_;
+  bool full_;
+  std::atomic<bool> interrupted_;
+  int event_;
+
+  void Signal() {
+    const uint64_t one = 1;
+    if (write(event_, &one, sizeof(one)) < 0) return;
+  }
+
+ public:
+  Mailbox()
+      : full_(false),
+        interrupted_(false),
+        event_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {}
+  ~Mailbox() { close(event_); }
+
+  Mailbox(const Mailbox &) = delete;
+  Mailbox &operator=(const Mailbox &) = delete;
+
+  /**
+   * @brief 投递新值，未取走的旧值被覆盖
+   *
+   * @param value 新值
+   */
+  void Post(const T &value) {
+    bool was_full;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      value_ = value;
+      stamp_ = Clock::now();
+      was_full = full_;
+      full_ = true;
+    }
+    if (!was_full) Signal();
+  }
+
+  /**
+   * @brief 不等待，取走当前值
+   *
+   * @param value 取到的值
+   * @param stamp 该值的投递时刻
+   * @return true 取到新值
+   * @return false 信箱为空
+   */
+  bool TryTake(T &value, Clock::time_point *stamp = nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!full_) return false;
+    value = value_;
+    if (stamp) *stamp = stamp_;
+    full_ = false;
+    return true;
+  }
+
+  /**
+   * @brief 等待并取走新值
+   *
+   * @param value 取到的值
+   * @param timeout_ms 超时时间，-1 为一直等待
+   * @param stamp 该值的投递时刻
+   * @return true 取到新值
+   * @return false 超时或被 Interrupt 唤醒
+   */
+  bool Wait(T &value, int timeout_ms, Clock::time_point *stamp = nullptr) {
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!TryTake(value, stamp)) {
+      /* 可能被已经取走的值唤醒，此时继续等待 */
+      int wait_ms = timeout_ms;
+      if (timeout_ms >= 0) {
+        wait_ms = std::chrono::ceil<std::chrono::milliseconds>(deadline -
+                                                               Clock::now())
+                      .count();
+        if (wait_ms < 0) return false;
+      }
+      struct pollfd pfd = {event_, POLLIN, 0};
+      if (poll(&pfd, 1, wait_ms) <= 0) return false;
+
+      uint64_t count;
+      if (read(event_, &count, sizeof(count)) < 0) continue;
+      if (interrupted_.exchange(false)) return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief 唤醒等待方，用于退出
+   *
+   */
+  void Interrupt() {
+    interrupted_ = true;
+    Signal();
+  }
+};
+
+}  // namespace component
@@ -0,0 +1,238 @@
+#include "metrics.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#include "spdlog/spdlog.h"
+#include "thread_policy.hpp"
+
+namespace component {
+
+namespace metrics {
+
+namespace {
+
+template <typename T>
+using Table = std::map<std::string, std::unique_ptr<T>>;
+
+std::mutex mutex_registry;
+Table<Counter> counters;
+Table<Gauge> gauges;
+Table<Histogram> histograms;
+
+std::atomic<std::size_t> next_shard(0);
+thread_local const std::size_t local_shard =
+    next_shard.fetch_add(1) % Histogram::kSHARDS;
+
+template <typename T>
+T &GetOrCreate(Table<T> &table, const std::string &name) {
+  std::lock_guard<std::mutex> lock(mutex_registry);
+  auto &entry = table[name];
+  if (!entry) entry = std::make_unique<T>();
+  return *entry;
+}
+
+void AtomicMax(std::atomic<uint64_t> &target, uint64_t value) {
+  uint64_t current = target.load(std::memory_order_relaxed);
+  while (current < value &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed))
+    ;
+}
+
+}  // namespace
+
+Histogram::Histogram() {
+  for (auto &shard : shards_) {
+    for (auto &bucket : shard.buckets) bucket.store(0);
+    shard.count = shard.sum = shard.max = 0;
+  }
+}
+
+std::size_t Histogram::BucketOf(uint64_t value) {
+  if (value < kSUB) return value;
+  const int exp = 63 - __builtin_clzll(value);
+  const std::size_t sub = (value >> (exp - kSUB_BITS)) & (kSUB - 1);
+  return (exp - kSUB_BITS + 1) * kSUB + sub;
+}
+
+uint64_t Histogram::LowerBound(std::size_t bucket) {
+  if (bucket < kSUB) return bucket;
+  const int exp = bucket / kSUB + kSUB_BITS - 1;
+  return (kSUB + bucket % kSUB) << (exp - kSUB_BITS);
+}
+
+void Histogram::Record(uint64_t ns) {
+  Shard &shard = shards_[local_shard];
+  shard.buckets[BucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+  shard.count.fetch_add(1, std::memory_order_relaxed);
+  shard.sum.fetch_add(ns, std::memory_order_relaxed);
+  AtomicMax(shard.max, ns);
+}
+
+void Histogram::Record(std::chrono::nanoseconds duration) {
+  Record(static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)));
+}
+
+Histogram::Summary Histogram::Collect() {
+  std::array<uint64_t, kBUCKETS> buckets = {};
+  Summary summary = {0, 0., 0., 0., 0., 0.};
+  uint64_t sum = 0, max = 0;
+
+  /* 逐项取出并清零，汇总期间的记录会计入下一次 */
+  for (auto &shard : shards_) {
+    for (std::size_t i = 0; i < kBUCKETS; ++i)
+      buckets[i] += shard.buckets[i].exchange(0, std::memory_order_relaxed);
+    summary.count += shard.count.exchange(0, std::memory_order_relaxed);
+    sum += shard.sum.exchange(0, std::memory_order_relaxed);
+    max = std::max(max, shard.max.exchange(0, std::memory_order_relaxed));
+  }
+  if (summary.count == 0) return summary;
+
+  summary.mean = static_cast<double>(sum) / summary.count;
+  summary.max = max;
+
+  /* 取所在桶的中点，不超过最大值 */
+  const double ranks[] = {0.5, 0.9, 0.99};
+  double *values[] = {&summary.p50, &summary.p90, &summary.p99};
+  uint64_t seen = 0;
+  std::size_t next = 0;
+  for (std::size_t i = 0; i < kBUCKETS && next < 3; ++i) {
+    seen += buckets[i];
+    while (next < 3 && seen > 0 && seen >= ranks[next] * summary.count) {
+      const double lower = LowerBound(i);
+      const double upper = i + 1 < kBUCKETS ? LowerBound(i + 1) : lower;
+      *values[next++] = std::min((lower + upper) / 2., summary.max);
+    }
+  }
+  return summary;
+}
+
+Counter &GetCounter(const std::string &name) {
+  return GetOrCreate(counters, name);
+}
+
+Gauge &GetGauge(const std::string &name) { return GetOrCreate(gauges, name); }
+
+Histogram &GetHistogram(const std::string &name) {
+  return GetOrCreate(histograms, name);
+}
+
+void Exporter::ThreadExport() {
+  SPDLOG_DEBUG("[ThreadExport] Started.");
+  thread_policy::Apply("ThreadExport");
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!condition_.wait_for(lock, period_, [this] { return !running_; })) {
+    lock.unlock();
+    const std::string line = Snapshot();
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      last_line_ = line;
+    }
+
+    if (!file_path_.empty()) {
+      std::ofstream file(file_path_, std::ios::app);
+      file << line << '\n';
+    }
+    if (socket_ >= 0) {
+      sockaddr_un addr = {};
+      addr.sun_family = AF_UNIX;
+      std::strncpy(addr.sun_path, socket_path_.c_str(),
+                   sizeof(addr.sun_path) - 1);
+      /* 没有接收者时发送失败，忽略即可 */
+      sendto(socket_, line.data(), line.size(), MSG_DONTWAIT,
+             reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    }
+    lock.lock();
+  }
+  SPDLOG_DEBUG("[ThreadExport] Stoped.");
+}
+
+Exporter::Exporter(const std::string &file_path,
+                   const std::string &socket_path,
+                   std::chrono::milliseconds period)
+    : file_path_(file_path),
+      socket_path_(socket_path),
+      period_(period),
+      socket_(-1),
+      running_(true),
+      last_(std::chrono::steady_clock::now()),
+      last_line_("{}") {
+  if (!socket_path_.empty()) {
+    socket_ = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (socket_ < 0) SPDLOG_ERROR("Can't create socket: {}", errno);
+  }
+  thread_ = std::thread(&Exporter::ThreadExport, this);
+  SPDLOG_TRACE("Constructed.");
+}
+
+Exporter::~Exporter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  condition_.notify_all();
+  if (thread_.joinable()) thread_.join();
+  if (socket_ >= 0) close(socket_);
+  SPDLOG_TRACE("Destructed.");
+}
+
+std::string Exporter::Last() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return last_line_;
+}
+
+std::string Exporter::Snapshot() {
+  std::lock_guard<std::mutex> lock(mutex_registry);
+  const auto now = std::chrono::steady_clock::now();
+  const double elapsed = std::chrono::duration<double>(now - last_).count();
+  last_ = now;
+
+  std::string out = fmt::format(
+      "{{\"time\":{:.3f},\"counters\":{{",
+      std::chrono::duration<double>(now.time_since_epoch()).count());
+
+  bool first = true;
+  for (auto &counter : counters) {
+    const uint64_t total = counter.second->Get();
+    uint64_t &last = last_counts_[counter.first];
+    const double rate = elapsed > 0. ? (total - last) / elapsed : 0.;
+    last = total;
+    out += fmt::format("{}\"{}\":{{\"total\":{},\"rate\":{:.1f}}}",
+                       first ? "" : ",", counter.first, total, rate);
+    first = false;
+  }
+
+  out += "},\"gauges\":{";
+  first = true;
+  for (auto &gauge : gauges) {
+    out += fmt::format("{}\"{}\":{}", first ? "" : ",", gauge.first,
+                       gauge.second->Get());
+    first = false;
+  }
+
+  out += "},\"histograms\":{";
+  first = true;
+  for (auto &histogram : histograms) {
+    const auto summary = histogram.second->Collect();
+    out += fmt::format(
+        "{}\"{}\":{{\"count\":{},\"mean\":{:.0f},\"p50\":{:.0f},"
+        "\"p90\":{:.0f},\"p99\":{:.0f},\"max\":{:.0f}}}",
+        first ? "" : ",", histogram.first, summary.count, summary.mean,
+        summary.p50, summary.p90, summary.p99, summary.max);
+    first = false;
+  }
+  out += "}}";
+  return out;
+}
+
+}  // namespace metrics
+
+}  // namespace component
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace component {
+
+/**
+ * @brief 进程内的运行指标
+ *
+ * 计数器、瞬时值与延迟直方图按名称注册，注册后地址不变，调用方保存引用即可
+ * 在热路径上直接记录。Exporter 定期汇总并输出为一行 JSON。
+ */
+namespace metrics {
+
+/* 只增不减的计数，导出时同时给出每秒的增量 */
+class Counter {
+ private:
+  std::atomic<uint64_t> value_;
+
+ public:
+  Counter() : value_(0) {}
+
+  void Add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+  uint64_t Get() const { return value_.load(std::memory_order_relaxed); }
+};
+
+/* 瞬时值，如帧率、队列长度 */
+class Gauge {
+ private:
+  std::atomic<double> value_;
+
+ public:
+  Gauge() : value_(0.) {}
+
+  void Set(double value) { value_.store(value, std::memory_order_relaxed); }
+  double Get() const { return value_.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief 对数线性分桶的延迟直方图，相对误差约 6%
+ *
+ * 每 2 倍的区间等分为 16 个桶，可记录 0 到 2^64 ns。记录时只对当前线程
+ * 对应分片中的一个桶做原子加，多线程记录时几乎没有竞争。
+ */
+class Histogram {
+ public:
+  static constexpr int kSUB_BITS = 4;
+  static constexpr std::size_t kSUB = 1 << kSUB_BITS;
+  static constexpr std::size_t kBUCKETS = (64 - kSUB_BITS + 1) * kSUB;
+  static constexpr std::size_t kSHARDS = 4;
+
+  struct Summary {
+    uint64_t count;
+    double mean, p50, p90, p99, max; /* ns */
+  };
+
+ private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, kBUCKETS> buckets;
+    std::atomic<uint64_t> count, sum, max;
+  };
+
+  std::array<Shard, kSHARDS> shards_;
+
+ public:
+  Histogram();
+
+  static std::size_t BucketOf(uint64_t value);
+  static uint64_t LowerBound(std::size_t bucket);
+
+  /**
+   * @brief 记录一次耗时
+   *
+   * @param ns 耗时(ns)
+   */
+  void Record(uint64_t ns);
+  void Record(std::chrono::nanoseconds duration);
+
+  /**
+   * @brief 汇总上次调用以来的记录并清零，应只有一个调用者，一般为 Exporter
+   *
+   * @return Summary 汇总
+   */
+  Summary Collect();
+};
+
+/* 在作用域内计时并记录到直方图 */
+class LatencyTimer {
+ private:
+  Histogram &histogram_;
+  std::chrono::steady_clock::time_point start_;
+
+ public:
+  explicit LatencyTimer(Histogram &histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  ~LatencyTimer() {
+    histogram_.Record(std::chrono::steady_clock::now() - start_);
+  }
+
+  LatencyTimer(const LatencyTimer &) = delete;
+  LatencyTimer &operator=(const LatencyTimer &) = delete;
+};
+
+/**
+ * @brief 按名称获取指标，不存在时创建。查找需要加锁，应在初始化时获取并
+ * 保存引用
+ *
+ * @param name 名称
+ */
+Counter &GetCounter(const std::string &name);
+Gauge &GetGauge(const std::string &name);
+Histogram &GetHistogram(const std::string &name);
+
+/**
+ * @brief 定期将所有指标写入文件并发往 UNIX socket
+ *
+ * 文件中每行是一次快照；socket 为数据报，发往已有进程绑定的路径，例如
+ * socat UNIX-RECVFROM:/tmp/qdu_rm_ai.metrics,fork STDOUT，没有接收者时
+ * 直接丢弃。
+ */
+class Exporter {
+ private:
+  std::string file_path_, socket_path_;
+  std::chrono::milliseconds period_;
+  int socket_;
+
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool running_;
+
+  std::map<std::string, uint64_t> last_counts_;
+  std::chrono::steady_clock::time_point last_;
+  std::string last_line_;
+
+  void ThreadExport();
+
+ public:
+  /**
+   * @brief Construct a new Exporter object
+   *
+   * @param file_path 文件路径，为空时不写文件
+   * @param socket_path socket 路径，为空时不发送
+   * @param period 导出周期
+   */
+  Exporter(const std::string &file_path, const std::string &socket_path,
+           std::chrono::milliseconds period = std::chrono::seconds(1));
+
+  /**
+   * @brief Destroy the Exporter object
+   *
+   */
+  ~Exporter();
+
+  /**
+   * @brief 生成一次快照，直方图与计数速率均为上次快照以来的数据
+   *
+   * @return std::string 单行 JSON
+   */
+  std::string Snapshot();
+
+  /**
+   * @brief 最近一次定期导出的快照，不会清零直方图，可供其他线程读取
+   *
+   * @return std::string 单行 JSON，尚未导出时为 "{}"
+   */
+  std::string Last();
+};
+
+}  // namespace metrics
+
+}  // namespace component
+
+#define METRICS_CONCAT_INNER(a, b) a##b
+#define METRICS_CONCAT(a, b) METRICS_CONCAT_INNER(a, b)
+
+/* 将此处到作用域结束的耗时记录到名为 name 的直方图，只在第一次执行时查找 */
+#define METRICS_LATENCY(name)                                 \
+  static auto &METRICS_CONCAT(metrics_histogram_, __LINE__) = \
+      component::metrics::GetHistogram(name);                 \
+  component::metrics::LatencyTimer METRICS_CONCAT(            \
+      metrics_timer_, __LINE__)(METRICS_CONCAT(metrics_histogram_, __LINE__))
@@ -0,0 +1,374 @@
+#include "record.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+#include "hot_log.hpp"
+#include "opencv2/imgcodecs.hpp"
+#include "spdlog/spdlog.h"
+#include "thread_policy.hpp"
+
+namespace component {
+
+namespace record {
+
+namespace {
+
+const uint64_t kFILE_MAGIC = 0x3143455255445129; /* ")QDUREC1" */
+const uint64_t kCHUNK_MAGIC = 0x4b4e554843455229; /* ")RECHUNK" */
+const uint32_t kVERSION = 1;
+const std::size_t kPAGE = 4096;
+const std::size_t kFRAME_QUEUE = 16;
+const std::size_t kTELEMETRY_QUEUE = 4096;
+const int kPOP_TIMEOUT = 10; /* ms，超时后写入遥测数据并检查是否需要退出 */
+const int kJPEG_QUALITY = 95;
+
+/* 文件头占第一页，之后为连续的块 */
+struct FileHeader {
+  uint64_t magic;
+  uint32_t version;
+  int32_t codec;
+  int64_t system_offset;
+  uint64_t chunk_bytes;
+};
+
+/* 最后一块的 size 在关闭时缩小为实际使用的大小 */
+struct ChunkHeader {
+  uint64_t magic;
+  uint64_t size, used, records;
+  int64_t first_stamp, last_stamp;
+};
+
+/* 记录头之后为数据，按 8 字节对齐 */
+struct RecordHeader {
+  uint32_t type;
+  uint32_t size;
+  int64_t stamp;
+};
+
+struct FrameHeader {
+  int32_t rows, cols, type, codec;
+  uint64_t frame_id;
+};
+
+std::size_t Align(std::size_t size, std::size_t align) {
+  return (size + align - 1) / align * align;
+}
+
+int64_t ToNanoseconds(std::chrono::steady_clock::time_point stamp) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             stamp.time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+bool Writer::NewChunk(std::size_t bytes) {
+  const std::size_t size =
+      std::max(chunk_bytes_, Align(sizeof(ChunkHeader) + bytes, kPAGE));
+  /* 预先分配磁盘空间，写入时不会因分配块而等待 */
+  const int err = posix_fallocate(fd_, file_size_, size);
+  void *chunk = MAP_FAILED;
+  if (err == 0)
+    chunk = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_,
+                 file_size_);
+  if (chunk == MAP_FAILED) {
+    HOT_LOG_EVERY_MS(SPDLOG_ERROR, 1000, "Can't allocate chunk in '{}': {}",
+                     path_, std::strerror(err != 0 ? err : errno));
+    return false;
+  }
+
+  chunk_ = static_cast<uint8_t *>(chunk);
+  chunk_offset_ = file_size_;
+  chunk_size_ = size;
+  chunk_used_ = sizeof(ChunkHeader);
+  file_size_ += size;
+
+  auto header = reinterpret_cast<ChunkHeader *>(chunk_);
+  header->size = size;
+  header->used = chunk_used_;
+  header->records = 0;
+  header->first_stamp = header->last_stamp = 0;
+  header->magic = kCHUNK_MAGIC;
+  return true;
+}
+
+void Writer::CloseChunk() {
+  if (chunk_ == nullptr) return;
+  munmap(chunk_, chunk_size_);
+  chunk_ = nullptr;
+}
+
+bool Writer::Append(Type type, int64_t stamp, const void *head,
+                    std::size_t head_size, const void *data,
+                    std::size_t size) {
+  const std::size_t bytes =
+      sizeof(RecordHeader) + Align(head_size + size, sizeof(uint64_t));
+  if (chunk_ == nullptr || chunk_used_ + bytes > chunk_size_) {
+    CloseChunk();
+    if (!NewChunk(bytes)) return false;
+  }
+
+  uint8_t *record = chunk_ + chunk_used_;
+  auto record_header = reinterpret_cast<RecordHeader *>(record);
+  record_header->type = static_cast<uint32_t>(type);
+  record_header->size = head_size + size;
+  record_header->stamp = stamp;
+  record += sizeof(RecordHeader);
+  if (head_size > 0) std::memcpy(record, head, head_size);
+  if (size > 0) std::memcpy(record + head_size, data, size);
+  chunk_used_ += bytes;
+
+  /* 记录写完后才更新块头，异常退出时块头总是指向完整的记录 */
+  auto header = reinterpret_cast<ChunkHeader *>(chunk_);
+  if (header->records++ == 0) header->first_stamp = stamp;
+  header->last_stamp = std::max(header->last_stamp, stamp);
+  header->used = chunk_used_;
+  return true;
+}
+
+void Writer::WriteFrame(Frame &frame) {
+  metrics::LatencyTimer timer(write_latency_);
+  const FrameHeader head = {frame.image.rows, frame.image.cols,
+                            frame.image.type(), static_cast<int32_t>(codec_),
+                            frame.frame_id};
+  bool ok = false;
+  if (codec_ == Codec::kJPEG) {
+    ok = cv::imencode(".jpg", frame.image, encoded_,
+                      {cv::IMWRITE_JPEG_QUALITY, kJPEG_QUALITY}) &&
+         Append(Type::kFRAME, frame.stamp, &head, sizeof(head),
+                encoded_.data(), encoded_.size());
+  } else {
+    if (!frame.image.isContinuous()) frame.image = frame.image.clone();
+    ok = Append(Type::kFRAME, frame.stamp, &head, sizeof(head),
+                frame.image.data, frame.image.total() * frame.image.elemSize());
+  }
+  if (!ok) drop_count_.Add();
+}
+
+void Writer::ThreadWrite() {
+  SPDLOG_DEBUG("[ThreadWrite] Started.");
+  thread_policy::Apply("ThreadWrite");
+
+  Telemetry telemetry;
+  Frame frame;
+  while (true) {
+    while (telemetry_.Pop(telemetry, 0)) {
+      if (!Append(telemetry.type, telemetry.stamp, nullptr, 0,
+                  telemetry.data.data(), telemetry.size))
+        drop_count_.Add();
+    }
+    if (frames_.Pop(frame, kPOP_TIMEOUT)) {
+      WriteFrame(frame);
+      frame.image.release();
+    } else if (!running_ && telemetry_.Size() == 0) {
+      break;
+    }
+  }
+
+  /* 截掉最后一块未使用的部分 */
+  if (chunk_ != nullptr) {
+    reinterpret_cast<ChunkHeader *>(chunk_)->size = chunk_used_;
+    file_size_ = chunk_offset_ + chunk_used_;
+    CloseChunk();
+  }
+  if (ftruncate(fd_, file_size_) != 0)
+    SPDLOG_ERROR("Can't truncate '{}': {}", path_, std::strerror(errno));
+  SPDLOG_DEBUG("[ThreadWrite] Stoped. {} bytes.", file_size_);
+}
+
+Writer::Writer(const std::string &path, Codec codec, std::size_t chunk_bytes)
+    : path_(path),
+      codec_(codec),
+      chunk_bytes_(Align(chunk_bytes, kPAGE)),
+      fd_(-1),
+      frames_(kFRAME_QUEUE),
+      telemetry_(kTELEMETRY_QUEUE),
+      running_(true),
+      drop_count_(metrics::GetCounter("record.dropped")),
+      write_latency_(metrics::GetHistogram("record.write")),
+      chunk_(nullptr),
+      chunk_offset_(0),
+      chunk_size_(0),
+      chunk_used_(0),
+      file_size_(kPAGE) {
+  if (path.empty()) {
+    SPDLOG_INFO("Recording disabled.");
+    return;
+  }
+
+  const int64_t system_offset =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count() -
+      ToNanoseconds(std::chrono::steady_clock::now());
+  const FileHeader header = {kFILE_MAGIC, kVERSION,
+                             static_cast<int32_t>(codec), system_offset,
+                             chunk_bytes_};
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ < 0 || ftruncate(fd_, kPAGE) != 0 ||
+      pwrite(fd_, &header, sizeof(header), 0) != sizeof(header)) {
+    SPDLOG_ERROR("Can't create '{}': {}", path, std::strerror(errno));
+    if (fd_ >= 0) close(fd_);
+    fd_ = -1;
+    return;
+  }
+  thread_ = std::thread(&Writer::ThreadWrite, this);
+  SPDLOG_INFO("Recording to '{}'.", path);
+  SPDLOG_TRACE("Constructed.");
+}
+
+Writer::~Writer() {
+  running_ = false;
+  if (thread_.joinable()) thread_.join();
+  if (fd_ >= 0) close(fd_);
+  SPDLOG_TRACE("Destructed.");
+}
+
+void Writer::Write(const cv::Mat &image,
+                   std::chrono::steady_clock::time_point stamp,
+                   uint64_t frame_id) {
+  if (!Ok() || image.empty()) return;
+  if (frames_.Push({image, ToNanoseconds(stamp), frame_id})) drop_count_.Add();
+}
+
+void Writer::Write(Type type, std::chrono::steady_clock::time_point stamp,
+                   const void *data, std::size_t size) {
+  if (!Ok()) return;
+  if (size > kMAX_TELEMETRY) {
+    SPDLOG_ERROR("Telemetry of {} bytes is too large.", size);
+    return;
+  }
+  Telemetry telemetry;
+  telemetry.type = type;
+  telemetry.stamp = ToNanoseconds(stamp);
+  telemetry.size = size;
+  std::memcpy(telemetry.data.data(), data, size);
+  if (telemetry_.Push(std::move(telemetry))) drop_count_.Add();
+}
+
+Reader::Reader() : base_(nullptr), size_(0), system_offset_(0) {
+  SPDLOG_TRACE("Constructed.");
+}
+
+Reader::~Reader() {
+  if (base_ != nullptr) munmap(base_, size_);
+  SPDLOG_TRACE("Destructed.");
+}
+
+bool Reader::Open(const std::string &path) {
+  if (base_ != nullptr) munmap(base_, size_);
+  base_ = nullptr;
+  size_ = 0;
+  for (auto &entries : entries_) entries.clear();
+
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat st = {};
+  void *base = MAP_FAILED;
+  if (fd >= 0 && fstat(fd, &st) == 0 &&
+      static_cast<std::size_t>(st.st_size) >= kPAGE)
+    base = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (fd >= 0) close(fd);
+  if (base == MAP_FAILED) {
+    SPDLOG_ERROR("Can't open '{}': {}", path, std::strerror(errno));
+    return false;
+  }
+  base_ = static_cast<uint8_t *>(base);
+  size_ = st.st_size;
+
+  const auto file = reinterpret_cast<const FileHeader *>(base_);
+  if (file->magic != kFILE_MAGIC || file->version != kVERSION) {
+    SPDLOG_ERROR("'{}' is not a recording.", path);
+    return false;
+  }
+  system_offset_ = file->system_offset;
+
+  /* 遍历各块的记录头，遇到不完整的块为止 */
+  std::size_t offset = kPAGE, chunks = 0;
+  while (offset + sizeof(ChunkHeader) <= size_) {
+    const auto chunk = reinterpret_cast<const ChunkHeader *>(base_ + offset);
+    if (chunk->magic != kCHUNK_MAGIC || chunk->size < sizeof(ChunkHeader))
+      break;
+    const std::size_t end = offset + std::min(chunk->used, chunk->size);
+    std::size_t pos = offset + sizeof(ChunkHeader);
+    while (pos + sizeof(RecordHeader) <= std::min(end, size_)) {
+      const auto record = reinterpret_cast<const RecordHeader *>(base_ + pos);
+      const std::size_t bytes =
+          sizeof(RecordHeader) + Align(record->size, sizeof(uint64_t));
+      if (pos + bytes > std::min(end, size_)) break;
+      if (record->type > 0 && record->type < kTYPES) {
+        entries_[record->type].push_back(
+            {std::chrono::steady_clock::time_point(
+                 std::chrono::nanoseconds(record->stamp)),
+             base_ + pos + sizeof(RecordHeader), record->size});
+      }
+      pos += bytes;
+    }
+    offset += chunk->size;
+    ++chunks;
+  }
+
+  /* 不同线程写入的记录在队列中可能交错 */
+  for (auto &entries : entries_) {
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const Entry &a, const Entry &b) {
+                       return a.stamp < b.stamp;
+                     });
+  }
+  SPDLOG_INFO("'{}': {} chunks, {} frames.", path, chunks,
+              Size(Type::kFRAME));
+  return true;
+}
+
+const std::vector<Reader::Entry> &Reader::Entries(Type type) const {
+  static const std::vector<Entry> empty;
+  const auto index = static_cast<std::size_t>(type);
+  return index < kTYPES ? entries_[index] : empty;
+}
+
+std::size_t Reader::Size(Type type) const { return Entries(type).size(); }
+
+const Reader::Entry &Reader::At(Type type, std::size_t index) const {
+  return Entries(type).at(index);
+}
+
+std::size_t Reader::Find(Type type,
+                         std::chrono::steady_clock::time_point stamp) const {
+  const auto &entries = Entries(type);
+  return std::lower_bound(entries.begin(), entries.end(), stamp,
+                          [](const Entry &entry,
+                             std::chrono::steady_clock::time_point stamp) {
+                            return entry.stamp < stamp;
+                          }) -
+         entries.begin();
+}
+
+bool Reader::GetFrame(std::size_t index, cv::Mat &image,
+                      uint64_t &frame_id) const {
+  if (index >= Size(Type::kFRAME)) return false;
+  const auto &entry = At(Type::kFRAME, index);
+  if (entry.size < sizeof(FrameHeader)) return false;
+
+  FrameHeader head;
+  std::memcpy(&head, entry.data, sizeof(head));
+  uint8_t *data = const_cast<uint8_t *>(entry.data) + sizeof(FrameHeader);
+  const std::size_t size = entry.size - sizeof(FrameHeader);
+  frame_id = head.frame_id;
+
+  if (head.codec == static_cast<int32_t>(Codec::kJPEG)) {
+    image = cv::imdecode(cv::Mat(1, size, CV_8UC1, data), cv::IMREAD_UNCHANGED);
+  } else {
+    image = cv::Mat(head.rows, head.cols, head.type, data);
+    if (image.total() * image.elemSize() > size) image.release();
+  }
+  return !image.empty();
+}
+
+}  // namespace record
+
+}  // namespace component
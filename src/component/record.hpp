@@ -0,0 +1,234 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "drop_queue.hpp"
+#include "metrics.hpp"
+#include "opencv2/core/mat.hpp"
+
+namespace component {
+
+namespace record {
+
+/* 记录的类型，数值写入文件，不能修改 */
+enum class Type : uint32_t {
+  kFRAME = 1, /* 图像 */
+  kMCU = 2,   /* 下位机数据，含姿态四元数 */
+  kREFEREE = 3,
+  kCOMMAND = 4, /* 发往下位机的指令 */
+};
+const std::size_t kTYPES = 5; /* Type 的取值上限 */
+
+/* 图像的存储方式 */
+enum class Codec : int32_t {
+  kRAW = 0,  /* 原始数据，回放结果可逐位比对 */
+  kJPEG = 1, /* 高质量 JPEG，体积约为原始数据的十分之一 */
+};
+
+/* 除图像外单条记录的最大字节数 */
+const std::size_t kMAX_TELEMETRY = 128;
+
+/**
+ * @brief 录制图像与遥测数据，写入分块的内存映射文件
+ *
+ * 文件由固定大小的块组成，块头记录已写入的字节数、条数与时间范围，每次写入
+ * 后更新，程序异常退出时已写入的记录仍可读取。块在创建时预先分配磁盘空间。
+ *
+ * 调用方只把图像句柄或遥测数据的副本放入队列，不等待写入。写入线程跟不上时
+ * 丢弃最旧的记录并计数，不会阻塞视觉主循环或串口线程。
+ */
+class Writer {
+ private:
+  struct Telemetry {
+    Type type;
+    int64_t stamp;
+    uint32_t size;
+    std::array<uint8_t, kMAX_TELEMETRY> data;
+  };
+
+  struct Frame {
+    cv::Mat image;
+    int64_t stamp;
+    uint64_t frame_id;
+  };
+
+  std::string path_;
+  Codec codec_;
+  std::size_t chunk_bytes_;
+  int fd_;
+
+  DropQueue<Frame> frames_;
+  DropQueue<Telemetry> telemetry_;
+  std::atomic<bool> running_;
+  std::thread thread_;
+  metrics::Counter &drop_count_;
+  metrics::Histogram &write_latency_;
+
+  /* 以下只在写入线程中访问 */
+  uint8_t *chunk_;
+  std::size_t chunk_offset_, chunk_size_, chunk_used_, file_size_;
+  std::vector<uint8_t> encoded_;
+
+  void ThreadWrite();
+  bool NewChunk(std::size_t bytes);
+  void CloseChunk();
+  bool Append(Type type, int64_t stamp, const void *head, std::size_t head_size,
+              const void *data, std::size_t size);
+  void WriteFrame(Frame &frame);
+
+ public:
+  /**
+   * @brief Construct a new Writer object
+   *
+   * @param path 文件路径，为空时不录制
+   * @param codec 图像的存储方式
+   * @param chunk_bytes 块的大小
+   */
+  Writer(const std::string &path, Codec codec = Codec::kRAW,
+         std::size_t chunk_bytes = 64 << 20);
+
+  /**
+   * @brief Destroy the Writer object，写完队列中的记录后关闭文件
+   *
+   */
+  ~Writer();
+
+  /* 是否在录制 */
+  bool Ok() const { return fd_ >= 0; }
+
+  /**
+   * @brief 录制一帧图像，只保存句柄，调用方之后不应再写入该图像
+   *
+   * @param image 图像
+   * @param stamp 采集时刻
+   * @param frame_id 帧号
+   */
+  void Write(const cv::Mat &image, std::chrono::steady_clock::time_point stamp,
+             uint64_t frame_id);
+
+  /**
+   * @brief 录制一条遥测数据
+   *
+   * @param type 类型
+   * @param stamp 时刻
+   * @param data 数据
+   * @param size 字节数，不超过 kMAX_TELEMETRY
+   */
+  void Write(Type type, std::chrono::steady_clock::time_point stamp,
+             const void *data, std::size_t size);
+
+  template <typename T>
+  void Write(Type type, std::chrono::steady_clock::time_point stamp,
+             const T &data) {
+    static_assert(std::is_trivially_copyable<T>::value &&
+                      sizeof(T) <= kMAX_TELEMETRY,
+                  "Telemetry must be small and trivially copyable.");
+    Write(type, stamp, &data, sizeof(T));
+  }
+};
+
+/**
+ * @brief 读取 Writer 录制的文件，按类型与时刻随机访问
+ *
+ * 打开时遍历各块的记录头建立索引，数据留在内存映射中，按需读取。
+ */
+class Reader {
+ public:
+  struct Entry {
+    std::chrono::steady_clock::time_point stamp;
+    const uint8_t *data;
+    std::size_t size;
+  };
+
+ private:
+  uint8_t *base_;
+  std::size_t size_;
+  int64_t system_offset_;
+  std::array<std::vector<Entry>, kTYPES> entries_;
+
+  const std::vector<Entry> &Entries(Type type) const;
+
+ public:
+  Reader();
+  ~Reader();
+
+  Reader(const Reader &) = delete;
+  Reader &operator=(const Reader &) = delete;
+
+  /**
+   * @brief 打开文件并建立索引
+   *
+   * @param path 文件路径
+   * @return true 打开成功
+   * @return false 文件不存在或格式不符
+   */
+  bool Open(const std::string &path);
+
+  /**
+   * @brief 某一类型的记录数
+   *
+   * @param type 类型
+   * @return std::size_t 条数
+   */
+  std::size_t Size(Type type) const;
+
+  /**
+   * @brief 按序号获取记录，同一类型内按时刻排序
+   *
+   * @param type 类型
+   * @param index 序号
+   * @return const Entry& 记录
+   */
+  const Entry &At(Type type, std::size_t index) const;
+
+  /**
+   * @brief 查找不早于某一时刻的第一条记录
+   *
+   * @param type 类型
+   * @param stamp 时刻
+   * @return std::size_t 序号，都早于该时刻时为 Size(type)
+   */
+  std::size_t Find(Type type,
+                   std::chrono::steady_clock::time_point stamp) const;
+
+  /**
+   * @brief 读取图像
+   *
+   * @param index 序号
+   * @param image 图像，原始数据时直接指向文件映射，不可写入
+   * @param frame_id 录制时的帧号
+   * @return true 读取成功
+   * @return false 序号越界或解码失败
+   */
+  bool GetFrame(std::size_t index, cv::Mat &image, uint64_t &frame_id) const;
+
+  /**
+   * @brief 录制开始时 steady_clock 与 system_clock 的差，用于换算为日历时间
+   *
+   * @return std::chrono::nanoseconds system_clock 减 steady_clock
+   */
+  std::chrono::nanoseconds SystemOffset() const {
+    return std::chrono::nanoseconds(system_offset_);
+  }
+
+  template <typename T>
+  bool Get(Type type, std::size_t index, T &data) const {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Telemetry must be trivially copyable.");
+    if (index >= Size(type) || At(type, index).size != sizeof(T)) return false;
+    std::memcpy(&data, At(type, index).data, sizeof(T));
+    return true;
+  }
+};
+
+}  // namespace record
+
+}  // namespace component
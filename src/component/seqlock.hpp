@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace component {
+
+/**
+ * @brief 单写多读的顺序锁
+ *
+ * 写者从不等待，读者在写入期间重试，得到的总是某一次完整写入的副本。
+ * 数据按字存放在原子变量中，读写重叠时不存在数据竞争。
+ */
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SeqLock requires a trivially copyable type.");
+
+ private:
+  static const std::size_t kWORDS =
+      (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  static const int kSPIN = 64; /* 连续重试次数，超过后让出线程 */
+
+  std::atomic<uint32_t> seq_;
+  std::array<std::atomic<uint64_t>, kWORDS> data_;
+
+ public:
+  SeqLock() : seq_(0) {
+    for (auto &word : data_) word.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 写入，同一时刻只能有一个写者
+   *
+   * @param value 新的值
+   */
+  void Store(const T &value) {
+    uint64_t buff[kWORDS] = {};
+    std::memcpy(buff, &value, sizeof(T));
+
+    const uint32_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kWORDS; ++i)
+      data_[i].store(buff[i], std::memory_order_relaxed);
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  /**
+   * @brief 尝试读取一次
+   *
+   * @param value 读到的值
+   * @return true 读到一致的副本
+   * @return false 与写入重叠，value 未修改
+   */
+  bool TryLoad(T &value) const {
+    const uint32_t begin = seq_.load(std::memory_order_acquire);
+    if (begin & 1) return false;
+
+    uint64_t buff[kWORDS];
+    for (std::size_t i = 0; i < kWORDS; ++i)
+      buff[i] = data_[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq_.load(std::memory_order_relaxed) != begin) return false;
+
+    std::memcpy(&value, buff, sizeof(T));
+    return true;
+  }
+
+  /**
+   * @brief 读取，与写入重叠时重试
+   *
+   * @return T 一致的副本
+   */
+  T Load() const {
+    T value;
+    for (int i = 1; !TryLoad(value); ++i)
+      if (i % kSPIN == 0) std::this_thread::yield();
+    return value;
+  }
+
+  /**
+   * @brief 已完成的写入次数
+   *
+   * @return uint32_t 次数
+   */
+  uint32_t Version() const {
+    return seq_.load(std::memory_order_acquire) / 2;
+  }
+};
+
+}  // namespace component
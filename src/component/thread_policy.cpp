@@ -0,0 +1,179 @@
+#include "thread_policy.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "opencv2/core.hpp"
+#include "spdlog/spdlog.h"
+#include "tbb/global_control.h"
+#include "tbb/task_scheduler_observer.h"
+#include "trace.hpp"
+
+namespace component {
+
+namespace thread_policy {
+
+namespace {
+
+/* TBB 工作线程的名称，默认使用 tbb_cpus */
+const char kTBB_WORKER[] = "TbbWorker";
+
+/* 内核中的线程名连同结尾最长 16 字节 */
+const std::size_t kNAME_LEN = 15;
+
+/* 线程退出时注销，之后不再对其应用策略 */
+struct Registration {
+  long tid = 0;
+  ~Registration();
+};
+
+std::mutex mutex_registry;
+std::map<std::string, Policy> policies;
+std::map<long, std::string> threads; /* 已登记的线程，tid 到线程名 */
+thread_local Registration local_registration;
+
+Registration::~Registration() {
+  if (tid == 0) return;
+  std::lock_guard<std::mutex> lock(mutex_registry);
+  threads.erase(tid);
+}
+
+/* 工作线程第一次进入调度时登记 */
+class WorkerObserver : public tbb::task_scheduler_observer {
+ public:
+  WorkerObserver() { observe(true); }
+  ~WorkerObserver() { observe(false); }
+
+  void on_scheduler_entry(bool is_worker) override {
+    if (is_worker && local_registration.tid == 0) Apply(kTBB_WORKER);
+  }
+};
+
+std::unique_ptr<tbb::global_control> tbb_control;
+std::unique_ptr<WorkerObserver> tbb_observer;
+
+std::vector<int> ReadCpus(const cv::FileNode &node) {
+  std::vector<int> cpus;
+  for (auto it = node.begin(); it != node.end(); ++it)
+    cpus.push_back(static_cast<int>(*it));
+  return cpus;
+}
+
+std::string ToString(const std::vector<int> &cpus) {
+  if (cpus.empty()) return "any";
+  std::string str;
+  for (int cpu : cpus) str += (str.empty() ? "" : ",") + std::to_string(cpu);
+  return str;
+}
+
+/* 通过 tid 设置，可以作用于其他线程 */
+bool ApplyTo(long tid, const std::string &name, const Policy &policy) {
+  bool ok = true;
+  if (!policy.cpus.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : policy.cpus) CPU_SET(cpu, &set);
+    if (sched_setaffinity(tid, sizeof(set), &set) != 0) {
+      SPDLOG_WARN("[{}] Can't set affinity to {}: {}", name,
+                  ToString(policy.cpus), std::strerror(errno));
+      ok = false;
+    }
+  }
+  if (policy.priority > 0) {
+    sched_param param = {};
+    param.sched_priority = policy.priority;
+    if (sched_setscheduler(tid, SCHED_FIFO, &param) != 0) {
+      SPDLOG_WARN("[{}] Can't set SCHED_FIFO {}: {}", name, policy.priority,
+                  std::strerror(errno));
+      ok = false;
+    }
+  }
+  SPDLOG_INFO("[{}] tid: {}, cpus: {}, priority: {}", name, tid,
+              ToString(policy.cpus), policy.priority);
+  return ok;
+}
+
+}  // namespace
+
+bool Load(const std::string &path) {
+  cv::FileStorage fs(path,
+                     cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+  if (!fs.isOpened()) {
+    SPDLOG_ERROR("Can not open file: '{}'", path);
+    return false;
+  }
+
+  std::map<std::string, Policy> loaded;
+  cv::FileNode node = fs["threads"];
+  for (auto it = node.begin(); it != node.end(); ++it) {
+    Policy policy = {ReadCpus((*it)["cpus"]), 0};
+    if (!(*it)["priority"].empty())
+      policy.priority = static_cast<int>((*it)["priority"]);
+    loaded[static_cast<std::string>((*it)["name"])] = policy;
+  }
+
+  /* 主线程也参与并行计算，工作线程数为核数减一 */
+  const std::vector<int> tbb_cpus = ReadCpus(fs["tbb_cpus"]);
+  if (!tbb_cpus.empty()) {
+    loaded.emplace(kTBB_WORKER, Policy{tbb_cpus, 0});
+    tbb_control = std::make_unique<tbb::global_control>(
+        tbb::global_control::max_allowed_parallelism, tbb_cpus.size());
+    if (!tbb_observer) tbb_observer = std::make_unique<WorkerObserver>();
+    SPDLOG_INFO("TBB parallelism: {}, cpus: {}", tbb_cpus.size(),
+                ToString(tbb_cpus));
+  } else {
+    tbb_control.reset();
+  }
+
+  /* 避免缺页带来的停顿，需要 CAP_IPC_LOCK 或足够的 RLIMIT_MEMLOCK */
+  if (!fs["lock_memory"].empty() && static_cast<int>(fs["lock_memory"])) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+      SPDLOG_WARN("Can't lock memory: {}", std::strerror(errno));
+    else
+      SPDLOG_INFO("Memory locked.");
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_registry);
+  policies.swap(loaded);
+  SPDLOG_INFO("Loaded {} thread policies from '{}'.", policies.size(), path);
+  for (auto &thread : threads) {
+    auto it = policies.find(thread.second);
+    if (it != policies.end()) ApplyTo(thread.first, thread.second, it->second);
+  }
+  return true;
+}
+
+bool Apply(const std::string &name) {
+  pthread_setname_np(pthread_self(), name.substr(0, kNAME_LEN).c_str());
+  trace::SetThreadName(name);
+
+  const long tid = syscall(SYS_gettid);
+  std::lock_guard<std::mutex> lock(mutex_registry);
+  local_registration.tid = tid;
+  threads[tid] = name;
+
+  auto it = policies.find(name);
+  if (it == policies.end()) return true;
+  return ApplyTo(tid, name, it->second);
+}
+
+bool Find(const std::string &name, Policy &policy) {
+  std::lock_guard<std::mutex> lock(mutex_registry);
+  auto it = policies.find(name);
+  if (it == policies.end()) return false;
+  policy = it->second;
+  return true;
+}
+
+}  // namespace thread_policy
+
+}  // namespace component
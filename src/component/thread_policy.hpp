@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace component {
+
+/**
+ * @brief 线程的命名、绑核与实时调度
+ *
+ * 配置为 JSON，例如：
+ * {
+ *     "lock_memory": 1,
+ *     "tbb_cpus": [2, 3],
+ *     "threads": [
+ *         { "name": "ThreadRecv", "cpus": [1], "priority": 80 }
+ *     ]
+ * }
+ * 线程启动时调用 Apply 登记名称，有对应配置时绑定到 cpus 上，priority 大于
+ * 0 时使用 SCHED_FIFO。TBB 的工作线程数限制为 tbb_cpus 的数量并绑定到这些核，
+ * 避免并行检测抢占串口与采集线程。
+ */
+namespace thread_policy {
+
+struct Policy {
+  std::vector<int> cpus; /* 为空时不绑核 */
+  int priority;          /* SCHED_FIFO 优先级，0 为默认调度 */
+};
+
+/**
+ * @brief 加载配置，对已登记的线程立即生效，应在创建线程前调用
+ *
+ * @param path 配置文件路径
+ * @return true 加载成功
+ * @return false 文件无法打开
+ */
+bool Load(const std::string &path);
+
+/**
+ * @brief 设置当前线程的名称并登记，有配置时应用对应的策略
+ *
+ * @param name 线程名，同时用于 trace
+ * @return true 已应用或没有对应配置
+ * @return false 绑核或设置调度失败，如没有实时调度的权限
+ */
+bool Apply(const std::string &name);
+
+/**
+ * @brief 查询线程名对应的配置
+ *
+ * @param name 线程名
+ * @param policy 配置
+ * @return true 存在配置
+ * @return false 不存在
+ */
+bool Find(const std::string &name, Policy &policy);
+
+}  // namespace thread_policy
+
+}  // namespace component
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
 #include <thread>
 
+#include "metrics.hpp"
 #include "spdlog/spdlog.h"
+#include "thread_policy.hpp"
 
 namespace component {
 
@@ -32,30 +38,47 @@ class Timer {
 class Recorder {
  private:
   std::thread thread_record_;
-  int fps_;
+  std::atomic<int> fps_;
+  metrics::Gauge &gauge_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool running_ = true;
 
   void Print() {
-    while (true) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-      SPDLOG_DEBUG("[RecordThread] FPS : {}", fps_);
-      fps_ = 0;
+    thread_policy::Apply("RecordThread");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!condition_.wait_for(lock, std::chrono::milliseconds(1000),
+                                [this] { return !running_; })) {
+      const int fps = fps_.exchange(0);
+      gauge_.Set(fps);
+      SPDLOG_DEBUG("[RecordThread] FPS : {}", fps);
     }
   }
 
  public:
-  Recorder(int fps = 0) : fps_(fps) {
+  /**
+   * @brief Construct a new Recorder object
+   *
+   * @param fps 初始计数
+   * @param name 帧率在 metrics 中的名称
+   */
+  Recorder(int fps = 0, const std::string& name = "fps")
+      : fps_(fps), gauge_(metrics::GetGauge(name)) {
     thread_record_ = std::thread(&Recorder::Print, this);
     SPDLOG_TRACE("Constructed.");
   }
 
   ~Recorder() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_ = false;
+    }
+    condition_.notify_all();
     thread_record_.join();
     SPDLOG_TRACE("Destructed.");
   }
 
-  void Record() {
-    // SPDLOG_DEBUG("[RecordThread] FPS++");
-    fps_++;
-  }
+  void Record() { fps_.fetch_add(1, std::memory_order_relaxed); }
 };
 }  // namespace component
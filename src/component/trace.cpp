@@ -0,0 +1,236 @@
+#include "trace.hpp"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "seqlock.hpp"
+#include "spdlog/spdlog.h"
+
+namespace component {
+
+namespace trace {
+
+namespace {
+
+/* 每个线程保留的区间数，按每帧十余个区间计，约为十几秒的记录 */
+const std::size_t kCAPACITY = 1 << 15;
+
+struct Event {
+  uint64_t index; /* 从 1 开始的序号，空位为 0 */
+  const char *name;
+  int64_t begin, end; /* 计数器读数 */
+  uint64_t frame;
+  uint32_t depth;
+};
+
+/* 单个线程的记录，由该线程独占写入 */
+struct Buffer {
+  /* 约 1.8MB，只命名而从未记录的线程不分配，建好后才对导出可见 */
+  std::unique_ptr<SeqLock<Event>[]> storage;
+  std::atomic<SeqLock<Event> *> events;
+  std::atomic<uint64_t> written, cleared; /* 序号不超过 cleared 的已清空 */
+  long tid;
+  std::string name;
+
+  Buffer()
+      : events(nullptr), written(0), cleared(0), tid(syscall(SYS_gettid)) {}
+
+  SeqLock<Event> *Events() {
+    SeqLock<Event> *events_ptr = events.load(std::memory_order_relaxed);
+    if (events_ptr == nullptr) {
+      storage.reset(new SeqLock<Event>[kCAPACITY]);
+      events_ptr = storage.get();
+      events.store(events_ptr, std::memory_order_release);
+    }
+    return events_ptr;
+  }
+};
+
+std::atomic<bool> enabled(false);
+std::mutex mutex_registry;
+std::vector<std::shared_ptr<Buffer>> registry;
+std::string exit_path;
+
+/* 线程退出后缓冲区仍由 registry 持有，之后仍可导出 */
+thread_local std::shared_ptr<Buffer> local_buffer;
+thread_local uint64_t local_frame = 0;
+thread_local uint32_t local_depth = 0;
+
+int64_t SteadyNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/* 区间两端读取计数器而非 steady_clock，导出时再换算为 ns。x86 的 TSC 与
+ * ARM 的虚拟计数器都以恒定频率递增，读取开销约为 steady_clock 的一半 */
+inline int64_t Ticks() {
+#if defined(__x86_64__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return SteadyNow();
+#endif
+}
+
+/* 换算的起点，与进程启动时的 steady_clock 对齐 */
+const int64_t kORIGIN_TICKS = Ticks();
+const int64_t kORIGIN_NS = SteadyNow();
+
+/**
+ * @brief 由起点与当前时刻估计每个计数对应的 ns
+ *
+ */
+double NanosPerTick() {
+  const int64_t ticks = Ticks() - kORIGIN_TICKS;
+  const int64_t ns = SteadyNow() - kORIGIN_NS;
+  return ticks > 0 ? static_cast<double>(ns) / ticks : 1.;
+}
+
+Buffer &LocalBuffer() {
+  if (!local_buffer) {
+    local_buffer = std::make_shared<Buffer>();
+    std::lock_guard<std::mutex> lock(mutex_registry);
+    registry.push_back(local_buffer);
+  }
+  return *local_buffer;
+}
+
+std::string Escape(const std::string &str) {
+  std::string out;
+  for (char c : str) {
+    if (c == '"' || c == '\\') out.push_back('\\');
+    if (static_cast<unsigned char>(c) >= 0x20) out.push_back(c);
+  }
+  return out;
+}
+
+void DumpAtExit() {
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(mutex_registry);
+    path = exit_path;
+  }
+  Dump(path);
+}
+
+}  // namespace
+
+void Enable(bool enable) { enabled.store(enable, std::memory_order_relaxed); }
+
+bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+
+void SetFrame(uint64_t frame) { local_frame = frame; }
+
+uint64_t GetFrame() { return local_frame; }
+
+void SetThreadName(const std::string &name) {
+  Buffer &buffer = LocalBuffer();
+  std::lock_guard<std::mutex> lock(mutex_registry);
+  buffer.name = name;
+}
+
+bool Dump(const std::string &path) {
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_registry);
+    buffers = registry;
+  }
+
+  std::FILE *file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    SPDLOG_ERROR("Can't open {}", path);
+    return false;
+  }
+
+  const int pid = getpid();
+  const double scale = NanosPerTick();
+  std::size_t count = 0;
+  std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  for (auto &buffer : buffers) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_registry);
+      if (!buffer->name.empty())
+        std::fprintf(file,
+                     "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                     "\"tid\":%ld,\"args\":{\"name\":\"%s\"}}",
+                     count++ ? "," : "", pid, buffer->tid,
+                     Escape(buffer->name).c_str());
+    }
+
+    /* 正在被覆盖的位置读不到一致的副本，直接跳过 */
+    const SeqLock<Event> *events =
+        buffer->events.load(std::memory_order_acquire);
+    if (events == nullptr) continue;
+    Event event;
+    const uint64_t cleared = buffer->cleared.load();
+    for (std::size_t i = 0; i < kCAPACITY; ++i) {
+      if (!events[i].TryLoad(event) || event.index <= cleared) continue;
+      std::fprintf(file,
+                   "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+                   "\"dur\":%.3f,\"pid\":%d,\"tid\":%ld,\"args\":{"
+                   "\"frame\":%llu,\"depth\":%u}}",
+                   count++ ? "," : "", event.name,
+                   (event.begin - kORIGIN_TICKS) * scale / 1e3,
+                   (event.end - event.begin) * scale / 1e3, pid, buffer->tid,
+                   static_cast<unsigned long long>(event.frame), event.depth);
+    }
+  }
+  std::fprintf(file, "]}\n");
+  const bool ok = std::fclose(file) == 0;
+  SPDLOG_INFO("Dumped {} trace events to {}", count, path);
+  return ok;
+}
+
+void DumpOnExit(const std::string &path) {
+  static std::once_flag registered;
+  {
+    std::lock_guard<std::mutex> lock(mutex_registry);
+    exit_path = path;
+  }
+  std::call_once(registered, [] { std::atexit(DumpAtExit); });
+}
+
+void Clear() {
+  /* 缓冲区只由所属线程写入，这里只记录清空时的位置 */
+  std::lock_guard<std::mutex> lock(mutex_registry);
+  for (auto &buffer : registry) buffer->cleared = buffer->written.load();
+}
+
+Span::Span(const char *name) : name_(nullptr), begin_(0) {
+  if (!enabled.load(std::memory_order_relaxed)) return;
+  name_ = name;
+  ++local_depth;
+  begin_ = Ticks();
+}
+
+Span::~Span() {
+  if (name_ == nullptr) return;
+  const int64_t end = Ticks();
+  --local_depth;
+
+  Buffer &buffer = LocalBuffer();
+  const uint64_t index = buffer.written.load(std::memory_order_relaxed) + 1;
+  buffer.written.store(index, std::memory_order_relaxed);
+  buffer.Events()[(index - 1) % kCAPACITY].Store(
+      {index, name_, begin_, end, local_frame, local_depth});
+}
+
+}  // namespace trace
+
+}  // namespace component
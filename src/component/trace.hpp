@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace component {
+
+/**
+ * @brief 轻量的分段计时
+ *
+ * 每个线程把结束的区间写入自己的环形缓冲区，写入不加锁；导出时合并所有线程
+ * 的记录，生成 Chrome trace 格式的 JSON，可在 chrome://tracing 或 Perfetto
+ * 中查看。记录的时刻取自 steady_clock，单位为 ns。默认关闭，关闭时每个区间
+ * 只多一次原子读。
+ */
+namespace trace {
+
+/**
+ * @brief 开启或关闭记录
+ *
+ * @param enable 是否开启
+ */
+void Enable(bool enable);
+bool Enabled();
+
+/**
+ * @brief 设置当前线程正在处理的帧号，之后的区间都带有这个帧号，用于关联
+ * 不同线程中同一帧的处理过程。0 表示不属于任何帧
+ *
+ * @param frame 帧号
+ */
+void SetFrame(uint64_t frame);
+uint64_t GetFrame();
+
+/**
+ * @brief 设置当前线程在导出结果中显示的名称
+ *
+ * @param name 名称
+ */
+void SetThreadName(const std::string &name);
+
+/**
+ * @brief 将目前所有线程的记录导出为 Chrome trace JSON
+ *
+ * @param path 文件路径
+ * @return true 导出成功
+ * @return false 无法写入文件
+ */
+bool Dump(const std::string &path);
+
+/**
+ * @brief 进程正常退出时导出
+ *
+ * @param path 文件路径
+ */
+void DumpOnExit(const std::string &path);
+
+/**
+ * @brief 清空所有线程的记录
+ *
+ */
+void Clear();
+
+/**
+ * @brief 作用域内的一个区间，析构时记录。名称只保存指针，必须是字符串常量
+ *
+ */
+class Span {
+ private:
+  const char *name_;
+  int64_t begin_;
+
+ public:
+  explicit Span(const char *name);
+  ~Span();
+
+  Span(const Span &) = delete;
+  Span &operator=(const Span &) = delete;
+};
+
+}  // namespace trace
+
+}  // namespace component
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+/* 记录从此处到作用域结束的区间 */
+#define TRACE_SPAN(name) \
+  component::trace::Span TRACE_CONCAT(trace_span_, __LINE__)(name)
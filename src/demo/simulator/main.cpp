@@ -0,0 +1,88 @@
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "log.hpp"
+#include "mcu_simulator.hpp"
+#include "spdlog/spdlog.h"
+
+namespace {
+
+volatile std::sig_atomic_t running = 1;
+
+void Usage(const char* name) {
+  SPDLOG_ERROR(
+      "Usage: {} [--mcu-rate Hz] [--ref-rate Hz] [--loss p] [--corrupt p] "
+      "[--jitter us] [--speed m/s] [--yaw-rate rad/s] [--duration s]",
+      name);
+}
+
+}  // namespace
+
+int main(int argc, char const* argv[]) {
+  component::Logger::SetLogger("logs/simulator.log");
+
+  SimulatorConfig config;
+  double duration = 0.;
+  for (int i = 1; i < argc; i += 2) {
+    if (i + 1 >= argc) {
+      Usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    const std::string key = argv[i];
+    const double value = std::atof(argv[i + 1]);
+    if (key == "--mcu-rate")
+      config.mcu_rate = value;
+    else if (key == "--ref-rate")
+      config.ref_rate = value;
+    else if (key == "--loss")
+      config.byte_loss = value;
+    else if (key == "--corrupt")
+      config.corrupt = value;
+    else if (key == "--jitter")
+      config.jitter_us = value;
+    else if (key == "--speed")
+      config.speed = value;
+    else if (key == "--yaw-rate")
+      config.yaw_rate = value;
+    else if (key == "--duration")
+      duration = value;
+    else {
+      Usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::signal(SIGINT, [](int) { running = 0; });
+  std::signal(SIGTERM, [](int) { running = 0; });
+
+  McuSimulator simulator;
+  if (!simulator.Start(config)) return EXIT_FAILURE;
+  SPDLOG_WARN("***** Running MCU Simulator on {}. *****", simulator.GetPath());
+
+  /* 每秒输出一次统计，duration 为 0 时一直运行 */
+  const auto start = std::chrono::steady_clock::now();
+  auto last = simulator.GetStats();
+  while (running) {
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    const auto stats = simulator.GetStats();
+    SPDLOG_INFO(
+        "mcu: {}/s, ref: {}/s, commands: {}/s, pings: {}, lost: {}, "
+        "corrupted: {}, overflow: {}, rx dropped: {}",
+        stats.mcu_sent - last.mcu_sent, stats.ref_sent - last.ref_sent,
+        stats.commands - last.commands, stats.pings, stats.bytes_lost,
+        stats.bytes_corrupted, stats.bytes_overflow, stats.rx_dropped);
+    last = stats;
+
+    const double elapsed = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    if (duration > 0. && elapsed >= duration) break;
+  }
+  simulator.Stop();
+  SPDLOG_WARN("***** Shuted Down MCU Simulator. *****");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,65 @@
+#include "bus_camera.hpp"
+
+#include "spdlog/spdlog.h"
+
+namespace {
+
+const int kWAIT_TIMEOUT = 100; /* ms，超时后检查线程是否需要退出 */
+
+}  // namespace
+
+void BusCamera::GrabPrepare() { return; }
+
+void BusCamera::GrabLoop() {
+  component::FrameReader::View view;
+  if (!reader_.Wait(view, kWAIT_TIMEOUT, true)) {
+    if (reader_.Closed()) {
+      SPDLOG_WARN("[GrabThread] Frame bus closed.");
+      grabing = false;
+    }
+    return;
+  }
+
+  cv::Mat frame;
+  if (!reader_.Copy(view, frame)) {
+    drop_count_.Add();
+    return;
+  }
+  std::lock_guard<std::mutex> lock(frame_stack_mutex_);
+  frame_stack_.push_front(frame);
+  grab_stamp_ = view.stamp;
+  grab_id_ = view.frame_id;
+  frame_signal_.Signal();
+}
+
+bool BusCamera::OpenPrepare(unsigned int index) {
+  SPDLOG_DEBUG("Open index: {}.", index);
+  return reader_.Open(BusName(index));
+}
+
+/**
+ * @brief Construct a new BusCamera object
+ *
+ */
+BusCamera::BusCamera() { SPDLOG_TRACE("Constructed."); }
+
+/**
+ * @brief Destroy the BusCamera object
+ *
+ */
+BusCamera::~BusCamera() {
+  Close();
+  SPDLOG_TRACE("Destructed.");
+}
+
+/**
+ * @brief 关闭相机设备
+ *
+ * @return int 状态代码
+ */
+int BusCamera::Close() {
+  grabing = false;
+  if (grab_thread_.joinable()) grab_thread_.join();
+  SPDLOG_DEBUG("Closed.");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "camera.hpp"
+#include "frame_bus.hpp"
+#include "opencv2/core/mat.hpp"
+
+/**
+ * @brief 从帧总线读取其他进程采集的帧，不占用相机设备
+ *
+ * 采集线程只取总线上最新的帧，读取过慢时跳过旧帧。帧号与发布方一致，
+ * 可据此从总线读取对应的检测结果。
+ */
+class BusCamera : public Camera {
+ private:
+  component::FrameReader reader_;
+
+  void GrabPrepare();
+  void GrabLoop();
+  bool OpenPrepare(unsigned int index);
+
+ public:
+  /**
+   * @brief Construct a new BusCamera object
+   *
+   */
+  BusCamera();
+
+  /**
+   * @brief Destroy the BusCamera object
+   *
+   */
+  ~BusCamera();
+
+  /**
+   * @brief 获取帧总线的读者，用于读取检测结果
+   *
+   * @return const component::FrameReader& 读者
+   */
+  const component::FrameReader &GetReader() const { return reader_; }
+
+  /**
+   * @brief 关闭相机设备
+   *
+   * @return int 状态代码
+   */
+  int Close();
+};
@@ -1,24 +1,56 @@
 #pragma once
 
+#include <chrono>
 #include <deque>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 
 #include "opencv2/core/mat.hpp"
 #include "opencv2/imgproc.hpp"
+#include "frame_bus.hpp"
+#include "metrics.hpp"
 #include "semaphore.hpp"
 #include "spdlog/spdlog.h"
+#include "thread_policy.hpp"
+#include "trace.hpp"
 
 class Camera {
  private:
   virtual void GrabPrepare() = 0;
   virtual void GrabLoop() = 0;
 
+  std::unique_ptr<component::FrameWriter> bus_;
+  uint64_t shared_id_ = 0;
+
+  /* 在采集线程中把最新的一帧复制到帧总线，不经过视觉主循环 */
+  void ShareFrame() {
+    cv::Mat frame;
+    std::chrono::steady_clock::time_point stamp;
+    {
+      std::lock_guard<std::mutex> lock(frame_stack_mutex_);
+      if (frame_stack_.empty() || grab_id_ == shared_id_) return;
+      frame = frame_stack_.front();
+      stamp = grab_stamp_;
+      shared_id_ = grab_id_;
+    }
+    TRACE_SPAN("share");
+    bus_->Publish(frame, stamp, shared_id_);
+  }
+
   void GrabThread() {
     SPDLOG_DEBUG("[GrabThread] Started.");
+    component::thread_policy::Apply("GrabThread");
     frame_signal_.Init();
     GrabPrepare();
-    while (grabing) GrabLoop();
+    while (grabing) {
+      /* 采集成功后 grab_id_ 才会增加，区间属于即将采集的一帧 */
+      component::trace::SetFrame(grab_id_ + 1);
+      TRACE_SPAN("grab");
+      GrabLoop();
+      if (bus_) ShareFrame();
+    }
 
     SPDLOG_DEBUG("[GrabThread] Stoped.");
   }
@@ -33,6 +65,12 @@ class Camera {
   std::thread grab_thread_;
   std::mutex frame_stack_mutex_;
   std::deque<cv::Mat> frame_stack_;
+  std::chrono::steady_clock::time_point grab_stamp_, frame_stamp_;
+  uint64_t grab_id_ = 0, frame_id_ = 0; /* 帧号，与 trace 中的帧号一致 */
+  component::metrics::Counter &frame_count_ =
+      component::metrics::GetCounter("camera.frames");
+  component::metrics::Counter &drop_count_ =
+      component::metrics::GetCounter("camera.dropped");
 
   /**
    * @brief 设置相机参数
@@ -47,6 +85,37 @@ class Camera {
     // TODO: 配置相机输入输出
   }
 
+  /**
+   * @brief 帧总线的名称，BusCamera 按索引号打开
+   *
+   * @param index 相机索引号
+   * @return std::string 共享内存名
+   */
+  static std::string BusName(unsigned int index) {
+    return "/qdu_rm_ai.cam" + std::to_string(index);
+  }
+
+  /**
+   * @brief 将采集到的帧发布到帧总线，供其他进程读取，需在 Open 之前调用
+   *
+   * @param name 共享内存名
+   * @param frame_bytes 原始图像的最大字节数
+   * @return true 创建成功
+   * @return false 创建失败
+   */
+  bool Share(const std::string &name, std::size_t frame_bytes) {
+    bus_ = std::make_unique<component::FrameWriter>(name, frame_bytes);
+    if (!bus_->Ok()) bus_.reset();
+    return bus_ != nullptr;
+  }
+
+  /**
+   * @brief 获取帧总线，用于发布检测结果，帧号与 frame_id_ 一致
+   *
+   * @return component::FrameWriter* 未调用 Share 时为空
+   */
+  component::FrameWriter *GetBus() { return bus_.get(); }
+
   /**
    * @brief 打开相机设备
    *
@@ -75,13 +144,31 @@ class Camera {
     std::lock_guard<std::mutex> lock(frame_stack_mutex_);
     if (!frame_stack_.empty()) {
       frame = frame_stack_.front();
+      frame_stamp_ = grab_stamp_;
+      frame_id_ = grab_id_;
+      /* 处理不及时被跳过的帧 */
+      drop_count_.Add(frame_stack_.size() - 1);
+      frame_count_.Add();
       frame_stack_.clear();
       cv::resize(frame, frame, cv::Size(frame_w_, frame_h_));
     } else {
       SPDLOG_ERROR("Empty frame stack!");
     }
+    /* 调用线程之后的处理都属于这一帧 */
+    component::trace::SetFrame(frame_id_);
     return frame;
   }
+
+  /**
+   * @brief 获取上一次 GetFrame 得到的图像的采集时刻
+   *
+   * @return std::chrono::steady_clock::time_point 采集时刻
+   */
+  std::chrono::steady_clock::time_point GetFrameStamp() {
+    std::lock_guard<std::mutex> lock(frame_stack_mutex_);
+    return frame_stamp_;
+  }
+
   /**
    * @brief 关闭相机设备
    *
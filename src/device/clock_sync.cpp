@@ -0,0 +1,105 @@
+#include "clock_sync.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "spdlog/spdlog.h"
+
+void ClockSync::Fit(const Sample &best) {
+  minima_.push_back(best);
+  if (minima_.size() > points_) minima_.pop_front();
+
+  Estimate estimate = estimate_.Load();
+  estimate.ref = minima_.back().host;
+  estimate.rtt = best.rtt;
+
+  /* 以最新的窗口为原点做最小二乘，避免大数相减损失精度 */
+  double mean_x = 0., mean_y = 0.;
+  for (auto &sample : minima_) {
+    mean_x += static_cast<double>(sample.host - estimate.ref);
+    mean_y += sample.offset;
+  }
+  mean_x /= minima_.size();
+  mean_y /= minima_.size();
+
+  double sxx = 0., sxy = 0.;
+  for (auto &sample : minima_) {
+    const double dx = (sample.host - estimate.ref) - mean_x;
+    sxx += dx * dx;
+    sxy += dx * (sample.offset - mean_y);
+  }
+  estimate.drift = sxx > 0. ? sxy / sxx : 0.;
+  estimate.offset = mean_y - estimate.drift * mean_x;
+  estimate_.Store(estimate);
+
+  SPDLOG_DEBUG("[ClockSync] offset: {}us, drift: {}ppm, rtt: {}us",
+               estimate.offset, estimate.drift * 1e6, estimate.rtt);
+}
+
+ClockSync::ClockSync(std::size_t window, std::size_t points)
+    : window_(std::max<std::size_t>(window, 1)),
+      points_(std::max<std::size_t>(points, 1)) {
+  SPDLOG_TRACE("Constructed.");
+}
+
+ClockSync::~ClockSync() { SPDLOG_TRACE("Destructed."); }
+
+int64_t ClockSync::Now() {
+  return ToMicroseconds(std::chrono::steady_clock::now());
+}
+
+int64_t ClockSync::ToMicroseconds(
+    std::chrono::steady_clock::time_point stamp) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             stamp.time_since_epoch())
+      .count();
+}
+
+bool ClockSync::Update(int64_t host_tx, int64_t mcu_rx, int64_t mcu_tx,
+                       int64_t host_rx) {
+  const int64_t rtt = (host_rx - host_tx) - (mcu_tx - mcu_rx);
+  if (host_rx < host_tx || mcu_tx < mcu_rx || rtt < 0) {
+    SPDLOG_WARN("[ClockSync] Invalid timestamps.");
+    return false;
+  }
+
+  Sample sample;
+  sample.host = host_tx + (host_rx - host_tx) / 2;
+  sample.offset = ((mcu_rx - host_tx) + (mcu_tx - host_rx)) / 2.;
+  sample.rtt = static_cast<double>(rtt);
+  window_samples_.push_back(sample);
+
+  Estimate estimate = estimate_.Load();
+  ++estimate.count;
+  estimate_.Store(estimate);
+
+  /* 第一次对时立即生效，之后每个窗口更新一次 */
+  if (estimate.count == 1 || window_samples_.size() >= window_) {
+    Fit(*std::min_element(
+        window_samples_.begin(), window_samples_.end(),
+        [](const Sample &a, const Sample &b) { return a.rtt < b.rtt; }));
+    window_samples_.clear();
+  }
+  return true;
+}
+
+bool ClockSync::Synced() const { return estimate_.Load().count > 0; }
+
+int64_t ClockSync::ToHost(int64_t mcu) const {
+  const Estimate estimate = estimate_.Load();
+  return estimate.ref +
+         std::llround((mcu - estimate.ref - estimate.offset) /
+                      (1. + estimate.drift));
+}
+
+int64_t ClockSync::ToMcu(int64_t host) const {
+  const Estimate estimate = estimate_.Load();
+  return host + std::llround(estimate.offset +
+                             estimate.drift * (host - estimate.ref));
+}
+
+std::chrono::microseconds ClockSync::OneWayDelay() const {
+  return std::chrono::microseconds(std::llround(estimate_.Load().rtt / 2.));
+}
+
+ClockSync::Estimate ClockSync::GetEstimate() const { return estimate_.Load(); }
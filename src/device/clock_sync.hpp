@@ -0,0 +1,142 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+#include "seqlock.hpp"
+
+/* 对时帧的 ID，需要与下位机固件一致 */
+const uint8_t kID_SYNC_PING = 0x5A;
+const uint8_t kID_SYNC_ECHO = 0x5B;
+
+/* 上位机发出的对时请求，时间单位为 us */
+struct __attribute__((packed)) SyncPingData {
+  uint32_t seq;
+  int64_t host_tx;
+};
+
+/* 下位机收到请求后立即回复，附上自己的收发时刻 */
+struct __attribute__((packed)) SyncEchoData {
+  uint32_t seq;
+  int64_t host_tx;
+  int64_t mcu_rx;
+  int64_t mcu_tx;
+};
+
+struct __attribute__((packed)) SyncPing {
+  uint8_t id;
+  SyncPingData data;
+  uint16_t crc16;
+};
+
+struct __attribute__((packed)) SyncEcho {
+  uint8_t id;
+  SyncEchoData data;
+  uint16_t crc16;
+};
+
+/**
+ * @brief 上位机与下位机的时钟同步
+ *
+ * 与 NTP 相同，由一次请求与回复的四个时刻估计时钟偏差和往返时延。每个窗口只
+ * 保留往返时延最小的一次，受排队影响最小；再对最近几个窗口的结果做线性拟合
+ * 得到漂移。所有时刻以 us 为单位，上位机时刻取自 steady_clock。
+ */
+class ClockSync {
+ public:
+  struct Estimate {
+    int64_t ref;    /* 拟合的参考时刻(上位机) */
+    double offset;  /* 参考时刻的偏差，下位机时刻减上位机时刻 */
+    double drift;   /* 偏差随上位机时间的变化率 */
+    double rtt;     /* 最近窗口中最小的往返时延 */
+    uint32_t count; /* 已采用的对时次数 */
+  };
+
+ private:
+  struct Sample {
+    int64_t host; /* 请求与回复的中点 */
+    double offset;
+    double rtt;
+  };
+
+  std::size_t window_, points_;
+  std::deque<Sample> window_samples_, minima_;
+  component::SeqLock<Estimate> estimate_;
+
+  void Fit(const Sample &best);
+
+ public:
+  /**
+   * @brief Construct a new ClockSync object
+   *
+   * @param window 每个窗口的对时次数
+   * @param points 参与漂移拟合的窗口数
+   */
+  ClockSync(std::size_t window = 16, std::size_t points = 16);
+
+  /**
+   * @brief Destroy the ClockSync object
+   *
+   */
+  ~ClockSync();
+
+  /**
+   * @brief 当前上位机时刻
+   *
+   * @return int64_t 时刻(us)
+   */
+  static int64_t Now();
+
+  /**
+   * @brief steady_clock 时刻转换为 us
+   *
+   * @param stamp 时刻
+   * @return int64_t 时刻(us)
+   */
+  static int64_t ToMicroseconds(std::chrono::steady_clock::time_point stamp);
+
+  /**
+   * @brief 加入一次对时结果，只能由一个线程调用
+   *
+   * @param host_tx 上位机发出请求的时刻
+   * @param mcu_rx 下位机收到请求的时刻
+   * @param mcu_tx 下位机发出回复的时刻
+   * @param host_rx 上位机收到回复的时刻
+   * @return true 结果有效
+   * @return false 时刻顺序不合理，已丢弃
+   */
+  bool Update(int64_t host_tx, int64_t mcu_rx, int64_t mcu_tx,
+              int64_t host_rx);
+
+  /**
+   * @brief 是否已经完成至少一次对时
+   *
+   */
+  bool Synced() const;
+
+  /**
+   * @brief 下位机时刻转换为上位机时刻
+   *
+   * @param mcu 下位机时刻(us)
+   * @return int64_t 上位机时刻(us)
+   */
+  int64_t ToHost(int64_t mcu) const;
+
+  /**
+   * @brief 上位机时刻转换为下位机时刻
+   *
+   * @param host 上位机时刻(us)
+   * @return int64_t 下位机时刻(us)
+   */
+  int64_t ToMcu(int64_t host) const;
+
+  /**
+   * @brief 单程传输时延的估计，取最小往返时延的一半
+   *
+   * @return std::chrono::microseconds 时延
+   */
+  std::chrono::microseconds OneWayDelay() const;
+
+  Estimate GetEstimate() const;
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "clock_sync.hpp"
+#include "crc16.hpp"
+#include "protocol.h"
+
+namespace codec {
+
+/* 没有帧头的帧，如下行指令 */
+constexpr int kNO_HEADER = -1;
+
+/**
+ * @brief 帧的编译期描述：[帧头] + 数据 + CRC16，CRC16 覆盖之前的所有字节
+ *
+ * 实例化时检查结构体的大小、成员偏移与对齐，协议结构体与描述不一致时无法
+ * 编译，不会在运行时收发错位的数据。
+ *
+ * @tparam Package 整帧的结构体，包含 data 与 crc16 成员
+ * @tparam Data 数据的结构体
+ * @tparam ID 帧头，kNO_HEADER 表示没有帧头
+ */
+template <typename Package, typename Data, int ID = kNO_HEADER>
+struct Packet {
+  typedef Data Payload;
+
+  static constexpr bool kHAS_HEADER = ID != kNO_HEADER;
+  static constexpr uint8_t kID = kHAS_HEADER ? ID : 0;
+  static constexpr std::size_t kHEADER = kHAS_HEADER ? sizeof(uint8_t) : 0;
+  static constexpr std::size_t kPAYLOAD = kHEADER;
+  static constexpr std::size_t kCRC = kPAYLOAD + sizeof(Data);
+  static constexpr std::size_t kSIZE = kCRC + sizeof(uint16_t);
+
+  static_assert(ID == kNO_HEADER || (ID >= 0 && ID <= UINT8_MAX),
+                "Header must fit in one byte.");
+  static_assert(std::is_trivially_copyable<Data>::value,
+                "Payload must be trivially copyable.");
+  static_assert(std::is_standard_layout<Package>::value,
+                "Package must be standard layout.");
+  static_assert(alignof(Package) == 1, "Package must be packed.");
+  static_assert(sizeof(Package) == kSIZE, "Unexpected package size.");
+  static_assert(offsetof(Package, data) == kPAYLOAD,
+                "Unexpected payload offset.");
+  static_assert(offsetof(Package, crc16) == kCRC, "Unexpected CRC offset.");
+  static_assert(std::is_same<decltype(Package::crc16), uint16_t>::value,
+                "CRC must be uint16_t.");
+};
+
+typedef Packet<Protocol_UpPackageMCU_t, Protocol_UpDataMCU_t, AI_ID_MCU>
+    McuPacket;
+typedef Packet<Protocol_UpPackageReferee_t, Protocol_UpDataReferee_t,
+               AI_ID_REF>
+    RefereePacket;
+typedef Packet<Protocol_DownPackage_t, Protocol_DownData_t> CommandPacket;
+typedef Packet<SyncPing, SyncPingData, kID_SYNC_PING> PingPacket;
+typedef Packet<SyncEcho, SyncEchoData, kID_SYNC_ECHO> EchoPacket;
+
+/* 对时帧由本仓库定义，固定其线上格式 */
+static_assert(PingPacket::kSIZE == 15, "Sync ping layout changed.");
+static_assert(EchoPacket::kSIZE == 31, "Sync echo layout changed.");
+
+/**
+ * @brief 一帧数据的只读视图，直接从缓冲区按偏移解码字段，不拷贝整帧
+ *
+ * 视图不持有数据，缓冲区在使用期间必须有效，如 FrameParser 的回调内。
+ *
+ * @tparam P 帧的描述
+ */
+template <typename P>
+class View {
+ public:
+  typedef typename P::Payload Payload;
+
+ private:
+  const uint8_t *frame_;
+
+ public:
+  /**
+   * @brief Construct a new View object
+   *
+   * @param frame 帧的起始地址，长度至少为 P::kSIZE
+   */
+  explicit View(const uint8_t *frame) : frame_(frame) {}
+
+  /**
+   * @brief 按数据内的偏移解码一个字段，越界时无法编译
+   *
+   * @tparam Offset 字段在数据内的偏移
+   * @tparam T 字段的类型
+   * @return T 字段的值
+   */
+  template <std::size_t Offset, typename T>
+  T Get() const {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Field must be trivially copyable.");
+    static_assert(Offset + sizeof(T) <= sizeof(Payload),
+                  "Field out of payload.");
+    T value;
+    std::memcpy(&value, frame_ + P::kPAYLOAD + Offset, sizeof(T));
+    return value;
+  }
+
+  /**
+   * @brief 解码整个数据
+   *
+   * @return Payload 数据
+   */
+  Payload GetPayload() const { return Get<0, Payload>(); }
+
+  uint16_t GetCRC() const {
+    uint16_t crc;
+    std::memcpy(&crc, frame_ + P::kCRC, sizeof(crc));
+    return crc;
+  }
+
+  /**
+   * @brief 检查帧头与校验
+   *
+   * @return true 帧完整
+   * @return false 帧头不符或校验失败
+   */
+  bool Verify() const {
+    if (P::kHAS_HEADER && frame_[0] != P::kID) return false;
+    return crc16::CRC16_Calc(frame_, P::kCRC, UINT16_MAX) == GetCRC();
+  }
+
+  const uint8_t *Data() const { return frame_; }
+};
+
+/**
+ * @brief 按成员名从视图中解码字段，偏移与类型均在编译期确定
+ *
+ * 例如 CODEC_GET(view, quat.q0)。
+ */
+#define CODEC_GET(view, member)                                          \
+  ((view).template Get<                                                  \
+      offsetof(typename std::decay_t<decltype(view)>::Payload, member),  \
+      decltype(std::declval<                                             \
+                   typename std::decay_t<decltype(view)>::Payload>()     \
+                   .member)>())
+
+/**
+ * @brief 将帧头、数据与校验写入预先分配的缓冲区
+ *
+ * @tparam P 帧的描述
+ * @param payload 数据
+ * @param out 缓冲区
+ * @param cap 缓冲区长度
+ * @return std::size_t 帧长，缓冲区不足时为 0
+ */
+template <typename P>
+std::size_t Encode(const typename P::Payload &payload, uint8_t *out,
+                   std::size_t cap) {
+  if (cap < P::kSIZE) return 0;
+  if (P::kHAS_HEADER) out[0] = P::kID;
+  std::memcpy(out + P::kPAYLOAD, &payload, sizeof(payload));
+  const uint16_t crc = crc16::CRC16_Calc(out, P::kCRC, UINT16_MAX);
+  std::memcpy(out + P::kCRC, &crc, sizeof(crc));
+  return P::kSIZE;
+}
+
+/**
+ * @brief 写入定长缓冲区，长度不足时无法编译
+ *
+ * @tparam P 帧的描述
+ * @tparam N 缓冲区长度
+ * @param payload 数据
+ * @param out 缓冲区
+ * @return std::size_t 帧长
+ */
+template <typename P, std::size_t N>
+std::size_t Encode(const typename P::Payload &payload,
+                   std::array<uint8_t, N> &out) {
+  static_assert(N >= P::kSIZE, "Buffer too small.");
+  return Encode<P>(payload, out.data(), N);
+}
+
+}  // namespace codec
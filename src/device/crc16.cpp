@@ -1,47 +1,163 @@
 #include "crc16.hpp"
 
+#include <array>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 namespace crc16 {
 
-static const uint16_t crc16_tab[256] = {
-    0x0000, 0x1189, 0x2312, 0x329b, 0x4624, 0x57ad, 0x6536, 0x74bf, 0x8c48,
-    0x9dc1, 0xaf5a, 0xbed3, 0xca6c, 0xdbe5, 0xe97e, 0xf8f7, 0x1081, 0x0108,
-    0x3393, 0x221a, 0x56a5, 0x472c, 0x75b7, 0x643e, 0x9cc9, 0x8d40, 0xbfdb,
-    0xae52, 0xdaed, 0xcb64, 0xf9ff, 0xe876, 0x2102, 0x308b, 0x0210, 0x1399,
-    0x6726, 0x76af, 0x4434, 0x55bd, 0xad4a, 0xbcc3, 0x8e58, 0x9fd1, 0xeb6e,
-    0xfae7, 0xc87c, 0xd9f5, 0x3183, 0x200a, 0x1291, 0x0318, 0x77a7, 0x662e,
-    0x54b5, 0x453c, 0xbdcb, 0xac42, 0x9ed9, 0x8f50, 0xfbef, 0xea66, 0xd8fd,
-    0xc974, 0x4204, 0x538d, 0x6116, 0x709f, 0x0420, 0x15a9, 0x2732, 0x36bb,
-    0xce4c, 0xdfc5, 0xed5e, 0xfcd7, 0x8868, 0x99e1, 0xab7a, 0xbaf3, 0x5285,
-    0x430c, 0x7197, 0x601e, 0x14a1, 0x0528, 0x37b3, 0x263a, 0xdecd, 0xcf44,
-    0xfddf, 0xec56, 0x98e9, 0x8960, 0xbbfb, 0xaa72, 0x6306, 0x728f, 0x4014,
-    0x519d, 0x2522, 0x34ab, 0x0630, 0x17b9, 0xef4e, 0xfec7, 0xcc5c, 0xddd5,
-    0xa96a, 0xb8e3, 0x8a78, 0x9bf1, 0x7387, 0x620e, 0x5095, 0x411c, 0x35a3,
-    0x242a, 0x16b1, 0x0738, 0xffcf, 0xee46, 0xdcdd, 0xcd54, 0xb9eb, 0xa862,
-    0x9af9, 0x8b70, 0x8408, 0x9581, 0xa71a, 0xb693, 0xc22c, 0xd3a5, 0xe13e,
-    0xf0b7, 0x0840, 0x19c9, 0x2b52, 0x3adb, 0x4e64, 0x5fed, 0x6d76, 0x7cff,
-    0x9489, 0x8500, 0xb79b, 0xa612, 0xd2ad, 0xc324, 0xf1bf, 0xe036, 0x18c1,
-    0x0948, 0x3bd3, 0x2a5a, 0x5ee5, 0x4f6c, 0x7df7, 0x6c7e, 0xa50a, 0xb483,
-    0x8618, 0x9791, 0xe32e, 0xf2a7, 0xc03c, 0xd1b5, 0x2942, 0x38cb, 0x0a50,
-    0x1bd9, 0x6f66, 0x7eef, 0x4c74, 0x5dfd, 0xb58b, 0xa402, 0x9699, 0x8710,
-    0xf3af, 0xe226, 0xd0bd, 0xc134, 0x39c3, 0x284a, 0x1ad1, 0x0b58, 0x7fe7,
-    0x6e6e, 0x5cf5, 0x4d7c, 0xc60c, 0xd785, 0xe51e, 0xf497, 0x8028, 0x91a1,
-    0xa33a, 0xb2b3, 0x4a44, 0x5bcd, 0x6956, 0x78df, 0x0c60, 0x1de9, 0x2f72,
-    0x3efb, 0xd68d, 0xc704, 0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232,
-    0x5ac5, 0x4b4c, 0x79d7, 0x685e, 0x1ce1, 0x0d68, 0x3ff3, 0x2e7a, 0xe70e,
-    0xf687, 0xc41c, 0xd595, 0xa12a, 0xb0a3, 0x8238, 0x93b1, 0x6b46, 0x7acf,
-    0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9, 0xf78f, 0xe606, 0xd49d,
-    0xc514, 0xb1ab, 0xa022, 0x92b9, 0x8330, 0x7bc7, 0x6a4e, 0x58d5, 0x495c,
-    0x3de3, 0x2c6a, 0x1ef1, 0x0f78};
-
-static inline uint16_t CRC16_Byte(uint16_t crc, const uint8_t data) {
-  return (crc >> 8) ^ crc16_tab[(crc ^ data) & 0xff];
+namespace {
+
+/* CRC-16/MCRF4XX，多项式 0x1021 的反射形式 */
+constexpr uint16_t kPOLY = 0x8408;
+constexpr uint32_t kPOLY_NORMAL = 0x11021;
+
+/* 短于此长度时折叠的开销大于收益 */
+constexpr std::size_t kCLMUL_MIN = 32;
+
+typedef std::array<std::array<uint16_t, 256>, 8> Tables;
+
+/* tab[0] 为逐字节查表；tab[k] 为一个字节之后再经过 k 个零字节的结果 */
+constexpr Tables MakeTables() {
+  Tables tab{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint16_t crc = i;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 1) ? (crc >> 1) ^ kPOLY : crc >> 1;
+    tab[0][i] = crc;
+  }
+  for (std::size_t k = 1; k < tab.size(); ++k)
+    for (std::size_t i = 0; i < 256; ++i)
+      tab[k][i] = (tab[k - 1][i] >> 8) ^ tab[0][tab[k - 1][i] & 0xff];
+  return tab;
 }
 
-uint16_t CRC16_Calc(const uint8_t *buf, std::size_t len, uint16_t crc) {
+constexpr Tables kTAB = MakeTables();
+
+static_assert(kTAB[0][0x01] == 0x1189 && kTAB[0][0x80] == 0x8408 &&
+                  kTAB[0][0xff] == 0x0f78,
+              "CRC16 table mismatch.");
+
+inline uint16_t CRC16_Byte(uint16_t crc, const uint8_t data) {
+  return (crc >> 8) ^ kTAB[0][(crc ^ data) & 0xff];
+}
+
+/* 按小端拼接，与主机字节序无关 */
+inline uint32_t Load32(const uint8_t *buf) {
+  return uint32_t(buf[0]) | uint32_t(buf[1]) << 8 | uint32_t(buf[2]) << 16 |
+         uint32_t(buf[3]) << 24;
+}
+
+#if defined(__x86_64__)
+
+/**
+ * @brief x^n mod P，按反射顺序放在 64 位的高位，作为折叠常数
+ *
+ */
+constexpr uint64_t FoldConstant(int n) {
+  uint32_t rem = 1;
+  for (int i = 0; i < n; ++i) {
+    rem <<= 1;
+    if (rem & 0x10000) rem ^= kPOLY_NORMAL;
+  }
+  uint64_t reflected = 0;
+  for (int d = 0; d < 16; ++d)
+    if (rem & (1u << d)) reflected |= uint64_t(1) << (63 - d);
+  return reflected;
+}
+
+/* 反射域的无进位乘积多出一个 x，常数的次数相应减一 */
+constexpr uint64_t kFOLD_LO = FoldConstant(128 + 64 - 1);
+constexpr uint64_t kFOLD_HI = FoldConstant(128 - 1);
+
+/**
+ * @brief 每次将 16 字节的状态乘以 x^128 折叠进下一块，余式与原数据同余，
+ * 最后 16 字节与不足一块的尾部查表计算
+ *
+ */
+__attribute__((target("pclmul,sse4.1"))) uint16_t FoldCLMUL(
+    const uint8_t *buf, std::size_t len, uint16_t crc) {
+  const __m128i fold = _mm_set_epi64x(kFOLD_HI, kFOLD_LO);
+
+  /* 反射 CRC 的初值等价于与前两个字节异或 */
+  __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf));
+  state = _mm_xor_si128(state, _mm_cvtsi32_si128(crc));
+  buf += 16, len -= 16;
+
+  while (len >= 16) {
+    const __m128i data =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf));
+    state = _mm_xor_si128(
+        data, _mm_xor_si128(_mm_clmulepi64_si128(state, fold, 0x00),
+                            _mm_clmulepi64_si128(state, fold, 0x11)));
+    buf += 16, len -= 16;
+  }
+
+  alignas(16) uint8_t tail[16];
+  _mm_store_si128(reinterpret_cast<__m128i *>(tail), state);
+  return CRC16_CalcSlicing8(buf, len, CRC16_CalcSlicing8(tail, 16, 0));
+}
+
+#endif
+
+/* 静态初始化期间也可能被调用，首次使用时检测 */
+bool DetectCLMUL() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#else
+  return false;
+#endif
+}
+
+}  // namespace
+
+uint16_t CRC16_CalcBytewise(const uint8_t *buf, std::size_t len,
+                            uint16_t crc) {
   while (len--) crc = CRC16_Byte(crc, *buf++);
   return crc;
 }
 
+uint16_t CRC16_CalcSlicing4(const uint8_t *buf, std::size_t len,
+                            uint16_t crc) {
+  for (; len >= 4; buf += 4, len -= 4) {
+    const uint32_t word = Load32(buf) ^ crc;
+    crc = kTAB[3][word & 0xff] ^ kTAB[2][(word >> 8) & 0xff] ^
+          kTAB[1][(word >> 16) & 0xff] ^ kTAB[0][word >> 24];
+  }
+  return CRC16_CalcBytewise(buf, len, crc);
+}
+
+uint16_t CRC16_CalcSlicing8(const uint8_t *buf, std::size_t len,
+                            uint16_t crc) {
+  for (; len >= 8; buf += 8, len -= 8) {
+    const uint32_t lo = Load32(buf) ^ crc, hi = Load32(buf + 4);
+    crc = kTAB[7][lo & 0xff] ^ kTAB[6][(lo >> 8) & 0xff] ^
+          kTAB[5][(lo >> 16) & 0xff] ^ kTAB[4][lo >> 24] ^
+          kTAB[3][hi & 0xff] ^ kTAB[2][(hi >> 8) & 0xff] ^
+          kTAB[1][(hi >> 16) & 0xff] ^ kTAB[0][hi >> 24];
+  }
+  return CRC16_CalcBytewise(buf, len, crc);
+}
+
+uint16_t CRC16_CalcCLMUL(const uint8_t *buf, std::size_t len, uint16_t crc) {
+#if defined(__x86_64__)
+  if (len >= kCLMUL_MIN && CRC16_HasCLMUL()) return FoldCLMUL(buf, len, crc);
+#endif
+  return CRC16_CalcSlicing8(buf, len, crc);
+}
+
+bool CRC16_HasCLMUL() {
+  static const bool has_clmul = DetectCLMUL();
+  return has_clmul;
+}
+
+uint16_t CRC16_Calc(const uint8_t *buf, std::size_t len, uint16_t crc) {
+  return CRC16_CalcCLMUL(buf, len, crc);
+}
+
 bool CRC16_Verify(const uint8_t *buf, std::size_t len) {
   if (len < 2) return false;
 
@@ -1,11 +1,37 @@
 #pragma once
 
 #include <cstdbool>
+#include <cstddef>
 #include <cstdint>
 
 namespace crc16 {
 
+/**
+ * @brief 计算 CRC16，按长度与 CPU 支持的指令自动选择实现
+ *
+ * @param buf 数据
+ * @param len 长度
+ * @param crc 初值，分段计算时传入上一段的结果
+ * @return uint16_t 校验值
+ */
 uint16_t CRC16_Calc(const uint8_t *buf, std::size_t len, uint16_t crc);
 bool CRC16_Verify(const uint8_t *buf, std::size_t len);
 
-}
+/* 各实现结果逐位一致，供测试与性能对比 */
+uint16_t CRC16_CalcBytewise(const uint8_t *buf, std::size_t len, uint16_t crc);
+uint16_t CRC16_CalcSlicing4(const uint8_t *buf, std::size_t len, uint16_t crc);
+uint16_t CRC16_CalcSlicing8(const uint8_t *buf, std::size_t len, uint16_t crc);
+
+/**
+ * @brief 使用无进位乘法折叠计算，数据较短或 CPU 不支持时退回 Slicing8
+ *
+ */
+uint16_t CRC16_CalcCLMUL(const uint8_t *buf, std::size_t len, uint16_t crc);
+
+/**
+ * @brief CPU 是否支持无进位乘法
+ *
+ */
+bool CRC16_HasCLMUL();
+
+}  // namespace crc16
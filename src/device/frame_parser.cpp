@@ -0,0 +1,107 @@
+#include "frame_parser.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "crc16.hpp"
+#include "spdlog/spdlog.h"
+
+const FrameParser::Spec* FrameParser::MatchHeader() const {
+  for (auto& spec : specs_) {
+    const std::size_t len = std::min(spec.header.size(), size_);
+    bool match = true;
+    for (std::size_t i = 0; match && i < len; ++i)
+      match = ring_[(head_ + i) % kCAPACITY] == spec.header[i];
+    if (match) return &spec;
+  }
+  return nullptr;
+}
+
+void FrameParser::Consume(std::size_t len) {
+  head_ = (head_ + len) % kCAPACITY;
+  size_ -= len;
+}
+
+FrameParser::FrameParser()
+    : head_(0), size_(0), frames_(0), crc_errors_(0), dropped_(0) {
+  SPDLOG_TRACE("Constructed.");
+}
+
+FrameParser::~FrameParser() { SPDLOG_TRACE("Destructed."); }
+
+void FrameParser::Register(const void* header, std::size_t header_len,
+                           std::size_t length, Handler handler) {
+  if (header_len == 0 || length < header_len + sizeof(uint16_t) ||
+      length > kCAPACITY) {
+    SPDLOG_ERROR("Invalid frame length: {}", length);
+    return;
+  }
+  const uint8_t* bytes = static_cast<const uint8_t*>(header);
+  specs_.push_back(
+      {std::vector<uint8_t>(bytes, bytes + header_len), length, handler});
+  if (frame_.size() < length) frame_.resize(length);
+}
+
+void FrameParser::Feed(const void* data, std::size_t len) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  if (len > kCAPACITY) {
+    dropped_ += len - kCAPACITY;
+    bytes += len - kCAPACITY;
+    len = kCAPACITY;
+  }
+  if (size_ + len > kCAPACITY) {
+    dropped_ += size_ + len - kCAPACITY;
+    Consume(size_ + len - kCAPACITY);
+  }
+
+  /* 写入位置可能回绕，最多分两段拷贝 */
+  const std::size_t tail = (head_ + size_) % kCAPACITY;
+  const std::size_t first = std::min(len, kCAPACITY - tail);
+  std::memcpy(ring_.data() + tail, bytes, first);
+  std::memcpy(ring_.data(), bytes + first, len - first);
+  size_ += len;
+}
+
+std::size_t FrameParser::Parse() {
+  std::size_t parsed = 0;
+  while (size_ > 0) {
+    const Spec* spec = MatchHeader();
+    if (spec == nullptr) {
+      Consume(1);
+      ++dropped_;
+      continue;
+    }
+    if (size_ < spec->header.size() || size_ < spec->length) break;
+
+    /* 未回绕的帧直接在缓冲区内校验并交给回调，回绕时才拷贝 */
+    const uint8_t* frame = ring_.data() + head_;
+    const std::size_t first = kCAPACITY - head_;
+    if (spec->length > first) {
+      std::memcpy(frame_.data(), frame, first);
+      std::memcpy(frame_.data() + first, ring_.data(), spec->length - first);
+      frame = frame_.data();
+    }
+
+    if (!crc16::CRC16_Verify(frame, spec->length)) {
+      /* 可能是数据中恰好出现了帧头，跳过一个字节重新同步 */
+      Consume(1);
+      ++crc_errors_;
+      ++dropped_;
+      continue;
+    }
+    Consume(spec->length);
+    ++frames_, ++parsed;
+    spec->handler(frame);
+  }
+  return parsed;
+}
+
+void FrameParser::Reset() { head_ = size_ = 0; }
+
+std::size_t FrameParser::Buffered() const { return size_; }
+
+std::size_t FrameParser::GetFrames() const { return frames_; }
+
+std::size_t FrameParser::GetCRCErrors() const { return crc_errors_; }
+
+std::size_t FrameParser::GetDropped() const { return dropped_; }
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/* 流式帧解析器 */
+class FrameParser {
+ public:
+  typedef std::function<void(const uint8_t* frame)> Handler;
+
+  static constexpr std::size_t kCAPACITY = 4096;
+
+ private:
+  struct Spec {
+    std::vector<uint8_t> header;
+    std::size_t length;
+    Handler handler;
+  };
+
+  std::array<uint8_t, kCAPACITY> ring_;
+  std::size_t head_, size_;
+  std::vector<Spec> specs_;
+  std::vector<uint8_t> frame_;
+
+  std::size_t frames_, crc_errors_, dropped_;
+
+  /**
+   * @brief 当前位置是否为某种帧的帧头
+   *
+   * @return const Spec* 匹配的帧，未匹配时为空
+   */
+  const Spec* MatchHeader() const;
+
+  /**
+   * @brief 丢弃缓冲区头部的数据
+   *
+   * @param len 长度
+   */
+  void Consume(std::size_t len);
+
+ public:
+  /**
+   * @brief Construct a new FrameParser object
+   *
+   */
+  FrameParser();
+
+  /**
+   * @brief Destroy the FrameParser object
+   *
+   */
+  ~FrameParser();
+
+  /**
+   * @brief 注册一种定长帧，帧以 header 开头、以覆盖整帧的 CRC16 结尾
+   *
+   * @param header 帧头地址
+   * @param header_len 帧头长度
+   * @param length 整帧长度
+   * @param handler 收到完整且校验通过的帧时的回调，帧可能直接指向内部缓冲区，
+   * 只在回调内有效
+   */
+  void Register(const void* header, std::size_t header_len,
+                std::size_t length, Handler handler);
+
+  /**
+   * @brief 写入收到的数据，缓冲区满时丢弃最旧的数据
+   *
+   * @param data 数据地址
+   * @param len 数据长度
+   */
+  void Feed(const void* data, std::size_t len);
+
+  /**
+   * @brief 解析缓冲区中所有完整的帧。帧头不匹配或校验失败时丢弃一个字节
+   * 重新寻找帧头，不完整的帧留到下次解析
+   *
+   * @return std::size_t 本次解析出的帧数
+   */
+  std::size_t Parse();
+
+  /**
+   * @brief 清空缓冲区
+   *
+   */
+  void Reset();
+
+  std::size_t Buffered() const;
+  std::size_t GetFrames() const;
+  std::size_t GetCRCErrors() const;
+  std::size_t GetDropped() const;
+};
@@ -1,9 +1,11 @@
 #include "hik_camera.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <exception>
 #include <string>
 #include <thread>
+#include <utility>
 
 #include "opencv2/imgproc.hpp"
 #include "opencv2/opencv.hpp"
@@ -33,11 +35,94 @@ static void PrintDeviceInfo(MV_CC_DEVICE_INFO *mv_dev_info) {
   }
 }
 
+namespace {
+
+/* GigE 与 USB3 Vision (SFNC) 中锁存设备时间戳的命令和结果节点 */
+const std::pair<const char *, const char *> kLATCH_NODES[] = {
+    {"GevTimestampControlLatch", "GevTimestampValue"},
+    {"TimestampLatch", "TimestampLatchValue"},
+};
+const int64_t kU3V_TICK_FREQ = 1000000000; /* USB3 Vision 的时间戳单位为 ns */
+/* 打开时连续对时的次数：第一次立即生效，之后凑满 ClockSync 的一个窗口 */
+const int kSYNC_ROUNDS = 1 + 16;
+const auto kSYNC_PERIOD = std::chrono::milliseconds(100);
+
+/* 分开整数与小数部分，避免 ns 级的时间戳乘 1e6 后溢出 */
+int64_t ToMicroseconds(int64_t ticks, int64_t freq) {
+  return ticks / freq * 1000000 + ticks % freq * 1000000 / freq;
+}
+
+}  // namespace
+
+bool HikCamera::PrepareSync() {
+  MVCC_INTVALUE_EX value;
+  for (const auto &nodes : kLATCH_NODES) {
+    if (MV_CC_SetCommandValue(camera_handle_, nodes.first) != MV_OK) continue;
+    if (MV_CC_GetIntValueEx(camera_handle_, nodes.second, &value) != MV_OK)
+      continue;
+    latch_cmd_ = nodes.first;
+    latch_value_ = nodes.second;
+    break;
+  }
+  if (latch_cmd_ == nullptr) {
+    SPDLOG_WARN("Device timestamp latch not supported, stamp on arrival.");
+    return false;
+  }
+
+  std::memset(&value, 0, sizeof(value));
+  if (MV_CC_GetIntValueEx(camera_handle_, "GevTimestampTickFrequency",
+                          &value) == MV_OK &&
+      value.nCurValue > 0)
+    tick_freq_ = value.nCurValue;
+  else
+    tick_freq_ = kU3V_TICK_FREQ;
+  SPDLOG_INFO("Device timestamp: {}, {} Hz.", latch_value_, tick_freq_);
+
+  for (int i = 0; i < kSYNC_ROUNDS; ++i) SyncClock();
+  return clock_.Synced();
+}
+
+void HikCamera::SyncClock() {
+  MVCC_INTVALUE_EX value;
+  const int64_t host_tx = ClockSync::Now();
+  if (MV_CC_SetCommandValue(camera_handle_, latch_cmd_) != MV_OK ||
+      MV_CC_GetIntValueEx(camera_handle_, latch_value_, &value) != MV_OK)
+    return;
+  const int64_t host_rx = ClockSync::Now();
+
+  /* 锁存时刻未知，视为在请求与读取的中点，误差由往返时延最小的一次限定 */
+  const int64_t dev = ToMicroseconds(value.nCurValue, tick_freq_);
+  clock_.Update(host_tx, dev, dev, host_rx);
+  next_sync_ = std::chrono::steady_clock::now() + kSYNC_PERIOD;
+}
+
+std::chrono::steady_clock::time_point HikCamera::ExposureStamp(
+    const MV_FRAME_OUT_INFO_EX &info,
+    std::chrono::steady_clock::time_point arrival) const {
+  const int64_t ticks =
+      static_cast<int64_t>(info.nDevTimeStampHigh) << 32 |
+      info.nDevTimeStampLow;
+  if (tick_freq_ <= 0 || ticks == 0 || !clock_.Synced()) return arrival;
+
+  /* 设备时间戳为曝光开始的时刻，加上半个曝光时间对齐到曝光中点 */
+  int64_t dev = ToMicroseconds(ticks, tick_freq_);
+  if (info.fExposureTime > 0.f)
+    dev += static_cast<int64_t>(info.fExposureTime / 2.f);
+  const std::chrono::steady_clock::time_point stamp(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::microseconds(clock_.ToHost(dev))));
+  /* 对时异常时不能晚于取到图像的时刻 */
+  return std::min(stamp, arrival);
+}
+
 void HikCamera::GrabPrepare() { std::memset(&raw_frame, 0, sizeof(raw_frame)); }
 
 void HikCamera::GrabLoop() {
   int err = MV_OK;
   err = MV_CC_GetImageBuffer(camera_handle_, &raw_frame, 1000);
+  /* 取到图像时已经过了曝光、读出与传输，改用设备时间戳换算出的曝光时刻 */
+  const auto stamp =
+      ExposureStamp(raw_frame.stFrameInfo, std::chrono::steady_clock::now());
   if (err == MV_OK) {
     SPDLOG_DEBUG("[GrabThread] FrameNum: {}.", raw_frame.stFrameInfo.nFrameNum);
   } else {
@@ -50,12 +135,18 @@ void HikCamera::GrabLoop() {
 
   std::lock_guard<std::mutex> lock(frame_stack_mutex_);
   frame_stack_.push_front(raw_mat.clone());
+  grab_stamp_ = stamp;
+  ++grab_id_;
   frame_signal_.Signal();
   if (nullptr != raw_frame.pBufAddr) {
     if ((err = MV_CC_FreeImageBuffer(camera_handle_, &raw_frame)) != MV_OK) {
       SPDLOG_ERROR("[GrabThread] FreeImageBuffer fail! err: {0:x}.", err);
     }
   }
+
+  /* 在两帧之间对时，不推迟本帧的发布；跟踪时钟漂移 */
+  if (latch_cmd_ != nullptr && std::chrono::steady_clock::now() >= next_sync_)
+    SyncClock();
 }
 
 bool HikCamera::OpenPrepare(unsigned int index) {
@@ -123,6 +214,8 @@ bool HikCamera::OpenPrepare(unsigned int index) {
     return false;
   }
 
+  PrepareSync();
+
   if ((err = MV_CC_StartGrabbing(camera_handle_)) != MV_OK) {
     SPDLOG_ERROR("StartGrabbing fail! err: {0:x}.", err);
     return false;
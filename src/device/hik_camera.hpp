@@ -1,11 +1,13 @@
 #pragma once
 
+#include <chrono>
 #include <deque>
 #include <mutex>
 #include <thread>
 
 #include "MvCameraControl.h"
 #include "camera.hpp"
+#include "clock_sync.hpp"
 #include "opencv2/core/mat.hpp"
 
 class HikCamera : public Camera {
@@ -14,10 +16,41 @@ class HikCamera : public Camera {
   void *camera_handle_ = nullptr;
   MV_FRAME_OUT raw_frame;
 
+  /* 相机时钟到 steady_clock 的换算，由锁存设备时间戳对时 */
+  ClockSync clock_;
+  int64_t tick_freq_ = 0; /* 设备时间戳的频率，0 表示不支持锁存 */
+  const char *latch_cmd_ = nullptr, *latch_value_ = nullptr;
+  std::chrono::steady_clock::time_point next_sync_;
+
   void GrabPrepare();
   void GrabLoop();
   bool OpenPrepare(unsigned int index);
 
+  /**
+   * @brief 查找锁存设备时间戳的节点，并读取时间戳频率
+   *
+   * @return true 支持锁存
+   * @return false 不支持，帧时刻退回到取图时刻
+   */
+  bool PrepareSync();
+
+  /**
+   * @brief 锁存一次设备时间戳，与前后的上位机时刻组成一次对时
+   *
+   */
+  void SyncClock();
+
+  /**
+   * @brief 由帧信息计算曝光中点对应的上位机时刻
+   *
+   * @param info 帧信息
+   * @param arrival 取到图像的时刻，无法换算时使用
+   * @return std::chrono::steady_clock::time_point 曝光中点
+   */
+  std::chrono::steady_clock::time_point ExposureStamp(
+      const MV_FRAME_OUT_INFO_EX &info,
+      std::chrono::steady_clock::time_point arrival) const;
+
   /**
    * @brief 相机初始化前的准备工作
    *
@@ -0,0 +1,98 @@
+#include "imu_history.hpp"
+
+#include <cmath>
+
+#include "spdlog/spdlog.h"
+
+namespace {
+
+/* 夹角很小时退化为线性插值，避免除以接近零的 sin */
+const double kSLERP_THRESH = 0.9995;
+
+void Slerp(const float *a, const float *b, double t, float *out) {
+  double dot = 0.;
+  for (int i = 0; i < 4; ++i) dot += a[i] * b[i];
+
+  /* q 与 -q 表示同一姿态，取较短的弧 */
+  const double sign = dot < 0. ? -1. : 1.;
+  dot *= sign;
+
+  double wa = 1. - t, wb = t;
+  if (dot < kSLERP_THRESH) {
+    const double theta = std::acos(dot), sin_theta = std::sin(theta);
+    wa = std::sin((1. - t) * theta) / sin_theta;
+    wb = std::sin(t * theta) / sin_theta;
+  }
+
+  double norm = 0.;
+  double q[4];
+  for (int i = 0; i < 4; ++i) {
+    q[i] = wa * a[i] + wb * sign * b[i];
+    norm += q[i] * q[i];
+  }
+  norm = std::sqrt(norm);
+  for (int i = 0; i < 4; ++i) out[i] = static_cast<float>(q[i] / norm);
+}
+
+}  // namespace
+
+bool ImuHistory::Read(uint64_t index, ImuSample &sample) const {
+  const Slot slot = slots_[index % kCAPACITY].Load();
+  if (slot.index != index) return false;
+  sample = slot.sample;
+  return true;
+}
+
+ImuHistory::ImuHistory() : count_(0) { SPDLOG_TRACE("Constructed."); }
+
+ImuHistory::~ImuHistory() { SPDLOG_TRACE("Destructed."); }
+
+void ImuHistory::Push(const ImuSample &sample) {
+  const uint64_t index = count_.load(std::memory_order_relaxed);
+  slots_[index % kCAPACITY].Store({index, sample});
+  count_.store(index + 1, std::memory_order_release);
+}
+
+bool ImuHistory::GetAt(std::chrono::steady_clock::time_point stamp,
+                       ImuSample &sample) const {
+  const uint64_t count = count_.load(std::memory_order_acquire);
+  if (count == 0) return false;
+
+  ImuSample newer, older;
+  if (!Read(count - 1, newer)) return false;
+  if (stamp >= newer.stamp) {
+    sample = newer;
+    return true;
+  }
+
+  /* 从新到旧查找第一个不晚于 stamp 的样本，通常只需几步 */
+  const uint64_t oldest = count > kCAPACITY ? count - kCAPACITY : 0;
+  for (uint64_t i = count - 1; i-- > oldest;) {
+    if (!Read(i, older)) break;
+    if (older.stamp <= stamp) {
+      const double span =
+          std::chrono::duration<double>(newer.stamp - older.stamp).count();
+      const double t =
+          span > 0.
+              ? std::chrono::duration<double>(stamp - older.stamp).count() /
+                    span
+              : 0.;
+      sample.stamp = stamp;
+      Slerp(older.q, newer.q, t, sample.q);
+      return true;
+    }
+    newer = older;
+  }
+  sample = newer;
+  return true;
+}
+
+bool ImuHistory::GetLatest(ImuSample &sample) const {
+  const uint64_t count = count_.load(std::memory_order_acquire);
+  return count > 0 && Read(count - 1, sample);
+}
+
+std::size_t ImuHistory::Size() const {
+  const uint64_t count = count_.load(std::memory_order_acquire);
+  return count < kCAPACITY ? count : kCAPACITY;
+}
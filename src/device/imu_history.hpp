@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "seqlock.hpp"
+
+/* 带主机时间戳的姿态，四元数按 w, x, y, z 排列 */
+struct ImuSample {
+  std::chrono::steady_clock::time_point stamp;
+  float q[4];
+};
+
+/**
+ * @brief 姿态历史
+ *
+ * 接收线程写入，其他线程按时间戳查询，读写都不加锁。
+ */
+class ImuHistory {
+ public:
+  static constexpr std::size_t kCAPACITY = 512;
+
+ private:
+  struct Slot {
+    uint64_t index; /* 写入序号，用于判断槽位是否已被覆盖 */
+    ImuSample sample;
+  };
+
+  std::array<component::SeqLock<Slot>, kCAPACITY> slots_;
+  std::atomic<uint64_t> count_;
+
+  /**
+   * @brief 读取第 index 个样本
+   *
+   * @return true 读取成功
+   * @return false 样本已被覆盖
+   */
+  bool Read(uint64_t index, ImuSample &sample) const;
+
+ public:
+  /**
+   * @brief Construct a new ImuHistory object
+   *
+   */
+  ImuHistory();
+
+  /**
+   * @brief Destroy the ImuHistory object
+   *
+   */
+  ~ImuHistory();
+
+  /**
+   * @brief 写入新样本，时间戳应单调递增，只能由一个线程调用
+   *
+   * @param sample 样本
+   */
+  void Push(const ImuSample &sample);
+
+  /**
+   * @brief 查询某一时刻的姿态，在前后两个样本间球面插值，超出范围时取最近的
+   * 样本
+   *
+   * @param stamp 时刻
+   * @param sample 插值结果
+   * @return true 查询成功
+   * @return false 没有样本
+   */
+  bool GetAt(std::chrono::steady_clock::time_point stamp,
+             ImuSample &sample) const;
+
+  /**
+   * @brief 取最新的样本
+   *
+   * @param sample 样本
+   * @return true 查询成功
+   * @return false 没有样本
+   */
+  bool GetLatest(ImuSample &sample) const;
+
+  std::size_t Size() const;
+};
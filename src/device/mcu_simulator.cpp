@@ -0,0 +1,253 @@
+#include "mcu_simulator.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "clock_sync.hpp"
+#include "codec.hpp"
+#include "spdlog/spdlog.h"
+
+namespace {
+
+const int64_t kMCU_OFFSET = 123456789; /* 模拟的下位机时钟偏差(us) */
+const double kMCU_DRIFT = 20e-6;
+const int kPOLL_TIMEOUT = 100; /* ms */
+const std::size_t kMAX_FRAME =
+    std::max(codec::CommandPacket::kSIZE, codec::PingPacket::kSIZE);
+
+}  // namespace
+
+void McuSimulator::ThreadTx() {
+  SPDLOG_DEBUG("[ThreadTx] Started.");
+
+  typedef std::chrono::steady_clock Clock;
+  const auto mcu_period = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1. / config_.mcu_rate));
+  const auto ref_period = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1. / config_.ref_rate));
+  std::uniform_real_distribution<double> jitter(0., config_.jitter_us);
+
+  Protocol_UpDataMCU_t mcu;
+  Protocol_UpDataReferee_t ref;
+  std::memset(&mcu, 0, sizeof(mcu));
+  std::memset(&ref, 0, sizeof(ref));
+  std::array<uint8_t, codec::McuPacket::kSIZE> mcu_buff;
+  std::array<uint8_t, codec::RefereePacket::kSIZE> ref_buff;
+
+  auto next_mcu = Clock::now(), next_ref = Clock::now();
+  while (running_) {
+    auto next = std::min(next_mcu, next_ref);
+    if (config_.jitter_us > 0.)
+      next += std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double, std::micro>(jitter(rng_)));
+    std::this_thread::sleep_until(next);
+
+    const auto now = Clock::now();
+    const double t = std::chrono::duration<double>(now - start_).count();
+    if (now >= next_mcu) {
+      const double yaw = config_.yaw_rate * t;
+      mcu.quat.q0 = std::cos(yaw / 2.);
+      mcu.quat.q1 = 0.f;
+      mcu.quat.q2 = 0.f;
+      mcu.quat.q3 = std::sin(yaw / 2.);
+      mcu.ball_speed = config_.speed;
+      Write(mcu_buff.data(), codec::Encode<codec::McuPacket>(mcu, mcu_buff));
+      ++mcu_sent_;
+
+      /* 落后超过一个周期时不再追赶 */
+      next_mcu += mcu_period;
+      if (next_mcu < now) next_mcu = now + mcu_period;
+    }
+    if (now >= next_ref) {
+      ref.team = AI_TEAM_RED;
+      ref.race = AI_RACE_RMUC;
+      ref.time = t;
+      Write(ref_buff.data(),
+            codec::Encode<codec::RefereePacket>(ref, ref_buff));
+      ++ref_sent_;
+
+      next_ref += ref_period;
+      if (next_ref < now) next_ref = now + ref_period;
+    }
+  }
+  SPDLOG_DEBUG("[ThreadTx] Stoped.");
+}
+
+void McuSimulator::ThreadRx() {
+  SPDLOG_DEBUG("[ThreadRx] Started.");
+
+  std::vector<uint8_t> buff;
+  uint8_t chunk[256];
+  std::array<uint8_t, codec::EchoPacket::kSIZE> echo_buff;
+
+  while (running_) {
+    struct pollfd pfd = {master_, POLLIN, 0};
+    if (poll(&pfd, 1, kPOLL_TIMEOUT) <= 0) continue;
+    const int64_t mcu_rx = McuNow();
+    const ssize_t len = read(master_, chunk, sizeof(chunk));
+    if (len <= 0) continue;
+    buff.insert(buff.end(), chunk, chunk + len);
+
+    /* 指令帧没有帧头，对时帧以 kID_SYNC_PING 开头，都以 CRC16 判断边界 */
+    std::size_t pos = 0;
+    while (pos < buff.size()) {
+      const uint8_t *head = buff.data() + pos;
+      const std::size_t remain = buff.size() - pos;
+
+      const codec::View<codec::PingPacket> ping(head);
+      if (remain >= codec::PingPacket::kSIZE && ping.Verify()) {
+        SyncEchoData echo;
+        echo.seq = CODEC_GET(ping, seq);
+        echo.host_tx = CODEC_GET(ping, host_tx);
+        echo.mcu_rx = mcu_rx;
+        echo.mcu_tx = McuNow();
+        const std::size_t size =
+            codec::Encode<codec::EchoPacket>(echo, echo_buff);
+        if (write(master_, echo_buff.data(), size) == ssize_t(size)) ++pings_;
+        pos += codec::PingPacket::kSIZE;
+        continue;
+      }
+
+      const codec::View<codec::CommandPacket> command(head);
+      if (remain >= codec::CommandPacket::kSIZE && command.Verify()) {
+        std::lock_guard<std::mutex> lock(mutex_command_);
+        last_command_ = command.GetPayload();
+        has_command_ = true;
+        ++commands_;
+        SPDLOG_DEBUG("[ThreadRx] Command {} at {}us.", commands_.load(),
+                     ClockSync::Now());
+        pos += codec::CommandPacket::kSIZE;
+        continue;
+      }
+
+      /* 数据不足以判断时等待后续字节 */
+      if (remain < kMAX_FRAME) break;
+      ++pos;
+      ++rx_dropped_;
+    }
+    buff.erase(buff.begin(), buff.begin() + pos);
+  }
+  SPDLOG_DEBUG("[ThreadRx] Stoped.");
+}
+
+void McuSimulator::Write(const void *data, std::size_t len) {
+  std::uniform_real_distribution<double> dice(0., 1.);
+  std::uniform_int_distribution<int> bit(0, 7);
+
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  std::vector<uint8_t> out;
+  out.reserve(len);
+  for (std::size_t i = 0; i < len; ++i) {
+    if (config_.byte_loss > 0. && dice(rng_) < config_.byte_loss) {
+      ++bytes_lost_;
+      continue;
+    }
+    uint8_t byte = bytes[i];
+    if (config_.corrupt > 0. && dice(rng_) < config_.corrupt) {
+      byte ^= 1 << bit(rng_);
+      ++bytes_corrupted_;
+    }
+    out.push_back(byte);
+  }
+
+  /* 从端没有读取时缓冲区会满，此时丢弃剩余数据而不阻塞 */
+  const ssize_t ret = write(master_, out.data(), out.size());
+  if (ret < static_cast<ssize_t>(out.size()))
+    bytes_overflow_ += out.size() - std::max<ssize_t>(ret, 0);
+}
+
+int64_t McuSimulator::McuNow() const {
+  const int64_t host = ClockSync::Now();
+  const int64_t start = ClockSync::ToMicroseconds(start_);
+  return host + kMCU_OFFSET +
+         static_cast<int64_t>((host - start) * kMCU_DRIFT);
+}
+
+McuSimulator::McuSimulator()
+    : master_(-1),
+      slave_(-1),
+      running_(false),
+      rng_(std::random_device()()),
+      mcu_sent_(0),
+      ref_sent_(0),
+      bytes_lost_(0),
+      bytes_corrupted_(0),
+      bytes_overflow_(0),
+      commands_(0),
+      pings_(0),
+      rx_dropped_(0),
+      has_command_(false) {
+  SPDLOG_TRACE("Constructed.");
+}
+
+McuSimulator::~McuSimulator() {
+  Stop();
+  SPDLOG_TRACE("Destructed.");
+}
+
+bool McuSimulator::Start(const SimulatorConfig &config) {
+  if (running_) Stop();
+  if (config.mcu_rate <= 0. || config.ref_rate <= 0.) {
+    SPDLOG_ERROR("Invalid rate: {}, {}", config.mcu_rate, config.ref_rate);
+    return false;
+  }
+  config_ = config;
+
+  master_ = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (master_ < 0 || grantpt(master_) != 0 || unlockpt(master_) != 0) {
+    SPDLOG_ERROR("Can't open pseudo terminal: {}", std::strerror(errno));
+    if (master_ >= 0) close(master_);
+    master_ = -1;
+    return false;
+  }
+  path_ = ptsname(master_);
+
+  /* 保持从端打开，没有其他进程打开时主端不会挂断；关闭回显，否则发出的数据
+   * 会被回送到主端 */
+  slave_ = open(path_.c_str(), O_RDWR | O_NOCTTY);
+  struct termios tty_cfg;
+  if (slave_ < 0 || tcgetattr(slave_, &tty_cfg) != 0) {
+    SPDLOG_ERROR("Can't open {}: {}", path_, std::strerror(errno));
+    Stop();
+    return false;
+  }
+  cfmakeraw(&tty_cfg);
+  tcsetattr(slave_, TCSANOW, &tty_cfg);
+  SPDLOG_INFO("Simulating on {}", path_);
+
+  start_ = std::chrono::steady_clock::now();
+  running_ = true;
+  thread_tx_ = std::thread(&McuSimulator::ThreadTx, this);
+  thread_rx_ = std::thread(&McuSimulator::ThreadRx, this);
+  return true;
+}
+
+void McuSimulator::Stop() {
+  running_ = false;
+  if (thread_tx_.joinable()) thread_tx_.join();
+  if (thread_rx_.joinable()) thread_rx_.join();
+  if (slave_ >= 0) close(slave_);
+  if (master_ >= 0) close(master_);
+  slave_ = master_ = -1;
+}
+
+const std::string &McuSimulator::GetPath() const { return path_; }
+
+bool McuSimulator::GetLastCommand(Protocol_DownData_t &command) {
+  std::lock_guard<std::mutex> lock(mutex_command_);
+  if (!has_command_) return false;
+  command = last_command_;
+  return true;
+}
+
+McuSimulator::Stats McuSimulator::GetStats() const {
+  return {mcu_sent_,       ref_sent_, bytes_lost_, bytes_corrupted_,
+          bytes_overflow_, commands_, pings_,      rx_dropped_};
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "protocol.h"
+
+/* 模拟器的发送频率与链路损伤 */
+struct SimulatorConfig {
+  double mcu_rate = 1000.; /* 下位机数据的频率(Hz) */
+  double ref_rate = 10.;   /* 裁判系统数据的频率(Hz) */
+  double byte_loss = 0.;   /* 每个字节丢失的概率 */
+  double corrupt = 0.;     /* 每个字节出错的概率 */
+  double jitter_us = 0.;   /* 发送时刻的随机抖动上限(us) */
+  double speed = 15.;      /* 弹速(m/s) */
+  double yaw_rate = 1.;    /* 云台匀速转动的角速度(rad/s) */
+};
+
+/**
+ * @brief 下位机与裁判系统模拟器
+ *
+ * 打开一对伪终端，在主端按协议以设定频率发送数据，同时接收上位机的指令并
+ * 回复对时请求。Robot 打开从端即可在没有硬件时运行。
+ */
+class McuSimulator {
+ public:
+  struct Stats {
+    uint64_t mcu_sent, ref_sent;
+    uint64_t bytes_lost, bytes_corrupted, bytes_overflow;
+    uint64_t commands, pings, rx_dropped;
+  };
+
+ private:
+  SimulatorConfig config_;
+  int master_, slave_;
+  std::string path_;
+  std::atomic<bool> running_;
+  std::thread thread_tx_, thread_rx_;
+  std::mt19937 rng_;
+  std::chrono::steady_clock::time_point start_;
+
+  std::atomic<uint64_t> mcu_sent_, ref_sent_;
+  std::atomic<uint64_t> bytes_lost_, bytes_corrupted_, bytes_overflow_;
+  std::atomic<uint64_t> commands_, pings_, rx_dropped_;
+
+  std::atomic<bool> has_command_;
+  Protocol_DownData_t last_command_;
+  std::mutex mutex_command_;
+
+  void ThreadTx();
+  void ThreadRx();
+
+  /**
+   * @brief 按设定的损伤写入主端
+   *
+   * @param data 数据
+   * @param len 长度
+   */
+  void Write(const void *data, std::size_t len);
+
+  /**
+   * @brief 模拟的下位机时钟，与上位机相差固定的偏差
+   *
+   * @return int64_t 时刻(us)
+   */
+  int64_t McuNow() const;
+
+ public:
+  /**
+   * @brief Construct a new McuSimulator object
+   *
+   */
+  McuSimulator();
+
+  /**
+   * @brief Destroy the McuSimulator object
+   *
+   */
+  ~McuSimulator();
+
+  /**
+   * @brief 打开伪终端并开始收发
+   *
+   * @param config 配置
+   * @return true 打开成功
+   * @return false 打开失败
+   */
+  bool Start(const SimulatorConfig &config);
+
+  /**
+   * @brief 停止收发并关闭伪终端
+   *
+   */
+  void Stop();
+
+  /**
+   * @brief 从端的路径，供 Robot 打开
+   *
+   * @return const std::string& 路径
+   */
+  const std::string &GetPath() const;
+
+  /**
+   * @brief 获取最后一条收到的指令
+   *
+   * @param command 指令
+   * @return true 已收到过指令
+   * @return false 没有收到指令
+   */
+  bool GetLastCommand(Protocol_DownData_t &command);
+
+  Stats GetStats() const;
+};
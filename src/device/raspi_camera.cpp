@@ -5,10 +5,13 @@ void RaspiCamera::GrabPrepare() { return; }
 void RaspiCamera::GrabLoop() {
   bool err = false;
   cam_ >> frame_;
+  const auto stamp = std::chrono::steady_clock::now();
   err = frame_.empty();
   if (!err) {
     std::lock_guard<std::mutex> lock(frame_stack_mutex_);
     frame_stack_.push_front(frame_);
+    grab_stamp_ = stamp;
+    ++grab_id_;
     frame_signal_.Signal();
   } else {
     SPDLOG_WARN("Empty frame");
@@ -0,0 +1,188 @@
+#include "replay_camera.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include "robot.hpp"
+#include "spdlog/spdlog.h"
+
+namespace {
+
+const char kRECORD_SUFFIX[] = ".rec";
+const double kDEFAULT_FPS = 30.; /* 视频未记录帧率时使用 */
+
+bool EndsWith(const std::string &str, const std::string &suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}  // namespace
+
+/* 帧在 GetFrame 中同步读取，采集线程直接退出 */
+void ReplayCamera::GrabPrepare() { grabing = false; }
+
+void ReplayCamera::GrabLoop() { return; }
+
+bool ReplayCamera::OpenPrepare(unsigned int index) {
+  is_record_ = EndsWith(path_, kRECORD_SUFFIX);
+  if (is_record_) {
+    if (!record_.Open(path_)) return false;
+    count_ = record_.Size(component::record::Type::kFRAME);
+  } else {
+    if (!video_.open(path_)) {
+      SPDLOG_ERROR("Can't open {}.", path_);
+      return false;
+    }
+    count_ = static_cast<std::size_t>(
+        std::max(0., video_.get(cv::CAP_PROP_FRAME_COUNT)));
+    double fps = video_.get(cv::CAP_PROP_FPS);
+    if (!(fps > 0.)) fps = kDEFAULT_FPS;
+    period_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(1. / fps));
+    if (index > 0) video_.set(cv::CAP_PROP_POS_FRAMES, index);
+  }
+  next_ = index;
+  finished_ = false;
+  started_ = false;
+
+  /* 先注入第一帧之前的数据，使裁判系统信息在取第一帧前可用 */
+  if (next_ < count_) FeedUntil(StampOf(next_));
+  SPDLOG_WARN("Replay {} : {} frames, start from {}.", path_, count_, index);
+  return true;
+}
+
+std::chrono::steady_clock::time_point ReplayCamera::StampOf(
+    std::size_t index) const {
+  if (is_record_)
+    return record_.At(component::record::Type::kFRAME, index).stamp;
+  return std::chrono::steady_clock::time_point(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          period_ * index));
+}
+
+bool ReplayCamera::Read(cv::Mat &frame, uint64_t &frame_id) {
+  if (is_record_) {
+    /* 原始数据直接指向只读的文件映射，复制后才能交给会写入图像的处理 */
+    cv::Mat view;
+    if (!record_.GetFrame(next_, view, frame_id)) return false;
+    frame = view.clone();
+  } else {
+    if (!video_.read(frame) || frame.empty()) return false;
+    frame_id = next_ + 1;
+  }
+  ++next_;
+  return true;
+}
+
+void ReplayCamera::Skip() {
+  if (!is_record_ && !video_.grab()) finished_ = true;
+  ++next_;
+  drop_count_.Add();
+}
+
+void ReplayCamera::FeedUntil(std::chrono::steady_clock::time_point stamp) {
+  if (robot_ == nullptr || !is_record_) return;
+
+  using component::record::Type;
+  Protocol_UpDataMCU_t mcu;
+  for (; mcu_next_ < record_.Size(Type::kMCU) &&
+         record_.At(Type::kMCU, mcu_next_).stamp < stamp;
+       ++mcu_next_) {
+    if (record_.Get(Type::kMCU, mcu_next_, mcu))
+      robot_->Feed(mcu, record_.At(Type::kMCU, mcu_next_).stamp);
+  }
+  Protocol_UpDataReferee_t referee;
+  for (; referee_next_ < record_.Size(Type::kREFEREE) &&
+         record_.At(Type::kREFEREE, referee_next_).stamp < stamp;
+       ++referee_next_) {
+    if (record_.Get(Type::kREFEREE, referee_next_, referee))
+      robot_->Feed(referee, record_.At(Type::kREFEREE, referee_next_).stamp);
+  }
+}
+
+/**
+ * @brief Construct a new ReplayCamera object
+ *
+ * @param path 录制文件（.rec）或视频文件的路径
+ * @param realtime 是否按录制时的间隔放出帧
+ */
+ReplayCamera::ReplayCamera(const std::string &path, bool realtime)
+    : path_(path), realtime_(realtime), period_(0), offset_(0) {
+  /* 未调用 Setup 时保持原始尺寸 */
+  frame_w_ = 0;
+  frame_h_ = 0;
+  SPDLOG_TRACE("Constructed.");
+}
+
+/**
+ * @brief Destroy the ReplayCamera object
+ *
+ */
+ReplayCamera::~ReplayCamera() {
+  Close();
+  SPDLOG_TRACE("Destructed.");
+}
+
+/**
+ * @brief 读取下一帧，帧号与采集时刻为录制时的值
+ *
+ * @return cv::Mat 图像，回放结束后为空
+ */
+cv::Mat ReplayCamera::GetFrame() {
+  cv::Mat frame;
+  if (finished_ || (is_record_ && next_ >= count_)) {
+    if (!finished_) SPDLOG_WARN("Replay finished after {} frames.", next_);
+    finished_ = true;
+    return frame;
+  }
+
+  if (realtime_) {
+    const auto now = std::chrono::steady_clock::now();
+    if (!started_) {
+      offset_ = now - StampOf(next_);
+      started_ = true;
+    }
+    /* 处理不及时时跳过已经过时的帧，与相机的行为一致 */
+    while (!finished_ && (count_ == 0 || next_ + 1 < count_) &&
+           StampOf(next_ + 1) + offset_ <= now)
+      Skip();
+    std::this_thread::sleep_until(StampOf(next_) + offset_);
+  }
+
+  const auto stamp = StampOf(next_);
+  uint64_t frame_id = 0;
+  if (finished_ || !Read(frame, frame_id)) {
+    SPDLOG_WARN("Replay finished after {} frames.", next_);
+    finished_ = true;
+    return cv::Mat();
+  }
+  FeedUntil(next_ < count_ ? StampOf(next_)
+                           : std::chrono::steady_clock::time_point::max());
+
+  if (frame_w_ > 0 && frame_h_ > 0 &&
+      frame.size() != cv::Size(frame_w_, frame_h_))
+    cv::resize(frame, frame, cv::Size(frame_w_, frame_h_));
+  {
+    std::lock_guard<std::mutex> lock(frame_stack_mutex_);
+    frame_stamp_ = stamp;
+    frame_id_ = frame_id;
+  }
+  frame_count_.Add();
+  /* 调用线程之后的处理都属于这一帧 */
+  component::trace::SetFrame(frame_id);
+  return frame;
+}
+
+/**
+ * @brief 关闭相机设备
+ *
+ * @return int 状态代码
+ */
+int ReplayCamera::Close() {
+  grabing = false;
+  if (grab_thread_.joinable()) grab_thread_.join();
+  video_.release();
+  finished_ = true;
+  SPDLOG_DEBUG("Closed.");
+  return EXIT_SUCCESS;
+}
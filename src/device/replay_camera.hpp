@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include "camera.hpp"
+#include "opencv2/core/mat.hpp"
+#include "opencv2/videoio.hpp"
+#include "record.hpp"
+
+class Robot;
+
+/**
+ * @brief 回放录制的文件或视频，代替相机输入
+ *
+ * 默认不限速：GetFrame 同步读取下一帧，不经过采集线程，也不会跳帧，同一
+ * 文件每次回放的输入完全相同，可用于比对输出和测量吞吐量。按原速回放时按
+ * 录制时的间隔放出帧，处理过慢时与相机一样跳过旧帧并计数。
+ *
+ * 回放 Writer 录制的文件时，可把其中的下位机与裁判系统数据注入 Robot：
+ * 每取一帧，注入采集时刻早于下一帧的全部数据，与实际运行时的到达顺序一致。
+ * 视频文件没有遥测数据，时刻由帧率推算。
+ */
+class ReplayCamera : public Camera {
+ private:
+  std::string path_;
+  bool realtime_;
+  Robot *robot_ = nullptr;
+
+  component::record::Reader record_;
+  cv::VideoCapture video_;
+  bool is_record_ = false, finished_ = false;
+  std::size_t next_ = 0, count_ = 0;
+  std::size_t mcu_next_ = 0, referee_next_ = 0;
+  std::chrono::nanoseconds period_; /* 视频的帧间隔 */
+  /* 原速回放时当前时刻与录制时刻的差 */
+  std::chrono::steady_clock::duration offset_;
+  bool started_ = false;
+
+  void GrabPrepare();
+  void GrabLoop();
+  bool OpenPrepare(unsigned int index);
+
+  std::chrono::steady_clock::time_point StampOf(std::size_t index) const;
+  bool Read(cv::Mat &frame, uint64_t &frame_id);
+  void Skip();
+  void FeedUntil(std::chrono::steady_clock::time_point stamp);
+
+ public:
+  /**
+   * @brief Construct a new ReplayCamera object
+   *
+   * @param path 录制文件（.rec）或视频文件的路径
+   * @param realtime 是否按录制时的间隔放出帧
+   */
+  ReplayCamera(const std::string &path, bool realtime = false);
+
+  /**
+   * @brief Destroy the ReplayCamera object
+   *
+   */
+  ~ReplayCamera();
+
+  /**
+   * @brief 设置注入遥测数据的 Robot，需在 Open 之前调用，Robot 不应调用 Init
+   *
+   * @param robot 为空时不注入
+   */
+  void SetRobot(Robot *robot) { robot_ = robot; }
+
+  /**
+   * @brief 读取下一帧，帧号与采集时刻为录制时的值
+   *
+   * @return cv::Mat 图像，回放结束后为空
+   */
+  cv::Mat GetFrame();
+
+  /**
+   * @brief 是否已回放到文件末尾
+   *
+   * @return true 已结束
+   * @return false 未结束
+   */
+  bool Finished() const { return finished_; }
+
+  /**
+   * @brief 文件中的总帧数
+   *
+   * @return std::size_t 帧数，部分视频格式只是估计值
+   */
+  std::size_t Count() const { return count_; }
+
+  /**
+   * @brief 关闭相机设备
+   *
+   * @return int 状态代码
+   */
+  int Close();
+};
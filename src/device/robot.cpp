@@ -1,82 +1,170 @@
 #include "robot.hpp"
 
+#include <algorithm>
+#include <array>
+
+#include "codec.hpp"
+#include "metrics.hpp"
 #include "spdlog/spdlog.h"
+#include "thread_policy.hpp"
+#include "trace.hpp"
 
 namespace {
 
 const double kFACTOR = 0.04;
+const int kPOLL_TIMEOUT = 100; /* ms，超时后检查线程是否需要退出 */
+const std::size_t kRECV_BUFF = 256;
+const std::chrono::microseconds kMIN_GAP(2000);
+const std::chrono::milliseconds kSYNC_PERIOD(100);
+
+component::Euler QuatToEuler(const cv::Quatf &q) {
+  cv::Vec3d vec = q.toEulerAngles(cv::QuatEnum::EulerAnglesType::INT_XYZ);
+  component::Euler euler;
+  euler.pitch = vec[0];
+  euler.roll = vec[1];
+  euler.yaw = vec[2];
+  SPDLOG_DEBUG("P : {}, R : {}, Y : {}", euler.pitch, euler.roll, euler.yaw);
+  return euler;
+}
 
 }  // namespace
 
 void Robot::ThreadRecv() {
   SPDLOG_DEBUG("[ThreadRecv] Started.");
-
-  Protocol_ID_t id;
-  Protocol_UpPackageReferee_t ref;
-  Protocol_UpPackageMCU_t robot;
-
+  component::thread_policy::Apply("ThreadRecv");
+
+  std::chrono::steady_clock::time_point recv_stamp;
+  FrameParser parser;
+  parser.Register(&codec::RefereePacket::kID, sizeof(uint8_t),
+                  codec::RefereePacket::kSIZE, [&](const uint8_t *frame) {
+                    Feed(codec::View<codec::RefereePacket>(frame).GetPayload(),
+                         recv_stamp);
+                  });
+  parser.Register(&codec::McuPacket::kID, sizeof(uint8_t),
+                  codec::McuPacket::kSIZE, [&](const uint8_t *frame) {
+                    /* 减去单程传输时延，得到下位机采样的时刻 */
+                    Feed(codec::View<codec::McuPacket>(frame).GetPayload(),
+                         recv_stamp - clock_.OneWayDelay());
+                  });
+  parser.Register(&codec::EchoPacket::kID, sizeof(uint8_t),
+                  codec::EchoPacket::kSIZE, [&](const uint8_t *frame) {
+                    const codec::View<codec::EchoPacket> echo(frame);
+                    clock_.Update(CODEC_GET(echo, host_tx),
+                                  CODEC_GET(echo, mcu_rx),
+                                  CODEC_GET(echo, mcu_tx),
+                                  ClockSync::ToMicroseconds(recv_stamp));
+                  });
+
+  auto &rx_frames = component::metrics::GetCounter("serial.rx_frames");
+  auto &crc_errors = component::metrics::GetCounter("serial.crc_errors");
+  auto &rx_dropped = component::metrics::GetCounter("serial.rx_dropped");
+  std::size_t frames = 0, errors = 0, dropped = 0;
+
+  uint8_t buff[kRECV_BUFF];
   while (thread_continue) {
-    serial_.Recv(&id, sizeof(id));
-
-    if (AI_ID_REF == id) {
-      serial_.Recv(&ref, sizeof(ref));
-
-      if (crc16::CRC16_Verify((uint8_t *)&ref, sizeof(ref))) {
-        mutex_ref_.lock();
-        std::memcpy(&ref_, &(ref.data), sizeof(ref_));
-        mutex_ref_.unlock();
-      }
-    } else if (AI_ID_MCU == id) {
-      serial_.Recv(&robot, sizeof(robot));
+    if (!serial_.Poll(kPOLL_TIMEOUT)) continue;
+    recv_stamp = std::chrono::steady_clock::now();
 
-      if (crc16::CRC16_Verify((uint8_t *)&robot, sizeof(robot))) {
-        mutex_mcu_.lock();
-        std::memcpy(&mcu_, &(robot.data), sizeof(mcu_));
-        mutex_mcu_.unlock();
-      }
+    std::size_t len;
+    while ((len = serial_.Recv(buff, sizeof(buff))) > 0) {
+      parser.Feed(buff, len);
+      parser.Parse();
     }
+    /* 解析器的统计是累计值，只上报增量 */
+    rx_frames.Add(parser.GetFrames() - frames);
+    crc_errors.Add(parser.GetCRCErrors() - errors);
+    rx_dropped.Add(parser.GetDropped() - dropped);
+    frames = parser.GetFrames();
+    errors = parser.GetCRCErrors();
+    dropped = parser.GetDropped();
   }
-  SPDLOG_DEBUG("[ThreadRecv] Stoped.");
+  SPDLOG_DEBUG("[ThreadRecv] Stoped. frames: {}, crc errors: {}, dropped: {}",
+               parser.GetFrames(), parser.GetCRCErrors(), parser.GetDropped());
 }
 
 void Robot::ThreadTrans() {
   SPDLOG_DEBUG("[ThreadTrans] Started.");
+  component::thread_policy::Apply("ThreadTrans");
+
+  Protocol_DownData_t data;
+  SyncPingData ping = {0, 0};
+  std::array<uint8_t, codec::CommandPacket::kSIZE> command_buff;
+  std::array<uint8_t, codec::PingPacket::kSIZE> ping_buff;
 
-  Protocol_DownPackage_t command;
+  std::chrono::steady_clock::time_point stamp, next, next_ping;
+  std::chrono::microseconds latency(0), max_latency(0);
+  std::size_t sent = 0;
+  auto &tx_packets = component::metrics::GetCounter("serial.tx_packets");
+  auto &tx_latency = component::metrics::GetHistogram("serial.latency");
+  /* 按发送间隔等待后实际唤醒的延迟，反映调度抖动 */
+  auto &wakeup = component::metrics::GetHistogram("serial.wakeup");
 
   while (thread_continue) {
-    bool is_empty = true;
-    mutex_command_.lock();
-    if (commandq_.size() > 0) {
-      command.data = commandq_.back();
-      is_empty = false;
-      commandq_.clear();
+    const auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+        next_ping - std::chrono::steady_clock::now());
+    const int timeout =
+        clock_sync_ ? std::clamp<int>(wait.count(), 0, kPOLL_TIMEOUT)
+                    : kPOLL_TIMEOUT;
+
+    if (command_.Wait(data, timeout, &stamp)) {
+      /* 发送间隔不足时等待，期间到达的新指令覆盖旧指令 */
+      if (std::chrono::steady_clock::now() < next) {
+        std::this_thread::sleep_until(next);
+        wakeup.Record(std::chrono::steady_clock::now() - next);
+        command_.TryTake(data, &stamp);
+      }
+      TRACE_SPAN("serial");
+      serial_.Trans(command_buff.data(),
+                    codec::Encode<codec::CommandPacket>(data, command_buff));
+
+      const auto now = std::chrono::steady_clock::now();
+      next = now + min_gap_.load();
+      const auto cost =
+          std::chrono::duration_cast<std::chrono::microseconds>(now - stamp);
+      latency += cost;
+      max_latency = std::max(max_latency, cost);
+      ++sent;
+      tx_packets.Add();
+      tx_latency.Record(now - stamp);
     }
-    mutex_command_.unlock();
-    if (!is_empty) {
-      command.crc16 = crc16::CRC16_Calc((uint8_t *)&command.data,
-                                        sizeof(command.data), UINT16_MAX);
-      serial_.Trans((char *)&command, sizeof(command));
-      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+    if (clock_sync_ && std::chrono::steady_clock::now() >= next_ping) {
+      /* 对时请求与指令共用最小发送间隔 */
+      std::this_thread::sleep_until(next);
+      ++ping.seq;
+      ping.host_tx = ClockSync::Now();
+      serial_.Trans(ping_buff.data(),
+                    codec::Encode<codec::PingPacket>(ping, ping_buff));
+
+      const auto now = std::chrono::steady_clock::now();
+      next = now + min_gap_.load();
+      next_ping = now + kSYNC_PERIOD;
     }
   }
-  SPDLOG_DEBUG("[ThreadTrans] Stoped.");
+  SPDLOG_DEBUG("[ThreadTrans] Stoped. sent: {}, latency avg: {}us, max: {}us",
+               sent, sent > 0 ? latency.count() / sent : 0,
+               max_latency.count());
 }
 
-Robot::Robot() { SPDLOG_TRACE("Constructed."); }
+Robot::Robot()
+    : min_gap_(kMIN_GAP), clock_sync_(false), record_(nullptr) {
+  SPDLOG_TRACE("Constructed.");
+}
 
-Robot::Robot(const std::string &dev_path) {
+Robot::Robot(const std::string &dev_path)
+    : min_gap_(kMIN_GAP), clock_sync_(false), record_(nullptr) {
   Init(dev_path);
 
   SPDLOG_TRACE("Constructed.");
 }
 
 Robot::~Robot() {
-  serial_.Close();
-
   thread_continue = false;
-  thread_recv_.join();
-  thread_trans_.join();
+  command_.Interrupt();
+  if (thread_recv_.joinable()) thread_recv_.join();
+  if (thread_trans_.joinable()) thread_trans_.join();
+
+  serial_.Close();
   SPDLOG_TRACE("Destructed.");
 }
 
@@ -93,50 +181,54 @@ void Robot::Init(const std::string &dev_path) {
 }
 
 game::Team Robot::GetEnemyTeam() {
-  if (ref_.team == AI_TEAM_RED)
+  const auto ref = ref_.Load();
+  if (ref.team == AI_TEAM_RED)
     return game::Team::kBLUE;
-  else if (ref_.team == AI_TEAM_BLUE)
+  else if (ref.team == AI_TEAM_BLUE)
     return game::Team::kRED;
   return game::Team::kUNKNOWN;
 }
 
 game::Race Robot::GetRace() {
-  if (ref_.race == AI_RACE_RMUC)
+  const auto ref = ref_.Load();
+  if (ref.race == AI_RACE_RMUC)
     return game::Race::kRMUC;
-  else if (ref_.race == AI_RACE_RMUT)
+  else if (ref.race == AI_RACE_RMUT)
     return game::Race::kRMUT;
-  else if (ref_.race == AI_RACE_RMUL1)
+  else if (ref.race == AI_RACE_RMUL1)
     return game::Race::kRMUL1;
-  else if (ref_.race == AI_RACE_RMUL3)
+  else if (ref.race == AI_RACE_RMUL3)
     return game::Race::kRMUL3;
   return game::Race::kUNKNOWN;
 }
 
-double Robot::GetTime() { return ref_.time; }
+double Robot::GetTime() { return ref_.Load().time; }
 
 game::RFID Robot::GetRFID() {
-  if (ref_.rfid == AI_RFID_BUFF)
+  const auto ref = ref_.Load();
+  if (ref.rfid == AI_RFID_BUFF)
     return game::RFID::kBUFF;
-  else if (ref_.rfid == AI_RFID_SNIP)
+  else if (ref.rfid == AI_RFID_SNIP)
     return game::RFID::kSNIPE;
   return game::RFID::kUNKNOWN;
 }
 
-int Robot::GetBaseHP() { return ref_.base_hp; }
+int Robot::GetBaseHP() { return ref_.Load().base_hp; }
 
-int Robot::GetSentryHP() { return ref_.sentry_hp; }
+int Robot::GetSentryHP() { return ref_.Load().sentry_hp; }
 
-int Robot::GetBalletRemain() { return ref_.ballet_remain; }
+int Robot::GetBalletRemain() { return ref_.Load().ballet_remain; }
 
 game::Arm Robot::GetArm() {
+  const auto ref = ref_.Load();
   int num = 0;
   for (int i = 0; i < 6; i++) {
-    num += ((ref_.arm >> (i)) & 0x01);
+    num += ((ref.arm >> (i)) & 0x01);
   }
   if (num != 1)
     return game::Arm::kUNKNOWN;
   else
-    switch (ref_.arm & 0xFF) {
+    switch (ref.arm & 0xFF) {
       case AI_ARM_INFANTRY:
         return game::Arm::kINFANTRY;
       case AI_ARM_HERO:
@@ -157,27 +249,34 @@ game::Arm Robot::GetArm() {
 }
 
 component::Euler Robot::GetEuler() {
-  cv::Quatf q(mcu_.quat.q0, mcu_.quat.q1, mcu_.quat.q2, mcu_.quat.q3);
-  cv::Vec3d vec = q.toEulerAngles(cv::QuatEnum::EulerAnglesType::INT_XYZ);
-  component::Euler euler;
-  euler.pitch = vec[0];
-  euler.roll = vec[1];
-  euler.yaw = vec[2];
-  SPDLOG_DEBUG("P : {}, R : {}, Y : {}", euler.pitch, euler.roll, euler.yaw);
-  return euler;
+  const auto mcu = mcu_.Load();
+  cv::Quatf q(mcu.quat.q0, mcu.quat.q1, mcu.quat.q2, mcu.quat.q3);
+  return QuatToEuler(q);
+}
+
+component::Euler Robot::GetEulerAt(
+    std::chrono::steady_clock::time_point stamp) {
+  ImuSample sample;
+  if (!imu_.GetAt(stamp, sample)) return GetEuler();
+  cv::Quatf q(sample.q[0], sample.q[1], sample.q[2], sample.q[3]);
+  return QuatToEuler(q);
 }
 
 cv::Mat Robot::GetRotMat() {
-  cv::Quatf q(mcu_.quat.q0, mcu_.quat.q1, mcu_.quat.q2, mcu_.quat.q3);
+  const auto mcu = mcu_.Load();
+  cv::Quatf q(mcu.quat.q0, mcu.quat.q1, mcu.quat.q2, mcu.quat.q3);
   return cv::Mat(q.toRotMat3x3(), true);
 }
 
-float Robot::GetBalletSpeed() { return mcu_.ball_speed; }
+float Robot::GetBalletSpeed() { return mcu_.Load().ball_speed; }
 
-float Robot::GetChassicSpeed() { return mcu_.chassis_speed; }
+float Robot::GetChassicSpeed() { return mcu_.Load().chassis_speed; }
 
 void Robot::Pack(Protocol_DownData_t &data, double distance) {
-  double w = mcu_.quat.q0, x = mcu_.quat.q1, y = mcu_.quat.q2, z = mcu_.quat.q3;
+  TRACE_SPAN("pack");
+  METRICS_LATENCY("pack");
+  const auto mcu = mcu_.Load();
+  double w = mcu.quat.q0, x = mcu.quat.q1, y = mcu.quat.q2, z = mcu.quat.q3;
   component::Euler euler;
 
   const float sinr_cosp = 2.0f * (w * x + y * z);
@@ -205,7 +304,35 @@ void Robot::Pack(Protocol_DownData_t &data, double distance) {
   else
     data.notice |= AI_NOTICE_FIRE;
 
-  mutex_command_.lock();
-  commandq_.emplace_back(data);
-  mutex_command_.unlock();
+  command_.Post(data);
+  if (auto record = record_.load())
+    record->Write(component::record::Type::kCOMMAND,
+                  std::chrono::steady_clock::now(), data);
+}
+
+void Robot::Feed(const Protocol_UpDataMCU_t &data,
+                 std::chrono::steady_clock::time_point stamp) {
+  mcu_.Store(data);
+  imu_.Push({stamp, {data.quat.q0, data.quat.q1, data.quat.q2, data.quat.q3}});
+  if (auto record = record_.load())
+    record->Write(component::record::Type::kMCU, stamp, data);
 }
+
+void Robot::Feed(const Protocol_UpDataReferee_t &data,
+                 std::chrono::steady_clock::time_point stamp) {
+  ref_.Store(data);
+  if (auto record = record_.load())
+    record->Write(component::record::Type::kREFEREE, stamp, data);
+}
+
+bool Robot::TakeCommand(Protocol_DownData_t &data) {
+  return command_.TryTake(data);
+}
+
+void Robot::SetMinGap(std::chrono::microseconds gap) { min_gap_ = gap; }
+
+void Robot::EnableClockSync(bool enable) { clock_sync_ = enable; }
+
+const ClockSync &Robot::GetClockSync() const { return clock_; }
+
+void Robot::SetRecord(component::record::Writer *record) { record_ = record; }
@@ -1,27 +1,39 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <mutex>
 #include <stack>
 #include <thread>
 
+#include "clock_sync.hpp"
 #include "common.hpp"
 #include "crc16.hpp"
+#include "frame_parser.hpp"
+#include "imu_history.hpp"
+#include "mailbox.hpp"
 #include "opencv2/core/quaternion.hpp"
 #include "opencv2/opencv.hpp"
 #include "protocol.h"
+#include "record.hpp"
+#include "seqlock.hpp"
 #include "serial.hpp"
 
 class Robot {
  private:
   Serial serial_;
-  bool thread_continue = false;
+  std::atomic<bool> thread_continue = false;
   std::thread thread_recv_, thread_trans_;
 
-  std::deque<Protocol_DownData_t> commandq_;
-  Protocol_UpDataReferee_t ref_;
-  Protocol_UpDataMCU_t mcu_;
+  component::Mailbox<Protocol_DownData_t> command_;
+  component::SeqLock<Protocol_UpDataReferee_t> ref_;
+  component::SeqLock<Protocol_UpDataMCU_t> mcu_;
+  ImuHistory imu_;
+  ClockSync clock_;
 
-  std::mutex mutex_command_, mutex_ref_, mutex_mcu_;
+  std::atomic<std::chrono::microseconds> min_gap_;
+  std::atomic<bool> clock_sync_;
+  std::atomic<component::record::Writer *> record_;
 
   void ThreadRecv();
   void ThreadTrans();
@@ -43,9 +55,74 @@ class Robot {
   game::Arm GetArm();
 
   component::Euler GetEuler();
+
+  /**
+   * @brief 获取某一时刻的云台姿态，由前后两次下位机数据插值得到
+   *
+   * @param stamp 时刻，一般为图像的采集时刻
+   * @return component::Euler 欧拉角
+   */
+  component::Euler GetEulerAt(std::chrono::steady_clock::time_point stamp);
   cv::Mat GetRotMat();
   float GetBalletSpeed();
   float GetChassicSpeed();
 
   void Pack(Protocol_DownData_t &data, const double distance);
+
+  /**
+   * @brief 注入下位机数据，处理与串口收到时相同，用于回放
+   *
+   * @param data 下位机数据
+   * @param stamp 下位机采样的时刻
+   */
+  void Feed(const Protocol_UpDataMCU_t &data,
+            std::chrono::steady_clock::time_point stamp);
+
+  /**
+   * @brief 注入裁判系统数据，处理与串口收到时相同，用于回放
+   *
+   * @param data 裁判系统数据
+   * @param stamp 收到的时刻
+   */
+  void Feed(const Protocol_UpDataReferee_t &data,
+            std::chrono::steady_clock::time_point stamp);
+
+  /**
+   * @brief 取走最近一次 Pack 的指令。未调用 Init 时指令不会被发送，回放时
+   * 由此取得输出用于比对
+   *
+   * @param data 指令
+   * @return true 有未取走的指令
+   * @return false 没有新指令
+   */
+  bool TakeCommand(Protocol_DownData_t &data);
+
+  /**
+   * @brief 设置两次发送之间的最小间隔，默认 2ms
+   *
+   * @param gap 间隔
+   */
+  void SetMinGap(std::chrono::microseconds gap);
+
+  /**
+   * @brief 开关与下位机的对时，默认关闭。对时请求与指令走同一条链路，
+   * 只有能区分两种帧的下位机固件才能开启
+   *
+   * @param enable 是否周期发送对时请求
+   */
+  void EnableClockSync(bool enable);
+
+  /**
+   * @brief 与下位机的时钟同步结果，用于换算下位机时刻和估计传输时延
+   *
+   * @return const ClockSync& 时钟同步
+   */
+  const ClockSync &GetClockSync() const;
+
+  /**
+   * @brief 录制收到的下位机与裁判系统数据以及发出的指令
+   *
+   * @param record 录制器，为空时停止录制，需在 Robot 析构之后才销毁
+   */
+  void SetRecord(component::record::Writer *record);
 };
@@ -1,20 +1,88 @@
 #include "serial.hpp"
 
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
 #include <termios.h>
 #include <unistd.h>
 
 #include <cerrno>
+#include <chrono>
+#include <cstdint>
 #include <cstring>
+#include <thread>
 
+#include "hot_log.hpp"
 #include "spdlog/spdlog.h"
 
+namespace {
+
+const int kWRITE_TIMEOUT = 10; /* ms，发送缓冲区满时等待可写的最长时间 */
+const int kREOPEN_PERIOD = 1000;     /* ms，一直等待时重新打开的间隔 */
+const int kREOPEN_LOG_PERIOD = 5000; /* ms */
+
+}  // namespace
+
+/**
+ * @brief 创建 epoll 并监听串口的可读事件
+ *
+ */
+void Serial::Watch() {
+  if (epoll_ >= 0) close(epoll_);
+  epoll_ = epoll_create1(EPOLL_CLOEXEC);
+
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.fd = dev_;
+  if (epoll_ < 0 || epoll_ctl(epoll_, EPOLL_CTL_ADD, dev_, &event) != 0) {
+    SPDLOG_ERROR("Error {} from epoll: {}.", errno, std::strerror(errno));
+    return;
+  }
+  /* 读操作由 epoll 驱动，不再阻塞 */
+  fcntl(dev_, F_SETFL, fcntl(dev_, F_GETFL) | O_NONBLOCK);
+}
+
+/**
+ * @brief 关闭已断开的设备，等待读写结束后再关闭，避免文件描述符被复用
+ *
+ */
+void Serial::Drop() {
+  std::scoped_lock lock(mutex_rx_, mutex_tx_);
+  Close();
+}
+
+/**
+ * @brief 重新打开设备并恢复最近一次的配置
+ *
+ * @return true 打开成功
+ * @return false 设备仍不存在
+ */
+bool Serial::Reopen() {
+  if (path_.empty()) return false;
+  const int dev = open(path_.c_str(), O_RDWR | O_NOCTTY | O_NDELAY);
+  if (dev < 0) {
+    HOT_LOG_EVERY_MS(SPDLOG_ERROR, kREOPEN_LOG_PERIOD,
+                     "Can't reopen Serial device {}: {}.", path_,
+                     std::strerror(errno));
+    return false;
+  }
+  {
+    std::scoped_lock lock(mutex_rx_, mutex_tx_);
+    dev_ = dev;
+  }
+  Config(parity_, stop_bit_, data_length_, flow_ctrl_, baud_rate_);
+  Watch();
+  SPDLOG_WARN("Serial device {} reopened.", path_);
+  return epoll_ >= 0;
+}
+
 /**
  * @brief Construct a new Serial object
  *
  */
 Serial::Serial() {
   dev_ = -1;
+  epoll_ = -1;
   SPDLOG_TRACE("Constructed.");
 }
 
@@ -23,13 +91,16 @@ Serial::Serial() {
  *
  * @param dev_path 具体要读写的串口设备
  */
-Serial::Serial(const std::string& dev_path) {
+Serial::Serial(const std::string& dev_path) : path_(dev_path) {
   dev_ = open(dev_path.c_str(), O_RDWR);
+  epoll_ = -1;
 
   if (dev_ < 0)
     SPDLOG_ERROR("Can't open Serial device.");
-  else
+  else {
     Config();
+    Watch();
+  }
 
   SPDLOG_TRACE("Constructed.");
 }
@@ -49,9 +120,13 @@ Serial::~Serial() {
  * @param dev_path 具体要读写的串口设备
  */
 void Serial::Open(const std::string& dev_path) {
+  path_ = dev_path;
   dev_ = open(dev_path.c_str(), O_RDWR | O_NOCTTY | O_NDELAY);
 
-  if (dev_ < 0) SPDLOG_ERROR("Can't open Serial device.");
+  if (dev_ < 0)
+    SPDLOG_ERROR("Can't open Serial device.");
+  else
+    Watch();
 }
 
 /**
@@ -76,6 +151,12 @@ bool Serial::Config(bool parity, StopBits stop_bit, DataLength data_length,
                     bool flow_ctrl, BaudRate baud_rate) {
   struct termios tty_cfg;
 
+  parity_ = parity;
+  stop_bit_ = stop_bit;
+  data_length_ = data_length;
+  flow_ctrl_ = flow_ctrl;
+  baud_rate_ = baud_rate;
+
   SPDLOG_INFO(
       "parity={}, stop_bit={}, data_length={}, flow_ctrl={}, "
       "baud_rate={}",
@@ -154,27 +235,81 @@ bool Serial::Config(bool parity, StopBits stop_bit, DataLength data_length,
 }
 
 /**
- * @brief 发送
+ * @brief 发送，直到全部写入、出错或超时
  *
  * @param buff 缓冲区地址
  * @param len 缓冲区长度
- * @return ssize_t 已发送的长度
+ * @return std::size_t 已发送的长度
  */
 std::size_t Serial::Trans(const void* buff, std::size_t len) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return write(dev_, buff, len);
+  std::lock_guard<std::mutex> lock(mutex_tx_);
+  if (dev_ < 0) return 0;
+
+  /* 设备为非阻塞模式，缓冲区满时等待可写，不能把短写当作发送完成 */
+  const auto* data = static_cast<const uint8_t*>(buff);
+  std::size_t sent = 0;
+  while (sent < len) {
+    const ssize_t ret = write(dev_, data + sent, len - sent);
+    if (ret > 0) {
+      sent += ret;
+      continue;
+    }
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0 && errno == EAGAIN) {
+      struct pollfd pfd = {dev_, POLLOUT, 0};
+      if (poll(&pfd, 1, kWRITE_TIMEOUT) > 0 && (pfd.revents & POLLOUT))
+        continue;
+      SPDLOG_WARN("Serial write timeout, {} of {} bytes sent.", sent, len);
+      break;
+    }
+    SPDLOG_ERROR("Error {} from write: {}.", errno, std::strerror(errno));
+    break;
+  }
+  return sent;
 }
 
 /**
- * @brief 接收
+ * @brief 非阻塞接收，没有数据或出错时返回 0
  *
  * @param buff 缓冲区地址
  * @param len 缓冲区长度
- * @return ssize_t 已发送的长度
+ * @return std::size_t 已接收的长度
  */
 std::size_t Serial::Recv(void* buff, std::size_t len) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return read(dev_, buff, len);
+  std::lock_guard<std::mutex> lock(mutex_rx_);
+  const ssize_t ret = read(dev_, buff, len);
+  if (ret < 0 && errno != EAGAIN && errno != EINTR)
+    SPDLOG_ERROR("Error {} from read: {}.", errno, std::strerror(errno));
+  return ret > 0 ? ret : 0;
+}
+
+/**
+ * @brief 等待串口可读。设备断开时关闭并返回 false，之后每次调用等待
+ * timeout_ms 后尝试重新打开，调用方不会空转
+ *
+ * @param timeout_ms 超时时间，-1 为一直等待
+ * @return true 有数据可读
+ * @return false 超时、出错或设备未打开
+ */
+bool Serial::Poll(int timeout_ms) {
+  if (epoll_ < 0) {
+    /* 未打开时 epoll 不会阻塞，先等待再重试，避免占满 CPU */
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(timeout_ms < 0 ? kREOPEN_PERIOD
+                                                 : timeout_ms));
+    return Reopen() && Poll(0);
+  }
+
+  struct epoll_event event;
+  const int ret = epoll_wait(epoll_, &event, 1, timeout_ms);
+  if (ret <= 0) return false;
+  /* USB 串口拔出后会一直报告 HUP/ERR，读不到数据 */
+  if (event.events & (EPOLLHUP | EPOLLERR)) {
+    SPDLOG_ERROR("Serial device {} hung up, will reopen.", path_);
+    Drop();
+    return false;
+  }
+  return true;
 }
 
 /**
@@ -182,4 +317,9 @@ std::size_t Serial::Recv(void* buff, std::size_t len) {
  *
  * @return int 状态代码
  */
-int Serial::Close() { return close(dev_); }
+int Serial::Close() {
+  if (epoll_ >= 0) close(epoll_);
+  const int ret = close(dev_);
+  epoll_ = dev_ = -1;
+  return ret;
+}
@@ -27,8 +27,35 @@ enum class DataLength {
 /* 串口 */
 class Serial {
  private:
-  int dev_;
-  std::mutex mutex_;
+  int dev_, epoll_;
+  std::mutex mutex_rx_, mutex_tx_;
+
+  /* 断开后按原路径重新打开，并恢复最近一次的配置 */
+  std::string path_;
+  bool parity_ = false, flow_ctrl_ = false;
+  StopBits stop_bit_ = StopBits::kSTOP_BITS_1;
+  DataLength data_length_ = DataLength::kDATA_LEN_8;
+  BaudRate baud_rate_ = BaudRate::kBAUD_RATE_460800;
+
+  /**
+   * @brief 创建 epoll 并监听串口的可读事件
+   *
+   */
+  void Watch();
+
+  /**
+   * @brief 关闭已断开的设备，等待读写结束后再关闭，避免文件描述符被复用
+   *
+   */
+  void Drop();
+
+  /**
+   * @brief 重新打开设备并恢复最近一次的配置
+   *
+   * @return true 打开成功
+   * @return false 设备仍不存在
+   */
+  bool Reopen();
 
  public:
   /**
@@ -81,7 +108,7 @@ class Serial {
               BaudRate baud_rate = BaudRate::kBAUD_RATE_460800);
 
   /**
-   * @brief 发送
+   * @brief 发送，直到全部写入、出错或超时
    *
    * @param buff 缓冲区地址
    * @param len 缓冲区长度
@@ -90,14 +117,24 @@ class Serial {
   std::size_t Trans(const void* buff, std::size_t len);
 
   /**
-   * @brief 接收
+   * @brief 非阻塞接收，没有数据或出错时返回 0
    *
    * @param buff 缓冲区地址
    * @param len 缓冲区长度
-   * @return std::size_t 已发送的长度
+   * @return std::size_t 已接收的长度
    */
   std::size_t Recv(void* buff, std::size_t len);
 
+  /**
+   * @brief 等待串口可读。设备断开时关闭并返回 false，之后每次调用等待
+   * timeout_ms 后尝试重新打开，调用方不会空转
+   *
+   * @param timeout_ms 超时时间，-1 为一直等待
+   * @return true 有数据可读
+   * @return false 超时、出错或设备未打开
+   */
+  bool Poll(int timeout_ms);
+
   /**
    * @brief 关闭
    *
@@ -1,9 +1,11 @@
 #include "armor_classifier.hpp"
 
+#include "metrics.hpp"
 #include "opencv2/dnn.hpp"
 #include "opencv2/imgproc.hpp"
 #include "opencv2/opencv.hpp"
 #include "spdlog/spdlog.h"
+#include "trace.hpp"
 
 ArmorClassifier::ArmorClassifier(const std::string model_path,
                                  const std::string lable_path,
@@ -37,6 +39,8 @@ void ArmorClassifier::SetInputSize(const cv::Size &input_size) {
 }
 
 void ArmorClassifier::ClassifyModel(Armor &armor, const cv::Mat &frame) {
+  TRACE_SPAN("classify");
+  METRICS_LATENCY("classify");
   cv::Mat image = armor.ImageFace(frame);
   cv::dnn::blobFromImage(image, blob_, 1. / 128., net_input_size_);
   net_.setInput(blob_);
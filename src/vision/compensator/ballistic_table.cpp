@@ -0,0 +1,201 @@
+#include "ballistic_table.hpp"
+
+#include <cmath>
+
+#include "spdlog/spdlog.h"
+
+namespace {
+
+const double kG = 9.80665;
+
+const double kMAX_DISTANCE = 12.; /* 水平距离范围 [0, 12]m */
+const double kMIN_HEIGHT = -3.;   /* 高度差范围 [-3, 3]m */
+const double kMAX_HEIGHT = 3.;
+const double kSTEP = 0.05; /* 网格间距(m) */
+const int kCOLS = static_cast<int>(kMAX_DISTANCE / kSTEP + 0.5) + 1;
+const int kROWS =
+    static_cast<int>((kMAX_HEIGHT - kMIN_HEIGHT) / kSTEP + 0.5) + 1;
+
+const double kMIN_PITCH = -1.; /* 出射角扫描范围(rad) */
+const double kMAX_PITCH = 0.9;
+const double kPITCH_STEP = 5e-4;
+const int kSUBSTEPS = 2;   /* 每个网格间距内的积分步数 */
+const double kMIN_VX = 1.; /* 水平速度过低时认为弹丸失速 */
+
+const double kMIN_SPEED = 5.;
+const double kMAX_SPEED = 40.;
+const double kSPEED_TOLERANCE = 0.3;
+
+/* 以水平距离为自变量的状态：高度、水平速度、竖直速度、飞行时间 */
+struct State {
+  double y, vx, vy, t;
+};
+
+State Derivative(const State &s, double drag) {
+  const double v = std::sqrt(s.vx * s.vx + s.vy * s.vy);
+  return {s.vy / s.vx, -drag * v, (-kG - drag * v * s.vy) / s.vx, 1. / s.vx};
+}
+
+State Advance(const State &s, const State &d, double h) {
+  return {s.y + d.y * h, s.vx + d.vx * h, s.vy + d.vy * h, s.t + d.t * h};
+}
+
+/* 经典四阶 Runge-Kutta，沿水平方向前进 h */
+State RungeKutta(const State &s, double h, double drag) {
+  const State k1 = Derivative(s, drag);
+  const State k2 = Derivative(Advance(s, k1, h / 2.), drag);
+  const State k3 = Derivative(Advance(s, k2, h / 2.), drag);
+  const State k4 = Derivative(Advance(s, k3, h), drag);
+  return {s.y + h / 6. * (k1.y + 2. * k2.y + 2. * k3.y + k4.y),
+          s.vx + h / 6. * (k1.vx + 2. * k2.vx + 2. * k3.vx + k4.vx),
+          s.vy + h / 6. * (k1.vy + 2. * k2.vy + 2. * k3.vy + k4.vy),
+          s.t + h / 6. * (k1.t + 2. * k2.t + 2. * k3.t + k4.t)};
+}
+
+}  // namespace
+
+std::shared_ptr<const BallisticTable::Table> BallisticTable::Build(
+    double speed, double drag) {
+  auto table = std::make_shared<Table>();
+  table->speed = speed;
+  table->drag = drag;
+  /* 第 0 列水平距离为 0，没有弹道经过，与未被覆盖的格点一样不可达 */
+  table->pitch.assign(kROWS * kCOLS, 0.f);
+  table->time.assign(kROWS * kCOLS, 0.f);
+  table->valid.assign(kROWS * kCOLS, 0);
+
+  /* 每一列记录上一个出射角的弹道，出射角递增时高度单调增加的部分为低弹道，
+   * 相邻两个出射角之间线性插值得到落在其间的格点 */
+  std::vector<State> prev(kCOLS);
+  std::vector<bool> started(kCOLS, false), ended(kCOLS, false);
+  std::vector<int> next_row(kCOLS, 0);
+
+  const int angles = static_cast<int>((kMAX_PITCH - kMIN_PITCH) / kPITCH_STEP);
+  for (int a = 0; a <= angles; ++a) {
+    const double theta = kMIN_PITCH + a * kPITCH_STEP;
+    State s{0., speed * std::cos(theta), speed * std::sin(theta), 0.};
+    bool alive = true;
+
+    for (int c = 1; c < kCOLS; ++c) {
+      for (int i = 0; alive && i < kSUBSTEPS; ++i) {
+        s = RungeKutta(s, kSTEP / kSUBSTEPS, drag);
+        alive = s.vx > kMIN_VX && s.y > kMIN_HEIGHT - kSTEP;
+      }
+
+      if (!alive) {
+        if (started[c]) ended[c] = true;
+        continue;
+      }
+      if (ended[c]) continue;
+
+      if (!started[c]) {
+        /* 低于最小出射角弹道的格点打不到 */
+        started[c] = true;
+        while (next_row[c] < kROWS && kMIN_HEIGHT + next_row[c] * kSTEP < s.y)
+          ++next_row[c];
+      } else if (s.y <= prev[c].y) {
+        ended[c] = true;
+        continue;
+      } else {
+        for (int &r = next_row[c]; r < kROWS; ++r) {
+          const double height = kMIN_HEIGHT + r * kSTEP;
+          if (height > s.y) break;
+          const double alpha = (height - prev[c].y) / (s.y - prev[c].y);
+          table->pitch[r * kCOLS + c] = theta - (1. - alpha) * kPITCH_STEP;
+          table->time[r * kCOLS + c] = prev[c].t + alpha * (s.t - prev[c].t);
+          table->valid[r * kCOLS + c] = 1;
+        }
+      }
+      prev[c] = s;
+    }
+  }
+  return table;
+}
+
+BallisticTable::BallisticTable(double drag)
+    : drag_(drag), building_(false), target_speed_(0.) {
+  SPDLOG_TRACE("Constructed.");
+}
+
+BallisticTable::~BallisticTable() {
+  if (builder_.joinable()) builder_.join();
+  SPDLOG_TRACE("Destructed.");
+}
+
+bool BallisticTable::Init(double speed) {
+  if (speed < kMIN_SPEED || speed > kMAX_SPEED) {
+    SPDLOG_ERROR("Invalid ballet speed: {}", speed);
+    return false;
+  }
+  if (builder_.joinable()) builder_.join();
+  target_speed_ = speed;
+  std::atomic_store(&table_, Build(speed, drag_));
+  SPDLOG_DEBUG("Built ballistic table for {} m/s.", speed);
+  return true;
+}
+
+void BallisticTable::Update(double speed, bool sync) {
+  if (speed < kMIN_SPEED || speed > kMAX_SPEED) return;
+  if (std::abs(speed - target_speed_) < kSPEED_TOLERANCE) return;
+  if (sync) {
+    Init(speed);
+    return;
+  }
+  /* 上一次重建尚未完成时等下一次调用 */
+  if (building_) return;
+
+  if (builder_.joinable()) builder_.join();
+  target_speed_ = speed;
+  building_ = true;
+  builder_ = std::thread([this, speed] {
+    std::atomic_store(&table_, Build(speed, drag_));
+    SPDLOG_DEBUG("Rebuilt ballistic table for {} m/s.", speed);
+    building_ = false;
+  });
+}
+
+void BallisticTable::SetDrag(double drag) {
+  if (builder_.joinable()) builder_.join();
+  drag_ = drag;
+  const double speed = target_speed_;
+  target_speed_ = 0.;
+  if (speed > 0.) Init(speed);
+}
+
+bool BallisticTable::Solve(double distance, double height, double &pitch,
+                           double &time) const {
+  const auto table = std::atomic_load(&table_);
+  if (!table) return false;
+
+  const double fx = distance / kSTEP;
+  const double fy = (height - kMIN_HEIGHT) / kSTEP;
+  if (!(fx >= 0. && fy >= 0. && fx < kCOLS - 1 && fy < kROWS - 1))
+    return false;
+
+  const int ix = static_cast<int>(fx), iy = static_cast<int>(fy);
+  const double wx = fx - ix, wy = fy - iy;
+  const int i00 = iy * kCOLS + ix, i10 = i00 + 1;
+  const int i01 = i00 + kCOLS, i11 = i01 + 1;
+
+  const auto &v = table->valid;
+  if (!(v[i00] && v[i10] && v[i01] && v[i11])) return false;
+
+  const auto &p = table->pitch;
+  const auto &t = table->time;
+  pitch = (1. - wy) * ((1. - wx) * p[i00] + wx * p[i10]) +
+          wy * ((1. - wx) * p[i01] + wx * p[i11]);
+  time = (1. - wy) * ((1. - wx) * t[i00] + wx * t[i10]) +
+         wy * ((1. - wx) * t[i01] + wx * t[i11]);
+  return true;
+}
+
+bool BallisticTable::Ready() const {
+  return std::atomic_load(&table_) != nullptr;
+}
+
+bool BallisticTable::Rebuilding() const { return building_; }
+
+double BallisticTable::Speed() const {
+  const auto table = std::atomic_load(&table_);
+  return table ? table->speed : 0.;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 考虑空气阻力的弹道查找表
+ *
+ * 阻力模型 a = -k * |v| * v - g。启动时按当前弹速对每个出射角积分一次弹道，
+ * 反解出 (水平距离, 高度差) 网格上每个格点所需的出射角和飞行时间；
+ * 查询时双线性插值，O(1) 且不分配内存。弹速变化后在后台线程重建，
+ * 建好后原子地替换，查询线程不会被阻塞。
+ */
+class BallisticTable {
+ public:
+  /* 阻力系数 k = 0.5 * rho * Cd * A / m (1/m)，Cd 取球体的 0.47 */
+  static constexpr double kDRAG_17MM = 0.019;
+  static constexpr double kDRAG_42MM = 0.0095;
+
+ private:
+  struct Table {
+    double speed, drag;
+    std::vector<float> pitch, time; /* 按行(高度差)存储 */
+    /* 格点是否可达。-Ofast 下 std::isnan 恒为 false，不能用 NaN 标记 */
+    std::vector<uint8_t> valid;
+  };
+
+  double drag_;
+  std::shared_ptr<const Table> table_;
+  std::thread builder_;
+  std::atomic<bool> building_;
+  double target_speed_;
+
+  /**
+   * @brief 按给定弹速和阻力系数计算整张表
+   *
+   * @param speed 弹速(m/s)
+   * @param drag 阻力系数(1/m)
+   * @return std::shared_ptr<const Table> 查找表
+   */
+  static std::shared_ptr<const Table> Build(double speed, double drag);
+
+ public:
+  /**
+   * @brief Construct a new BallisticTable object
+   *
+   * @param drag 阻力系数(1/m)
+   */
+  explicit BallisticTable(double drag = kDRAG_17MM);
+
+  /**
+   * @brief Destroy the BallisticTable object
+   *
+   */
+  ~BallisticTable();
+
+  /**
+   * @brief 同步建表，阻塞直到完成
+   *
+   * @param speed 弹速(m/s)
+   * @return true 建表成功
+   * @return false 弹速无效
+   */
+  bool Init(double speed);
+
+  /**
+   * @brief 弹速变化超过阈值时在后台重建，重建完成前继续使用旧表
+   *
+   * @param speed 弹速(m/s)
+   * @param sync 为 true 时同步重建，结果不受线程调度影响，用于回放比对
+   */
+  void Update(double speed, bool sync = false);
+
+  /**
+   * @brief 更换阻力系数，已有表时按当前弹速同步重建
+   *
+   * @param drag 阻力系数(1/m)
+   */
+  void SetDrag(double drag);
+
+  /**
+   * @brief 查询命中目标所需的出射角和飞行时间，线程安全
+   *
+   * @param distance 水平距离(m)
+   * @param height 目标相对枪口的高度(m)，向上为正
+   * @param pitch 出射角(rad)，向上为正
+   * @param time 飞行时间(s)
+   * @return true 查询成功
+   * @return false 未建表、超出范围或打不到
+   */
+  bool Solve(double distance, double height, double &pitch,
+             double &time) const;
+
+  /**
+   * @brief 是否已有可用的表
+   *
+   */
+  bool Ready() const;
+
+  /**
+   * @brief 是否正在后台重建
+   *
+   */
+  bool Rebuilding() const;
+
+  /**
+   * @brief 当前使用的表对应的弹速
+   *
+   * @return double 弹速(m/s)，未建表时为 0
+   */
+  double Speed() const;
+};
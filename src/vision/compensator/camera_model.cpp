@@ -0,0 +1,81 @@
+#include "camera_model.hpp"
+
+#include "spdlog/spdlog.h"
+
+CameraModel::CameraModel()
+    : fx_(0.),
+      fy_(0.),
+      cx_(0.),
+      cy_(0.),
+      k1_(0.),
+      k2_(0.),
+      p1_(0.),
+      p2_(0.),
+      k3_(0.),
+      loaded_(false),
+      step_(1),
+      cols_(0),
+      rows_(0) {
+  SPDLOG_TRACE("Constructed.");
+}
+
+CameraModel::~CameraModel() { SPDLOG_TRACE("Destructed."); }
+
+bool CameraModel::Init(const cv::Mat &cam_mat, const cv::Mat &distor_coff,
+                       cv::Size size, int step) {
+  loaded_ = false;
+  if (cam_mat.size() != cv::Size(3, 3) || step < 1) {
+    SPDLOG_ERROR("Invalid camera matrix.");
+    return false;
+  }
+
+  cv::Mat coff;
+  distor_coff.reshape(1, 1).convertTo(coff, CV_64F);
+  if (coff.cols > 5 && cv::countNonZero(coff.colRange(5, coff.cols)) > 0) {
+    SPDLOG_WARN("Unsupported distortion model with {} coefficients.",
+                coff.cols);
+    return false;
+  }
+  double k[5] = {0., 0., 0., 0., 0.};
+  for (int i = 0; i < std::min(coff.cols, 5); ++i) k[i] = coff.at<double>(i);
+  k1_ = k[0], k2_ = k[1], p1_ = k[2], p2_ = k[3], k3_ = k[4];
+
+  cv::Mat mat;
+  cam_mat.convertTo(mat, CV_64F);
+  fx_ = mat.at<double>(0, 0), fy_ = mat.at<double>(1, 1);
+  cx_ = mat.at<double>(0, 2), cy_ = mat.at<double>(1, 2);
+
+  if (size.empty())
+    size = cv::Size(cvRound(2. * cx_) + 1, cvRound(2. * cy_) + 1);
+
+  /* 网格多覆盖一格，保证图像内任意点都有四个相邻节点 */
+  step_ = step;
+  cols_ = (size.width - 1) / step_ + 2;
+  rows_ = (size.height - 1) / step_ + 2;
+  std::vector<cv::Point2f> nodes;
+  nodes.reserve(cols_ * rows_);
+  for (int r = 0; r < rows_; ++r)
+    for (int c = 0; c < cols_; ++c)
+      nodes.emplace_back(c * step_, r * step_);
+  cv::undistortPoints(nodes, grid_, mat, coff, cv::noArray(), mat);
+
+  loaded_ = true;
+  SPDLOG_DEBUG("Built {}x{} undistortion grid.", cols_, rows_);
+  return true;
+}
+
+void CameraModel::Project(const cv::Mat &object_points,
+                          const cv::Vec3d &rot_vec, const cv::Vec3d &trans_vec,
+                          std::vector<cv::Point2f> &image_points) const {
+  cv::Matx33d rot_mat;
+  cv::Rodrigues(rot_vec, rot_mat);
+
+  const int count = object_points.total() * object_points.channels() / 3;
+  cv::Mat points = object_points.reshape(3, count);
+  if (points.depth() != CV_64F) points.convertTo(points, CV_64F);
+  image_points.resize(points.rows);
+  for (int i = 0; i < points.rows; ++i) {
+    const cv::Vec3d &pt = points.at<cv::Vec3d>(i);
+    image_points[i] = Project(cv::Point3d(rot_mat * pt + trans_vec));
+  }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+/**
+ * @brief 针孔相机模型，内参在加载标定后不再变化
+ *
+ * 加载时用 OpenCV 对覆盖整幅图像的网格节点做一次去畸变，之后单点去畸变
+ * 只需查表和双线性插值；投影使用内联的 k1, k2, p1, p2, k3 畸变模型。
+ * 不支持更高阶的畸变系数，此时 Init 失败，调用方应回退到 OpenCV。
+ */
+class CameraModel {
+ private:
+  double fx_, fy_, cx_, cy_;
+  double k1_, k2_, p1_, p2_, k3_;
+  bool loaded_;
+
+  int step_, cols_, rows_;
+  std::vector<cv::Point2f> grid_; /* 网格节点去畸变后的像素坐标 */
+
+ public:
+  /**
+   * @brief Construct a new CameraModel object
+   *
+   */
+  CameraModel();
+
+  /**
+   * @brief Destroy the CameraModel object
+   *
+   */
+  ~CameraModel();
+
+  /**
+   * @brief 载入内参并建立去畸变网格
+   *
+   * @param cam_mat 相机矩阵
+   * @param distor_coff 畸变系数
+   * @param size 图像尺寸，为空时由主点位置推算
+   * @param step 网格间距(px)
+   * @return true 载入成功
+   * @return false 参数无效或畸变模型不支持
+   */
+  bool Init(const cv::Mat &cam_mat, const cv::Mat &distor_coff,
+            cv::Size size = cv::Size(), int step = 2);
+
+  /**
+   * @brief 是否已载入
+   *
+   */
+  bool Loaded() const { return loaded_; }
+
+  /**
+   * @brief 查表去畸变，结果仍为同一相机矩阵下的像素坐标
+   *
+   * @param point 畸变的像素坐标
+   * @param undistorted 去畸变的像素坐标
+   * @return true 成功
+   * @return false 未载入或超出网格范围
+   */
+  bool Undistort(const cv::Point2f &point, cv::Point2f &undistorted) const {
+    if (!loaded_) return false;
+    const float fx = point.x / step_, fy = point.y / step_;
+    if (!(fx >= 0.f && fy >= 0.f && fx < cols_ - 1 && fy < rows_ - 1))
+      return false;
+
+    const int ix = static_cast<int>(fx), iy = static_cast<int>(fy);
+    const float wx = fx - ix, wy = fy - iy;
+    const cv::Point2f *p = &grid_[iy * cols_ + ix];
+    undistorted = (1.f - wy) * ((1.f - wx) * p[0] + wx * p[1]) +
+                  wy * ((1.f - wx) * p[cols_] + wx * p[cols_ + 1]);
+    return true;
+  }
+
+  /**
+   * @brief 将相机坐标系下的点投影到图像
+   *
+   * @param point 相机坐标系下的点，Z > 0
+   * @return cv::Point2f 像素坐标
+   */
+  cv::Point2f Project(const cv::Point3d &point) const {
+    const double x = point.x / point.z, y = point.y / point.z;
+    const double r2 = x * x + y * y;
+    const double radial = 1. + r2 * (k1_ + r2 * (k2_ + r2 * k3_));
+    const double xd = x * radial + 2. * p1_ * x * y + p2_ * (r2 + 2. * x * x);
+    const double yd = y * radial + p1_ * (r2 + 2. * y * y) + 2. * p2_ * x * y;
+    return cv::Point2f(fx_ * xd + cx_, fy_ * yd + cy_);
+  }
+
+  /**
+   * @brief 将物体坐标系下的点投影到图像，与 cv::projectPoints 等价
+   *
+   * @param object_points 物体坐标，Nx3 单通道或 Nx1 三通道
+   * @param rot_vec 旋转向量
+   * @param trans_vec 平移向量
+   * @param image_points 像素坐标
+   */
+  void Project(const cv::Mat &object_points, const cv::Vec3d &rot_vec,
+               const cv::Vec3d &trans_vec,
+               std::vector<cv::Point2f> &image_points) const;
+};
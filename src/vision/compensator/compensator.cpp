@@ -1,19 +1,32 @@
 #include "compensator.hpp"
 
+#include <algorithm>
+#include <numeric>
+
+#include "hot_log.hpp"
+#include "metrics.hpp"
 #include "opencv2/opencv.hpp"
 #include "spdlog/spdlog.h"
+#include "tbb/parallel_for.h"
+#include "trace.hpp"
 
 namespace {
 
 const double kG = 9.80665;
+const double kTRACK_GATE = 40.; /* 同一目标相邻两帧中心的最大像素距离 */
 
 }  // namespace
 
 void Compensator::VisualizePnp(Armor& armor, const cv::Mat& output,
                                bool add_lable) {
+  if (armor.GetTransVec().empty()) return;
   std::vector<cv::Point2f> out_points;
-  cv::projectPoints(armor.ImageVertices(), armor.GetRotVec(),
-                    armor.GetTransVec(), cam_mat_, distor_coff_, out_points);
+  if (camera_.Loaded())
+    camera_.Project(armor.PhysicVertices(), cv::Vec3d(armor.GetRotVec()),
+                    cv::Vec3d(armor.GetTransVec()), out_points);
+  else
+    cv::projectPoints(armor.PhysicVertices(), armor.GetRotVec(),
+                      armor.GetTransVec(), cam_mat_, distor_coff_, out_points);
   for (std::size_t i = 0; i < out_points.size(); ++i) {
     cv::line(output, out_points[i], out_points[(i + 1) % out_points.size()],
              draw::kBLACK);
@@ -45,6 +58,8 @@ void Compensator::LoadCameraMat(const std::string& path) {
     if (cam_mat_.empty() && distor_coff_.empty()) {
       SPDLOG_ERROR("Can not load cali data.");
     } else {
+      pnp_solver_.SetCamera(cam_mat_, distor_coff_);
+      camera_.Init(cam_mat_, distor_coff_);
       SPDLOG_DEBUG("Loaded cali data.");
     }
   } else {
@@ -52,13 +67,44 @@ void Compensator::LoadCameraMat(const std::string& path) {
   }
 }
 
-void Compensator::SolveAngles(Armor& armor, component::Euler euler) {
-  (void)euler;
+void Compensator::SetBalletSpeed(double speed, bool sync) {
+  ballet_speed_ = speed;
+  ballistic_table_.Update(speed, sync);
+}
+
+void Compensator::SetArm(game::Arm arm) {
+  ballistic_table_.SetDrag(arm == game::Arm::kHERO
+                               ? BallisticTable::kDRAG_42MM
+                               : BallisticTable::kDRAG_17MM);
+}
+
+const Pose* Compensator::FindTrack(const Armor& armor) const {
+  const Pose* guess = nullptr;
+  double min_dist = kTRACK_GATE;
+  for (auto& track : tracks_) {
+    if (track.model != armor.GetModel()) continue;
+    const double dist = cv::norm(track.center - armor.ImageCenter());
+    if (dist < min_dist) {
+      min_dist = dist;
+      guess = &track.pose;
+    }
+  }
+  return guess;
+}
+
+bool Compensator::SolveAngles(Armor& armor, std::vector<cv::Point2f>& scratch,
+                              double& distance) {
+  TRACE_SPAN("pnp");
+  METRICS_LATENCY("pnp");
   component::Euler aiming_eulr;
-  cv::Mat rot_vec, trans_vec;
+  Pose pose;
 
-  cv::solvePnP(armor.PhysicVertices(), armor.ImageVertices(), cam_mat_,
-               distor_coff_, rot_vec, trans_vec, false, cv::SOLVEPNP_ITERATIVE);
+  if (!pnp_solver_.Solve(armor.PhysicVertices(), armor.ImageVertices(),
+                         FindTrack(armor), pose)) {
+    HOT_LOG_EVERY_MS(SPDLOG_ERROR, 1000, "Can not solve pose.");
+    return false;
+  }
+  cv::Mat rot_vec(pose.rot_vec, true), trans_vec(pose.trans_vec, true);
 
   trans_vec.at<double>(1, 0) -= gun_cam_distance_;
   armor.SetRotVec(rot_vec), armor.SetTransVec(trans_vec);
@@ -66,45 +112,95 @@ void Compensator::SolveAngles(Armor& armor, component::Euler euler) {
   double x_pos = armor.GetTransVec().at<double>(0, 0);
   double y_pos = armor.GetTransVec().at<double>(1, 0);
   double z_pos = armor.GetTransVec().at<double>(2, 0);
-  SPDLOG_WARN("x : {}, y : {}, z : {} ", x_pos, y_pos, z_pos);
-  distance_ = sqrt(x_pos * x_pos + y_pos * y_pos + z_pos * z_pos);
+  HOT_LOG_EVERY_N(SPDLOG_DEBUG, 64, "x : {}, y : {}, z : {} ", x_pos, y_pos,
+                  z_pos);
+  distance = sqrt(x_pos * x_pos + y_pos * y_pos + z_pos * z_pos);
 
-  if (distance_ > 5000) {
+  if (distance > 5000) {
     // PinHoleSolver
     double ax = cam_mat_.at<double>(0, 0);
     double ay = cam_mat_.at<double>(1, 1);
     double u0 = cam_mat_.at<double>(0, 2);
     double v0 = cam_mat_.at<double>(1, 2);
 
-    std::vector<cv::Point2f> out;
-    cv::undistortPoints(std::vector<cv::Point2f>{armor.image_center_}, out,
-                        cam_mat_, distor_coff_, cv::noArray(), cam_mat_);
-    aiming_eulr.pitch = -atan((out.front().y - v0) / ay);
-    aiming_eulr.yaw = atan((out.front().x - u0) / ax);
+    cv::Point2f center = armor.ImageCenter(), out;
+    if (!camera_.Undistort(center, out)) {
+      cv::undistortPoints(cv::Mat(1, 1, CV_32FC2, &center), scratch, cam_mat_,
+                          distor_coff_, cv::noArray(), cam_mat_);
+      out = scratch.front();
+    }
+    aiming_eulr.pitch = -atan((out.y - v0) / ay);
+    aiming_eulr.yaw = atan((out.x - u0) / ax);
   } else {
     // P4PSolver
     aiming_eulr.pitch = -atan(y_pos / sqrt(x_pos * x_pos + z_pos * z_pos));
     aiming_eulr.yaw = atan(x_pos / z_pos);
   }
   armor.SetAimEuler(aiming_eulr);
+  return true;
 }
 
-void Compensator::Apply(tbb::concurrent_vector<Armor>& armors,
-                        const cv::Mat& frame, const component::Euler& euler) {
-  for (auto& armor : armors) {
-    if (armor.GetModel() == game::Model::kUNKNOWN) {
-      armor.SetModel(game::Model::kINFANTRY);
-      SPDLOG_ERROR("Hasn't set model.");
-    }
-    SolveAngles(armor, euler);
-    // CompensateGravity(armor, euler);
+std::size_t Compensator::Apply(tbb::concurrent_vector<Armor>& armors,
+                               const cv::Mat& frame,
+                               const component::Euler& euler,
+                               std::size_t selected) {
+  TRACE_SPAN("compensate");
+  METRICS_LATENCY("compensate");
+  const std::size_t count =
+      selected == 0 ? armors.size() : std::min(armors.size(), selected);
+  const cv::Point2f frame_center(frame.cols / 2, frame.rows / 2);
+  std::vector<double> keys(count);
+  std::vector<char> solved(count, false);
+  /* 并行解算在其他线程中，带上当前帧号 */
+  const uint64_t frame_id = component::trace::GetFrame();
+
+  /* 各装甲板相互独立，只读上一帧的位姿，逐个并行解算 */
+  tbb::parallel_for(
+      tbb::blocked_range<std::size_t>(0, count, 1),
+      [&](const tbb::blocked_range<std::size_t>& range) {
+        component::trace::SetFrame(frame_id);
+        auto& scratch = scratch_.local();
+        for (std::size_t i = range.begin(); i != range.end(); ++i) {
+          Armor& armor = armors[i];
+          if (armor.GetModel() == game::Model::kUNKNOWN) {
+            armor.SetModel(game::Model::kINFANTRY);
+            HOT_LOG_EVERY_MS(SPDLOG_ERROR, 1000, "Hasn't set model.");
+          }
+          double distance;
+          solved[i] = SolveAngles(armor, scratch, distance);
+          if (solved[i]) CompensateGravity(armor, euler, distance);
+          /* 经过目标选择时保持其优先级顺序 */
+          keys[i] = selected > 0 ? i
+                                 : cv::norm(armor.ImageCenter() - frame_center);
+        }
+      });
+
+  std::vector<PoseTrack> tracks;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (!solved[i]) continue;
+    cv::Vec3d trans_vec(armors[i].GetTransVec());
+    trans_vec[1] += gun_cam_distance_;
+    tracks.push_back({armors[i].ImageCenter(), armors[i].GetModel(),
+                      {cv::Vec3d(armors[i].GetRotVec()), trans_vec}});
   }
-  cv::Point2f frame_center(frame.cols / 2, frame.rows / 2);
-  std::sort(armors.begin(), armors.end(),
-            [frame_center](Armor& armor1, Armor& armor2) {
-              return cv::norm(armor1.ImageCenter() - frame_center) <
-                     cv::norm(armor2.ImageCenter() - frame_center);
+  tracks_.swap(tracks);
+
+  /* 排序键只算一次，按下标排序后整体重排，解算失败的排在最后 */
+  std::vector<std::size_t> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&keys, &solved](std::size_t i, std::size_t j) {
+              if (solved[i] != solved[j]) return solved[i] > solved[j];
+              return keys[i] < keys[j];
             });
+
+  tbb::concurrent_vector<Armor> sorted;
+  sorted.reserve(armors.size());
+  for (auto i : order) sorted.push_back(armors[i]);
+  for (std::size_t i = count; i < armors.size(); ++i)
+    sorted.push_back(armors[i]);
+  armors.swap(sorted);
+  return std::count(solved.begin(), solved.end(), true);
 }
 
 void Compensator::VisualizeResult(tbb::concurrent_vector<Armor>& armors,
@@ -114,13 +210,19 @@ void Compensator::VisualizeResult(tbb::concurrent_vector<Armor>& armors,
   }
 }
 
-void Compensator::CompensateGravity(Armor& armor, component::Euler euler) {
-  component::Euler aiming_eulr;
-  aiming_eulr.pitch = armor.GetAimEuler().pitch + euler.pitch;
-  float compensate_pitch = atan(
-      (sin(aiming_eulr.pitch) - 0.5 * kG * distance_ / pow(ballet_speed_, 2)) /
-      cos(aiming_eulr.pitch));
-  aiming_eulr.pitch = (armor.GetAimEuler().pitch + compensate_pitch) * (-0.01);
+void Compensator::CompensateGravity(Armor& armor,
+                                    const component::Euler& euler,
+                                    double distance) {
+  component::Euler aiming_eulr = armor.GetAimEuler();
+  const double elevation = aiming_eulr.pitch + euler.pitch;
+  distance /= 1000.;
+
+  /* 查表未就绪或目标超出范围时保持几何瞄准角 */
+  double pitch, time;
+  if (!ballistic_table_.Solve(distance * cos(elevation),
+                              distance * sin(elevation), pitch, time))
+    return;
+  aiming_eulr.pitch = pitch - euler.pitch;
   armor.SetAimEuler(aiming_eulr);
 
   // 人为补偿
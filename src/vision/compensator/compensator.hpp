@@ -1,16 +1,37 @@
 #pragma once
 
+#include <vector>
+
 #include "armor.hpp"
+#include "ballistic_table.hpp"
+#include "camera_model.hpp"
+#include "pnp_solver.hpp"
 #include "tbb/concurrent_vector.h"
+#include "tbb/enumerable_thread_specific.h"
+
+struct PoseTrack {
+  cv::Point2f center;
+  game::Model model;
+  Pose pose;
+};
 
 class Compensator {
  private:
-  double ballet_speed_, distance_;
+  double ballet_speed_;
   cv::Mat cam_mat_, distor_coff_;
   double gun_cam_distance_;  //枪口到镜头的距离
 
-  void SolveAngles(Armor& armor, component::Euler euler);
-  void CompensateGravity(Armor& armor, component::Euler euler);
+  CameraModel camera_;
+  PnpSolver pnp_solver_;
+  BallisticTable ballistic_table_;
+  std::vector<PoseTrack> tracks_; /* 上一帧的位姿，用于热启动 */
+  tbb::enumerable_thread_specific<std::vector<cv::Point2f>> scratch_;
+
+  const Pose* FindTrack(const Armor& armor) const;
+  bool SolveAngles(Armor& armor, std::vector<cv::Point2f>& scratch,
+                   double& distance);
+  void CompensateGravity(Armor& armor, const component::Euler& euler,
+                         double distance);
 
   double PinHoleEstimate(Armor& armor);
 
@@ -22,9 +43,33 @@ class Compensator {
   ~Compensator();
 
   void LoadCameraMat(const std::string& path);
+  /**
+   * @brief 设置弹速，变化较大时重建弹道表
+   *
+   * @param speed 弹速(m/s)
+   * @param sync 为 true 时同步建表，回放时保证每次运行的输出相同
+   */
+  void SetBalletSpeed(double speed, bool sync = false);
+
+  /**
+   * @brief 按兵种选择弹丸的阻力系数，英雄为 42mm，其余为 17mm
+   *
+   * @param arm 兵种
+   */
+  void SetArm(game::Arm arm);
 
-  void Apply(tbb::concurrent_vector<Armor>& armors, const cv::Mat& frame,
-             const component::Euler& euler);
+  /**
+   * @brief 解算装甲板的位姿与瞄准角，解算失败的排在最后，没有位姿
+   *
+   * selected 为目标选择输出的数量：只解算前 selected 个并保持其优先级顺序，
+   * 其余视为已被排除，保持原样。为 0 时表示未经选择，解算全部并按到画面
+   * 中心的距离排序。
+   *
+   * @return std::size_t 解算成功的数量，为 0 时不能用 front() 瞄准
+   */
+  std::size_t Apply(tbb::concurrent_vector<Armor>& armors,
+                    const cv::Mat& frame, const component::Euler& euler,
+                    std::size_t selected = 0);
 
   void VisualizeResult(tbb::concurrent_vector<Armor>& armors,
                        const cv::Mat& output, int verbose = 1);
@@ -0,0 +1,112 @@
+#include "pnp_solver.hpp"
+
+#include "spdlog/spdlog.h"
+
+namespace {
+
+const double kMAX_REPROJ_ERROR = 2.;
+
+/**
+ * @brief 辅助函数：两个旋转向量之间的夹角
+ *
+ * @param rvec1 旋转向量
+ * @param rvec2 旋转向量
+ * @return double 夹角(rad)
+ */
+double RotationDistance(const cv::Vec3d &rvec1, const cv::Vec3d &rvec2) {
+  cv::Matx33d rot1, rot2;
+  cv::Rodrigues(rvec1, rot1);
+  cv::Rodrigues(rvec2, rot2);
+  cv::Vec3d diff;
+  cv::Rodrigues(rot1.t() * rot2, diff);
+  return cv::norm(diff);
+}
+
+}  // namespace
+
+bool PnpSolver::SolveIterative(const cv::Mat &object_points,
+                               const std::vector<cv::Point2f> &image_points,
+                               const Pose *guess, Pose &pose) const {
+  cv::Mat rot_vec, trans_vec;
+  if (guess != nullptr) {
+    rot_vec = cv::Mat(guess->rot_vec, true);
+    trans_vec = cv::Mat(guess->trans_vec, true);
+  }
+  try {
+    if (!cv::solvePnP(object_points, image_points, cam_mat_, distor_coff_,
+                      rot_vec, trans_vec, guess != nullptr,
+                      cv::SOLVEPNP_ITERATIVE))
+      return false;
+  } catch (const cv::Exception &e) {
+    /* 角点数量不足等输入错误 */
+    SPDLOG_DEBUG("Iterative PnP failed: {}", e.what());
+    return false;
+  }
+
+  pose.rot_vec = cv::Vec3d(rot_vec);
+  pose.trans_vec = cv::Vec3d(trans_vec);
+  return true;
+}
+
+PnpSolver::PnpSolver()
+    : max_reproj_error_(kMAX_REPROJ_ERROR), solved_(0), fallback_(0) {
+  SPDLOG_TRACE("Constructed.");
+}
+
+PnpSolver::~PnpSolver() { SPDLOG_TRACE("Destructed."); }
+
+void PnpSolver::SetCamera(const cv::Mat &cam_mat, const cv::Mat &distor_coff) {
+  cam_mat_ = cam_mat;
+  distor_coff_ = distor_coff;
+}
+
+void PnpSolver::SetMaxReprojError(double error) { max_reproj_error_ = error; }
+
+bool PnpSolver::Solve(const cv::Mat &object_points,
+                      const std::vector<cv::Point2f> &image_points,
+                      const Pose *guess, Pose &pose) const {
+  solved_++;
+
+  /* IPPE 要求 Nx1 三通道的物体坐标 */
+  const cv::Mat points = object_points.reshape(3, object_points.rows);
+  std::vector<cv::Mat> rot_vecs, trans_vecs;
+  std::vector<double> errors;
+  int solutions = 0;
+  try {
+    solutions = cv::solvePnPGeneric(points, image_points, cam_mat_,
+                                    distor_coff_, rot_vecs, trans_vecs, false,
+                                    cv::SOLVEPNP_IPPE, cv::noArray(),
+                                    cv::noArray(), errors);
+  } catch (const cv::Exception &e) {
+    SPDLOG_DEBUG("IPPE failed: {}", e.what());
+  }
+
+  /* 结果按重投影误差升序排列，两解都可信时用上一帧位姿消除二义性 */
+  int best = -1;
+  for (int i = 0; i < solutions; ++i) {
+    if (errors[i] > max_reproj_error_) continue;
+    if (best < 0) {
+      best = i;
+    } else if (guess != nullptr &&
+               RotationDistance(guess->rot_vec, cv::Vec3d(rot_vecs[i])) <
+                   RotationDistance(guess->rot_vec,
+                                    cv::Vec3d(rot_vecs[best]))) {
+      best = i;
+    }
+  }
+
+  if (best >= 0) {
+    pose.rot_vec = cv::Vec3d(rot_vecs[best]);
+    pose.trans_vec = cv::Vec3d(trans_vecs[best]);
+    return true;
+  }
+
+  fallback_++;
+  SPDLOG_DEBUG("Reprojection error exceeds {}px, fallback.", max_reproj_error_);
+  return SolveIterative(object_points, image_points, guess, pose);
+}
+
+double PnpSolver::FallbackRatio() const {
+  const std::size_t solved = solved_;
+  return solved == 0 ? 0. : static_cast<double>(fallback_) / solved;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "opencv2/opencv.hpp"
+
+struct Pose {
+  cv::Vec3d rot_vec;
+  cv::Vec3d trans_vec;
+};
+
+/**
+ * @brief 平面四点位姿解算
+ *
+ * 先用闭式解 IPPE 求出平面目标的两个候选位姿，有上一帧位姿时选取与其最接近的
+ * 候选以消除平面二义性；重投影误差超限时回退到迭代法。
+ */
+class PnpSolver {
+ private:
+  cv::Mat cam_mat_, distor_coff_;
+  double max_reproj_error_;
+
+  mutable std::atomic<std::size_t> solved_, fallback_;
+
+  /**
+   * @brief 迭代法解算，有初值时从初值开始优化
+   *
+   * @param object_points 物体坐标
+   * @param image_points 图像坐标
+   * @param guess 初值，可为空
+   * @param pose 解算结果
+   * @return true 解算成功
+   * @return false 解算失败
+   */
+  bool SolveIterative(const cv::Mat &object_points,
+                      const std::vector<cv::Point2f> &image_points,
+                      const Pose *guess, Pose &pose) const;
+
+ public:
+  /**
+   * @brief Construct a new PnpSolver object
+   *
+   */
+  PnpSolver();
+
+  /**
+   * @brief Destroy the PnpSolver object
+   *
+   */
+  ~PnpSolver();
+
+  /**
+   * @brief 设置相机内参
+   *
+   * @param cam_mat 相机矩阵
+   * @param distor_coff 畸变系数
+   */
+  void SetCamera(const cv::Mat &cam_mat, const cv::Mat &distor_coff);
+
+  /**
+   * @brief 设置允许的最大重投影误差
+   *
+   * @param error 误差(px)
+   */
+  void SetMaxReprojError(double error);
+
+  /**
+   * @brief 解算位姿，线程安全
+   *
+   * @param object_points 共面的物体坐标
+   * @param image_points 图像坐标
+   * @param guess 同一目标上一帧的位姿，可为空
+   * @param pose 解算结果
+   * @return true 解算成功
+   * @return false 解算失败
+   */
+  bool Solve(const cv::Mat &object_points,
+             const std::vector<cv::Point2f> &image_points, const Pose *guess,
+             Pose &pose) const;
+
+  /**
+   * @brief 回退到迭代法的比例
+   *
+   * @return double 比例
+   */
+  double FallbackRatio() const;
+};
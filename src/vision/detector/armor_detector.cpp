@@ -2,7 +2,10 @@
 
 #include <execution>
 
+#include "hot_log.hpp"
+#include "metrics.hpp"
 #include "spdlog/spdlog.h"
+#include "trace.hpp"
 
 void ArmorDetector::InitDefaultParams(const std::string &params_path) {
   cv::FileStorage fs(params_path,
@@ -61,6 +64,7 @@ bool ArmorDetector::PrepareParams(const std::string &params_path) {
 }
 
 void ArmorDetector::FindLightBars(const cv::Mat &frame) {
+  TRACE_SPAN("find_bars");
   duration_bars_.Start();
   lightbars_.clear();
   targets_.clear();
@@ -121,25 +125,26 @@ void ArmorDetector::FindLightBars(const cv::Mat &frame) {
 
     /* 只留下轮廓大小在一定比例内的 */
     const double c_area = cv::contourArea(contour) / frame_area;
-    SPDLOG_INFO("c_area is {}", c_area);
+    HOT_LOG_EVERY_N(SPDLOG_DEBUG, 64, "c_area is {}", c_area);
     if (c_area < params_.contour_area_low_th) return;
     if (c_area > params_.contour_area_high_th) return;
 
     LightBar potential_bar(cv::minAreaRect(contour));
 
     /* 灯条倾斜角度不能太大 */
-    SPDLOG_INFO("angle is {}", std::abs(potential_bar.ImageAngle()));
+    HOT_LOG_EVERY_N(SPDLOG_DEBUG, 64, "angle is {}",
+                    std::abs(potential_bar.ImageAngle()));
     if (std::abs(potential_bar.ImageAngle()) > params_.angle_high_th) return;
 
     /* 灯条在画面中的大小要满足条件 */
     const double bar_area = potential_bar.Area() / frame_area;
-    SPDLOG_INFO("bar_area is {}", bar_area);
+    HOT_LOG_EVERY_N(SPDLOG_DEBUG, 64, "bar_area is {}", bar_area);
     if (bar_area < params_.bar_area_low_th) return;
     if (bar_area > params_.bar_area_high_th) return;
 
     /* 灯条的长宽比要满足条件 */
     const double aspect_ratio = potential_bar.ImageAspectRatio();
-    SPDLOG_INFO("aspect_ratio is {}", aspect_ratio);
+    HOT_LOG_EVERY_N(SPDLOG_DEBUG, 64, "aspect_ratio is {}", aspect_ratio);
     if (aspect_ratio < params_.aspect_ratio_low_th) return;
     if (aspect_ratio > params_.aspect_ratio_high_th) return;
 
@@ -161,6 +166,7 @@ void ArmorDetector::FindLightBars(const cv::Mat &frame) {
 }
 
 void ArmorDetector::MatchLightBars() {
+  TRACE_SPAN("match_bars");
   duration_armors_.Start();
   for (auto iti = lightbars_.begin(); iti != lightbars_.end(); ++iti) {
     for (auto itj = iti + 1; itj != lightbars_.end(); ++itj) {
@@ -181,13 +187,13 @@ void ArmorDetector::MatchLightBars() {
       /* 灯条长度差异 */
       const double length_diff =
           algo::RelativeDifference(iti->Length(), itj->Length());
-      SPDLOG_INFO("length_diff is {}", length_diff);
+      HOT_LOG_EVERY_N(SPDLOG_DEBUG, 64, "length_diff is {}", length_diff);
       if (length_diff > params_.length_diff_th) continue;
 
       /* 灯条高度差异 */
       const double height_diff =
           algo::RelativeDifference(iti->ImageCenter().y, itj->ImageCenter().y);
-      SPDLOG_INFO("height_diff is {}", height_diff);
+      HOT_LOG_EVERY_N(SPDLOG_DEBUG, 64, "height_diff is {}", height_diff);
       if (height_diff > (params_.height_diff_th * frame_size_.height)) continue;
 
       /* 灯条面积差异 */
@@ -229,6 +235,8 @@ void ArmorDetector::SetEnemyTeam(game::Team enemy_team) {
 
 const tbb::concurrent_vector<Armor> &ArmorDetector::Detect(
     const cv::Mat &frame) {
+  TRACE_SPAN("detect");
+  METRICS_LATENCY("detect");
   SPDLOG_DEBUG("Detecting");
   FindLightBars(frame);
   MatchLightBars();
@@ -237,13 +245,6 @@ const tbb::concurrent_vector<Armor> &ArmorDetector::Detect(
 }
 
 void ArmorDetector::VisualizeResult(const cv::Mat &output, int verbose) {
-  auto draw_lightbar = [&](LightBar &bar) {
-    bar.VisualizeObject(output, verbose > 2, draw::kGREEN, cv::MARKER_CROSS);
-  };
-  auto draw_armor = [&](Armor &armor) {
-    armor.VisualizeObject(output, verbose > 2);
-  };
-
   if (verbose > 0) {
     cv::drawContours(output, contours_, -1, draw::kRED);
     cv::drawContours(output, contours_poly_, -1, draw::kYELLOW);
@@ -258,12 +259,12 @@ void ArmorDetector::VisualizeResult(const cv::Mat &output, int verbose) {
     draw::VisualizeLabel(output, label, 2);
   }
 
-  if (!lightbars_.empty()) {
-    std::for_each(std::execution::par_unseq, lightbars_.begin(),
-                  lightbars_.end(), draw_lightbar);
-  }
-  if (!targets_.empty()) {
-    std::for_each(std::execution::par_unseq, targets_.begin(), targets_.end(),
-                  draw_armor);
-  }
+  /* 绘制同一张图，不能并行 */
+  for (auto &bar : lightbars_)
+    bar.VisualizeObject(output, verbose > 2, draw::kGREEN, cv::MARKER_CROSS);
+  for (auto &armor : targets_) armor.VisualizeObject(output, verbose > 2);
+}
+
+const tbb::concurrent_vector<LightBar> &ArmorDetector::GetLightBars() const {
+  return lightbars_;
 }
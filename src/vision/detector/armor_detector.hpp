@@ -30,4 +30,7 @@ class ArmorDetector : public Detector<Armor, ArmorDetectorParam<double>> {
 
   const tbb::concurrent_vector<Armor> &Detect(const cv::Mat &frame);
   void VisualizeResult(const cv::Mat &output, int verbose = 1);
+
+  /* 上一次 Detect 找到的灯条 */
+  const tbb::concurrent_vector<LightBar> &GetLightBars() const;
 };
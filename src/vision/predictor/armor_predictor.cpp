@@ -2,6 +2,9 @@
 
 #include <execution>
 
+#include "metrics.hpp"
+#include "trace.hpp"
+
 void ArmorPredictor::MatchArmor() {
   duration_predict_.Start();
 
@@ -55,6 +58,8 @@ void ArmorPredictor::SetArmors(const tbb::concurrent_vector<Armor> &armors) {
 }
 
 const tbb::concurrent_vector<Armor> &ArmorPredictor::Predict() {
+  TRACE_SPAN("predict");
+  METRICS_LATENCY("predict");
   predicts_.clear();
   MatchArmor();
   return predicts_;
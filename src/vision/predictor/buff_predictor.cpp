@@ -1,9 +1,13 @@
 #include "buff_predictor.hpp"
 
 #include <chrono>
+#include <cmath>
 #include <ctime>
 
 #include "common.hpp"
+#include "hot_log.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
 
 using std::chrono::duration_cast;
 using std::chrono::high_resolution_clock;
@@ -186,11 +190,26 @@ void BuffPredictor::MatchPredict() {
   if (state == component::BuffState::kSMALL) {
     theta = PredictIntegralRotatedAngle(GetTime());
     if (direction_ == component::Direction::kCW) theta = -theta;
+    theta = theta / 180 * CV_PI;
   } else if (state == component::BuffState::kBIG) {
-    theta = CalRotatedAngle(filter_.Predict(buff_.GetTarget().ImageCenter()),
-                            buff_.GetCenter());
+    const double t = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now().time_since_epoch())
+                         .count();
+    const double angle =
+        CalRotatedAngle(buff_.GetTarget().ImageCenter(), buff_.GetCenter());
+    fitter_.Update(t, angle);
+
+    /* CalRotatedAngle 与 RotateArmor 的正方向相反 */
+    if (fitter_.Ready()) {
+      theta = -fitter_.PredictRotatedAngle(t, params_.delay_time);
+      SPDLOG_DEBUG("Fitted a : {}, w : {}, b : {}", fitter_.GetAmplitude(),
+                   fitter_.GetOmega(), fitter_.GetOffset());
+    } else {
+      const double predict_angle = CalRotatedAngle(
+          filter_.Predict(buff_.GetTarget().ImageCenter()), buff_.GetCenter());
+      theta = -std::remainder(predict_angle - angle, 2. * CV_PI);
+    }
   }
-  theta = theta / 180 * CV_PI;
   Armor armor = RotateArmor(theta);
   /* 没有Buff对应的模型，并且在当时情况下不可能有哨兵，故用kSENTRY代替 */
   armor.SetModel(game::Model::kSENTRY);
@@ -252,6 +271,11 @@ BuffPredictor::BuffPredictor(const std::string &param) {
   SPDLOG_INFO("Filter init");
 #endif
   LoadParams(param);
+  if (params_.is_KF && params_.Q_mat(0, 0) > 0 && params_.R_mat(0, 0) > 0) {
+    std::vector<double> noise_vec = {4., 2., params_.Q_mat(0, 0),
+                                     params_.R_mat(0, 0)};
+    filter_.Init(noise_vec);
+  }
   SPDLOG_INFO("Param init");
 
   //* 2nd. robot relation init
@@ -382,11 +406,13 @@ void BuffPredictor::SetRace(game::Race race) {
  * @return tbb::concurrent_vector<Armor> 返回预测装甲板
  */
 const tbb::concurrent_vector<Armor> &BuffPredictor::Predict() {
+  TRACE_SPAN("predict");
+  METRICS_LATENCY("predict");
   predicts_.clear();
-  SPDLOG_WARN("Predicting.");
+  HOT_LOG(SPDLOG_TRACE, "Predicting.");
   MatchDirection();
   MatchPredict();
-  SPDLOG_WARN("Predicted.");
+  HOT_LOG(SPDLOG_TRACE, "Predicted.");
   return predicts_;
 }
 
@@ -10,6 +10,7 @@
 #include "kalman.hpp"
 #include "opencv2/opencv.hpp"
 #include "predictor.hpp"
+#include "sine_fitter.hpp"
 
 // TODO : 修改参数，使KF可以上场使用
 
@@ -32,6 +33,7 @@ class BuffPredictor : public Predictor<Armor, BuffPredictorParam, Kalman> {
   Buff buff_;
   std::chrono::system_clock::time_point end_time_;
   std::vector<cv::Point2f> circumference_;
+  SineFitter fitter_;
   component::Timer duration_direction_, duration_predict_;
 
   void InitDefaultParams(const std::string &path);
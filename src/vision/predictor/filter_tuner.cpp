@@ -0,0 +1,188 @@
+#include "filter_tuner.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include "ekf.hpp"
+#include "kalman.hpp"
+#include "spdlog/spdlog.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+namespace {
+
+/* 滤波器收敛前的帧不计入误差 */
+const std::size_t kWARMUP = 10;
+
+/* 与 BuffPredictor::InitDefaultParams 保持一致 */
+const double kDELAY_TIME = 0.1542;
+const int kERROR_FRAME = 5;
+
+double LogSpace(const cv::Vec2d &range, double ratio) {
+  return std::pow(10., std::log10(range[0]) +
+                           ratio * (std::log10(range[1]) -
+                                    std::log10(range[0])));
+}
+
+}  // namespace
+
+FilterTuner::FilterTuner() { SPDLOG_TRACE("Constructed."); }
+
+FilterTuner::~FilterTuner() { SPDLOG_TRACE("Destructed."); }
+
+bool FilterTuner::LoadLog(const std::string &path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    SPDLOG_ERROR("Can not open file: '{}'", path);
+    return false;
+  }
+
+  std::string line, field;
+  std::size_t line_no = 0;
+  while (std::getline(file, line)) {
+    ++line_no;
+    if (line.empty() || line.front() == '#') continue;
+
+    std::stringstream stream(line);
+    std::vector<double> values;
+    try {
+      while (std::getline(stream, field, ','))
+        values.push_back(std::stod(field));
+    } catch (const std::logic_error &) {
+      /* 未注释的表头或空字段等，std::stod 抛出 invalid_argument 或
+       * out_of_range */
+      SPDLOG_WARN("Line {} of '{}' is not numeric, skipped.", line_no, path);
+      continue;
+    }
+
+    /* 第一列为时间戳，回放按帧进行，不使用 */
+    if (values.size() < 2) continue;
+    AddMeasurement(std::vector<double>(values.begin() + 1, values.end()));
+  }
+  SPDLOG_INFO("Loaded {} frames of {}-dim measurements.", measurements_.size(),
+              dims_);
+  return !measurements_.empty();
+}
+
+void FilterTuner::AddMeasurement(const std::vector<double> &measurement) {
+  if (dims_ == 0) dims_ = measurement.size();
+  if (measurement.size() != dims_) {
+    SPDLOG_WARN("Measurement dims {} != {}, skipped.", measurement.size(),
+                dims_);
+    return;
+  }
+  measurements_.emplace_back(cv::Mat(measurement, true));
+}
+
+void FilterTuner::GridSearch(const cv::Vec2d &q_range,
+                             const cv::Vec2d &r_range, int steps) {
+  if (configs_.empty()) configs_.push_back({Method::kEKF, 0., 0.});
+
+  const double denom = std::max(steps - 1, 1);
+  for (int i = 0; i < steps; ++i)
+    for (int j = 0; j < steps; ++j)
+      configs_.push_back({Method::kKF, LogSpace(q_range, i / denom),
+                          LogSpace(r_range, j / denom)});
+}
+
+void FilterTuner::RandomSearch(const cv::Vec2d &q_range,
+                               const cv::Vec2d &r_range, int count,
+                               uint64_t seed) {
+  if (configs_.empty()) configs_.push_back({Method::kEKF, 0., 0.});
+
+  std::mt19937_64 gen(seed);
+  std::uniform_real_distribution<double> dist(0., 1.);
+  for (int i = 0; i < count; ++i)
+    configs_.push_back({Method::kKF, LogSpace(q_range, dist(gen)),
+                        LogSpace(r_range, dist(gen))});
+}
+
+TunerResult FilterTuner::Replay(const TunerConfig &config) const {
+  TunerResult result{config, 0., 0., 0};
+
+  /* EKF 尚未完成，其预测即为当前观测，作为不滤波的基准 */
+  std::unique_ptr<Filter> filter;
+  if (config.method == Method::kEKF) {
+    filter = std::make_unique<EKF>();
+    filter->Init(std::vector<double>(5, 0.));
+  } else {
+    filter = std::make_unique<Kalman>();
+    filter->Init({2. * dims_, static_cast<double>(dims_),
+                  config.process_noise, config.measurement_noise});
+  }
+
+  double sum = 0.;
+  for (std::size_t i = 0; i + 1 < measurements_.size(); ++i) {
+    const cv::Mat &predict = filter->Predict(measurements_[i]);
+    if (i < kWARMUP) continue;
+
+    const double err =
+        cv::norm(predict.rowRange(0, dims_), measurements_[i + 1]);
+    sum += err * err;
+    result.max_error = std::max(result.max_error, err);
+    result.frames += 1;
+  }
+  if (result.frames > 0) result.rmse = std::sqrt(sum / result.frames);
+  return result;
+}
+
+const TunerResult &FilterTuner::Run() {
+  results_.resize(configs_.size());
+  SPDLOG_INFO("Evaluating {} configurations.", configs_.size());
+
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, configs_.size()),
+                    [&](const tbb::blocked_range<std::size_t> &range) {
+                      for (auto i = range.begin(); i != range.end(); ++i)
+                        results_[i] = Replay(configs_[i]);
+                    });
+
+  std::sort(results_.begin(), results_.end(),
+            [](const TunerResult &r1, const TunerResult &r2) {
+              return r1.rmse < r2.rmse;
+            });
+  SPDLOG_INFO("Best Q : {}, R : {}, rmse : {}",
+              results_.front().config.process_noise,
+              results_.front().config.measurement_noise,
+              results_.front().rmse);
+  return results_.front();
+}
+
+void FilterTuner::SaveParams(const std::string &path) const {
+  if (results_.empty()) {
+    SPDLOG_ERROR("No result to save.");
+    return;
+  }
+  const TunerResult &best = results_.front();
+  const bool is_ekf = best.config.method == Method::kEKF;
+
+  cv::FileStorage fs(path,
+                     cv::FileStorage::WRITE | cv::FileStorage::FORMAT_JSON);
+  fs << "is_EKF" << is_ekf;
+  fs << "Q_mat" << EKF::Matx55d::eye() * best.config.process_noise;
+  fs << "R_mat" << EKF::Matx33d::eye() * best.config.measurement_noise;
+  fs << "Q_AC_mat" << EKF::Matx55d::eye() * best.config.process_noise;
+  fs << "R_AC_mat" << EKF::Matx33d::eye() * best.config.measurement_noise;
+  fs << "is_KF" << !is_ekf;
+  fs << "delay_time" << kDELAY_TIME;
+  fs << "error_frame" << kERROR_FRAME;
+
+  fs << "tuner"
+     << "{";
+  fs << "rmse" << best.rmse;
+  fs << "max_error" << best.max_error;
+  fs << "frames" << static_cast<int>(best.frames);
+  fs << "configurations" << static_cast<int>(results_.size());
+  fs << "}";
+  SPDLOG_INFO("Saved params to '{}'.", path);
+}
+
+const std::vector<TunerResult> &FilterTuner::GetResults() const {
+  return results_;
+}
+
+std::size_t FilterTuner::GetFrames() const { return measurements_.size(); }
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "filter.hpp"
+#include "opencv2/opencv.hpp"
+
+struct TunerConfig {
+  Method method;
+  double process_noise;
+  double measurement_noise;
+};
+
+struct TunerResult {
+  TunerConfig config;
+  double rmse;
+  double max_error;
+  std::size_t frames;
+};
+
+/**
+ * @brief 离线滤波器调参
+ *
+ * 将记录的逐帧观测回放给不同参数的滤波器，以一步预测与下一帧观测的误差评价，
+ * 所有配置用 TBB 并行评估。
+ */
+class FilterTuner {
+ private:
+  unsigned int dims_ = 0;
+  std::vector<cv::Mat> measurements_;
+  std::vector<TunerConfig> configs_;
+  std::vector<TunerResult> results_;
+
+ public:
+  /**
+   * @brief Construct a new FilterTuner object
+   *
+   */
+  FilterTuner();
+
+  /**
+   * @brief Destroy the FilterTuner object
+   *
+   */
+  ~FilterTuner();
+
+  /**
+   * @brief 读取观测记录
+   *
+   * 每行为 "时间戳,观测1,观测2,..."，以 '#' 开头的行被忽略
+   *
+   * @param path 记录文件路径
+   * @return true 读取成功
+   * @return false 读取失败
+   */
+  bool LoadLog(const std::string &path);
+
+  /**
+   * @brief 追加一帧观测
+   *
+   * @param measurement 观测值
+   */
+  void AddMeasurement(const std::vector<double> &measurement);
+
+  /**
+   * @brief 在对数网格上生成 Q/R 配置
+   *
+   * @param q_range Q 系数范围
+   * @param r_range R 系数范围
+   * @param steps 每个维度的采样数
+   */
+  void GridSearch(const cv::Vec2d &q_range, const cv::Vec2d &r_range,
+                  int steps);
+
+  /**
+   * @brief 在对数空间内随机生成 Q/R 配置
+   *
+   * @param q_range Q 系数范围
+   * @param r_range R 系数范围
+   * @param count 配置数量
+   * @param seed 随机种子
+   */
+  void RandomSearch(const cv::Vec2d &q_range, const cv::Vec2d &r_range,
+                    int count, uint64_t seed = 0);
+
+  /**
+   * @brief 用一个配置回放全部观测
+   *
+   * @param config 滤波器配置
+   * @return TunerResult 误差统计
+   */
+  TunerResult Replay(const TunerConfig &config) const;
+
+  /**
+   * @brief 并行评估全部配置
+   *
+   * @return const TunerResult& 误差最小的结果
+   */
+  const TunerResult &Run();
+
+  /**
+   * @brief 以 BuffPredictor 参数格式保存最优结果和误差统计
+   *
+   * @param path 参数文件路径
+   */
+  void SaveParams(const std::string &path) const;
+
+  const std::vector<TunerResult> &GetResults() const;
+  std::size_t GetFrames() const;
+};
@@ -2,6 +2,7 @@
 
 #include <cmath>
 
+#include "hot_log.hpp"
 #include "spdlog/spdlog.h"
 
 namespace {
@@ -14,9 +15,14 @@ const cv::Point2d kSIZE2(kWIDTH / kSCALIONGFACTOR, kHEIGHT / kSCALIONGFACTOR);
 const cv::Point3d kSIZE3(kWIDTH / kSCALIONGFACTOR, kHEIGHT / kSCALIONGFACTOR,
                          std::sqrt(kWIDTH* kHEIGHT) / kSCALIONGFACTOR);
 
+const double kPROCESS_NOISE = 0.03;
+const double kMEASUREMENT_NOISE = 1.;
+
 }  // namespace
 
-void Kalman::InnerInit(int states = 4, int measurements = 2) {
+void Kalman::InnerInit(int states = 4, int measurements = 2,
+                       double process_noise = kPROCESS_NOISE,
+                       double measurement_noise = kMEASUREMENT_NOISE) {
   states_ = states;
   measurements_ = measurements;
   error_frame_ = 0;
@@ -44,11 +50,12 @@ void Kalman::InnerInit(int states = 4, int measurements = 2) {
 
   //* R 测量噪声方差矩阵
   kalman_filter_.measurementNoiseCov =
-      cv::Mat_<double>::eye(measurements, measurements);
+      cv::Mat_<double>::eye(measurements, measurements) * measurement_noise;
 
   //* Q 系统噪声方差矩阵
   // cv::setIdentity(kalman_filter_.processNoiseCov, cv::Scalar::all(1e-5));
-  kalman_filter_.processNoiseCov = cv::Mat_<double>::eye(states, states) * 0.03;
+  kalman_filter_.processNoiseCov =
+      cv::Mat_<double>::eye(states, states) * process_noise;
 
   //* P 后验错误估计协方差矩阵
   /* cv::setIdentity(kalman_filter_.errorCovPost, cv::Scalar::all(1)); */
@@ -68,12 +75,12 @@ void Kalman::InnerInit(int states = 4, int measurements = 2) {
 }
 
 Kalman::Kalman() {
-  InnerInit(4, 2);
+  InnerInit(4, 2, kPROCESS_NOISE, kMEASUREMENT_NOISE);
   SPDLOG_TRACE("Constructed.");
 }
 
 Kalman::Kalman(int states, int measurements) {
-  InnerInit(states, measurements);
+  InnerInit(states, measurements, kPROCESS_NOISE, kMEASUREMENT_NOISE);
   SPDLOG_TRACE("Constructed.");
 }
 
@@ -82,7 +89,12 @@ Kalman::~Kalman() { SPDLOG_TRACE("Destructed."); }
 void Kalman::Init(const std::vector<double>& vec) {
   if (method_ == Method::kUNKNOWN) method_ = Method::kKF;
   SPDLOG_WARN("{}, {}", vec[0], vec[1]);
-  InnerInit(static_cast<int>(vec[0]), static_cast<int>(vec[1]));
+  if (vec.size() >= 4)
+    InnerInit(static_cast<int>(vec[0]), static_cast<int>(vec[1]), vec[2],
+              vec[3]);
+  else
+    InnerInit(static_cast<int>(vec[0]), static_cast<int>(vec[1]),
+              kPROCESS_NOISE, kMEASUREMENT_NOISE);
 }
 
 const cv::Point2d Kalman::Predict(const cv::Point2d& measurements_point) {
@@ -97,20 +109,25 @@ const cv::Point2d Kalman::Predict(const cv::Point2d& measurements_point) {
     error_frame_ += 1;
   else if (measurements_point == cv::Point2d(0., 0.))
     error_frame_ += 1;
+  else
+    error_frame_ = 0;
 
   if (error_frame_ > 0 && error_frame_ < 5)
     cur_measure_matx_ = last_predict_matx_.rowRange(0, 2);
   else {
+    error_frame_ = 0;
     cv::Mat measurements = cv::Mat_<double>::zeros(2, 1);
     measurements.at<double>(0, 0) = measurements_point.x;
     measurements.at<double>(0, 1) = measurements_point.y;
     cur_measure_matx_ = measurements;
   }
 
-  SPDLOG_WARN("Error frames count : {}", error_frame_);
+  if (error_frame_ > 0)
+    HOT_LOG_EVERY_MS(SPDLOG_WARN, 1000, "Error frames count : {}",
+                     error_frame_);
   cur_predict_matx_ = kalman_filter_.correct(cur_measure_matx_);
   cur_predict_matx_ = kalman_filter_.predict();
-  SPDLOG_WARN("Predicted.");
+  HOT_LOG(SPDLOG_TRACE, "Predicted.");
   return cv::Point2d(cur_predict_matx_.at<double>(0, 0),
                      cur_predict_matx_.at<double>(0, 1));
 }
@@ -129,10 +146,13 @@ const cv::Point3d Kalman::Predict(const cv::Point3d& measurements_point) {
     error_frame_ += 1;
   else if (measurements_point == cv::Point3d(0., 0., 0.))
     error_frame_ += 1;
+  else
+    error_frame_ = 0;
 
   if (error_frame_ > 0 && error_frame_ < 5)
     cur_measure_matx_ = last_predict_matx_.rowRange(0, 3);
   else {
+    error_frame_ = 0;
     cv::Mat measurements = cv::Mat_<double>::zeros(3, 1);
     measurements.at<double>(0, 0) = measurements_point.x;
     measurements.at<double>(0, 1) = measurements_point.y;
@@ -140,10 +160,12 @@ const cv::Point3d Kalman::Predict(const cv::Point3d& measurements_point) {
     cur_measure_matx_ = measurements;
   }
 
-  SPDLOG_WARN("Error frames count : {}", error_frame_);
+  if (error_frame_ > 0)
+    HOT_LOG_EVERY_MS(SPDLOG_WARN, 1000, "Error frames count : {}",
+                     error_frame_);
   cur_predict_matx_ = kalman_filter_.correct(cur_measure_matx_);
   cur_predict_matx_ = kalman_filter_.predict();
-  SPDLOG_WARN("Predicted.");
+  HOT_LOG(SPDLOG_TRACE, "Predicted.");
   return cv::Point3d(cur_predict_matx_.at<double>(0, 0),
                      cur_predict_matx_.at<double>(0, 1),
                      cur_predict_matx_.at<double>(0, 2));
@@ -155,7 +177,7 @@ const cv::Mat& Kalman::Predict(const cv::Mat& measurements) {
 
   std::vector<double> measure_value(measurements_);
   std::vector<double> last_measure_value(measurements_);
-  double product = measure_value.size() > 1 ? 1 : measure_value.back();
+  double product = 1;
   const unsigned int edge = std::min(kSIZE2.x, kSIZE2.y);
 
   for (std::size_t i = 0; i < measure_value.size(); i++) {
@@ -164,23 +186,24 @@ const cv::Mat& Kalman::Predict(const cv::Mat& measurements) {
     product *= measure_value[i];
   }
 
-  if (product == 0)
-    error_frame_ += 1;
-  else
-    for (std::size_t i = 0; i < measure_value.size(); i++)
-      if (abs(measure_value[i] - last_measure_value[i]) > edge) {
-        error_frame_ += 1;
-        break;
-      }
+  bool outlier = (product == 0);
+  for (std::size_t i = 0; i < measure_value.size() && !outlier; i++)
+    if (abs(measure_value[i] - last_measure_value[i]) > edge) outlier = true;
+  error_frame_ = outlier ? error_frame_ + 1 : 0;
 
+  /* 连续丢失不超过4帧时用预测值代替观测，超过后认为目标切换 */
   if (error_frame_ > 0 && error_frame_ < 5)
-    cur_measure_matx_ = last_predict_matx_.rowRange(0, states_);
-  else
+    cur_measure_matx_ = last_predict_matx_.rowRange(0, measurements_);
+  else {
+    error_frame_ = 0;
     cur_measure_matx_ = measurements;
+  }
 
-  SPDLOG_WARN("Error frames count : {}", error_frame_);
+  if (error_frame_ > 0)
+    HOT_LOG_EVERY_MS(SPDLOG_WARN, 1000, "Error frames count : {}",
+                     error_frame_);
   cur_predict_matx_ = kalman_filter_.correct(cur_measure_matx_);
   cur_predict_matx_ = kalman_filter_.predict();
-  SPDLOG_WARN("Predicted.");
+  HOT_LOG(SPDLOG_TRACE, "Predicted.");
   return cur_predict_matx_;
 }
@@ -8,13 +8,19 @@ class Kalman : public Filter {
   cv::Mat cur_measure_matx_, last_measure_matx_;
   unsigned int error_frame_;
 
-  void InnerInit(int states, int measurements);
+  void InnerInit(int states, int measurements, double process_noise,
+                 double measurement_noise);
 
  public:
   Kalman();
   Kalman(int states, int measurements);
   ~Kalman();
 
+  /**
+   * @brief 初始化滤波器
+   *
+   * @param vec {状态数, 观测数[, Q 系数, R 系数]}
+   */
   void Init(const std::vector<double>& vec);
 
   const cv::Point2d Predict(const cv::Point2d& measurements_point);
@@ -0,0 +1,167 @@
+#include "sine_fitter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "spdlog/spdlog.h"
+
+namespace {
+
+/* 规则中 w 取值 [1.884, 2.000]，a 取值 [0.780, 1.045]，b = 2.090 - a */
+const double kOMEGA_INIT = 1.942;
+const double kOMEGA_LOW = 1.8;
+const double kOMEGA_HIGH = 2.1;
+const double kOMEGA_PRIOR = 1.;
+
+const double kMIN_INTERVAL = 0.025; /* 采样最小间隔，缓冲区约覆盖一个周期 */
+const double kMAX_SPEED = 2.090;    /* 转速上限 a + b (rad/s) */
+const std::size_t kMIN_SAMPLES = 24;
+const int kITERATIONS = 2;
+const double kDAMPING = 1e-3;
+const double kRIDGE = 1e-9;
+
+/* 五片扇叶均布，切换扇叶时角度跳变其整数倍，两帧间实际转过的角度远小于半个
+ * 扇叶间隔，按扇叶间隔展开即可消去跳变 */
+const double kBLADE_ANGLE = 2. * CV_PI / 5.;
+
+/* 超过此间隔认为目标丢失，重新拟合。最高转速下间隔内转过的角度须小于半个
+ * 扇叶间隔才能正确展开，留 20% 余量，约 0.24s */
+const double kMAX_GAP = 0.8 * (kBLADE_ANGLE / 2.) / kMAX_SPEED;
+
+double WrapAngle(double angle) { return std::remainder(angle, kBLADE_ANGLE); }
+
+}  // namespace
+
+void SineFitter::ShiftOrigin(double t) {
+  const double s = t - t_ref_;
+  const double ws = x_(4) * s;
+  const double cs = std::cos(ws), sn = std::sin(ws);
+  const double p = x_(2), q = x_(3);
+
+  x_(0) += x_(1) * s;
+  x_(2) = p * cs + q * sn;
+  x_(3) = -p * sn + q * cs;
+  t_ref_ = t;
+}
+
+bool SineFitter::LinearInit() {
+  const double w = kOMEGA_INIT;
+  cv::Matx44d jtj = cv::Matx44d::zeros();
+  cv::Vec4d jtr = cv::Vec4d::all(0.);
+
+  for (std::size_t i = 0; i < size_; ++i) {
+    const Sample &sample = samples_[(head_ + kCAPACITY - 1 - i) % kCAPACITY];
+    const double tau = sample.t - t_ref_;
+    const cv::Vec4d j(1., tau, std::cos(w * tau), std::sin(w * tau));
+    jtj += j * j.t();
+    jtr += j * sample.angle;
+  }
+  for (int i = 0; i < 4; ++i) jtj(i, i) += kRIDGE;
+
+  cv::Vec4d sol;
+  if (!cv::solve(jtj, jtr, sol, cv::DECOMP_CHOLESKY)) return false;
+  x_ = Vec5d(sol[0], sol[1], sol[2], sol[3], w);
+  return true;
+}
+
+void SineFitter::GaussNewtonStep() {
+  Matx55d jtj = Matx55d::zeros();
+  Vec5d jtr = Vec5d::zeros();
+  const double c = x_(0), b = x_(1), p = x_(2), q = x_(3), w = x_(4);
+
+  for (std::size_t i = 0; i < size_; ++i) {
+    const Sample &sample = samples_[(head_ + kCAPACITY - 1 - i) % kCAPACITY];
+    const double tau = sample.t - t_ref_;
+    const double cs = std::cos(w * tau), sn = std::sin(w * tau);
+    const double r = sample.angle - (c + b * tau + p * cs + q * sn);
+    const Vec5d j(1., tau, cs, sn, tau * (q * cs - p * sn));
+    jtj += j * j.t();
+    jtr += j * r;
+  }
+
+  for (int i = 0; i < 5; ++i) jtj(i, i) = jtj(i, i) * (1. + kDAMPING) + kRIDGE;
+  jtj(4, 4) += kOMEGA_PRIOR;
+  jtr(4) += kOMEGA_PRIOR * (kOMEGA_INIT - w);
+
+  Vec5d delta;
+  if (!cv::solve(jtj, jtr, delta, cv::DECOMP_CHOLESKY)) {
+    SPDLOG_DEBUG("Singular normal equation.");
+    return;
+  }
+  x_ += delta;
+  x_(4) = std::clamp(x_(4), kOMEGA_LOW, kOMEGA_HIGH);
+}
+
+SineFitter::SineFitter() {
+  Reset();
+  SPDLOG_TRACE("Constructed.");
+}
+
+SineFitter::~SineFitter() { SPDLOG_TRACE("Destructed."); }
+
+void SineFitter::Reset() {
+  head_ = size_ = 0;
+  t_ref_ = last_raw_angle_ = unwrapped_ = 0.;
+  fitted_ = false;
+  x_ = Vec5d(0., 0., 0., 0., kOMEGA_INIT);
+}
+
+void SineFitter::Update(double t, double angle) {
+  if (size_ > 0) {
+    const double gap = t - t_ref_;
+    if (gap < 0. || gap > kMAX_GAP) {
+      SPDLOG_DEBUG("Sample gap {}s, refit.", gap);
+      Reset();
+    }
+  }
+
+  if (size_ == 0) {
+    unwrapped_ = angle;
+  } else {
+    unwrapped_ += WrapAngle(angle - last_raw_angle_);
+    if (t - t_ref_ < kMIN_INTERVAL) {
+      last_raw_angle_ = angle;
+      return;
+    }
+  }
+  last_raw_angle_ = angle;
+
+  samples_[head_] = {t, unwrapped_};
+  head_ = (head_ + 1) % kCAPACITY;
+  size_ = std::min(size_ + 1, kCAPACITY);
+
+  if (fitted_) {
+    ShiftOrigin(t);
+  } else {
+    t_ref_ = t;
+    if (size_ < kMIN_SAMPLES) return;
+    if (!LinearInit()) return;
+    fitted_ = true;
+  }
+
+  for (int i = 0; i < kITERATIONS; ++i) GaussNewtonStep();
+}
+
+bool SineFitter::Ready() const { return fitted_; }
+
+double SineFitter::Speed(double t) const {
+  const double tau = t - t_ref_, w = x_(4);
+  return x_(1) - x_(2) * w * std::sin(w * tau) + x_(3) * w * std::cos(w * tau);
+}
+
+double SineFitter::PredictRotatedAngle(double t, double horizon) const {
+  const double tau = t - t_ref_, w = x_(4);
+  return x_(1) * horizon +
+         x_(2) * (std::cos(w * (tau + horizon)) - std::cos(w * tau)) +
+         x_(3) * (std::sin(w * (tau + horizon)) - std::sin(w * tau));
+}
+
+double SineFitter::GetAmplitude() const {
+  return x_(4) * std::hypot(x_(2), x_(3));
+}
+
+double SineFitter::GetOmega() const { return x_(4); }
+
+double SineFitter::GetOffset() const { return x_(1); }
+
+std::size_t SineFitter::Size() const { return size_; }
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "opencv2/opencv.hpp"
+
+/**
+ * @brief 大能量机关转速 spd = a * sin(w * t) + b 的在线拟合
+ *
+ * 对转速积分得到角度模型
+ * theta(tau) = c + b * tau + p * cos(w * tau) + q * sin(w * tau)，
+ * 其中 tau 为相对最新采样时刻的时间。采样保存在定长环形缓冲区中，
+ * 每帧以上一帧的结果为初值做固定次数的 Gauss-Newton 迭代，单帧开销有上界。
+ */
+class SineFitter {
+ public:
+  typedef cv::Matx<double, 5, 1> Vec5d;
+  typedef cv::Matx<double, 5, 5> Matx55d;
+
+  static const std::size_t kCAPACITY = 128;
+
+ private:
+  struct Sample {
+    double t, angle;
+  };
+
+  std::array<Sample, kCAPACITY> samples_;
+  std::size_t head_, size_;
+
+  double t_ref_;           /* 参数对应的时间原点(最新采样时刻) */
+  double last_raw_angle_;  /* 上一次输入的原始角度 */
+  double unwrapped_;       /* 展开后的累计角度 */
+  bool fitted_;
+
+  Vec5d x_; /* c, b, p, q, w */
+
+  /**
+   * @brief 将参数的时间原点平移到 t
+   *
+   * @param t 新的时间原点
+   */
+  void ShiftOrigin(double t);
+
+  /**
+   * @brief 固定 w，线性最小二乘求解 c, b, p, q
+   *
+   * @return true 求解成功
+   * @return false 矩阵奇异
+   */
+  bool LinearInit();
+
+  /**
+   * @brief 以当前参数为初值做一次 Gauss-Newton 迭代
+   *
+   */
+  void GaussNewtonStep();
+
+ public:
+  /**
+   * @brief Construct a new SineFitter object
+   *
+   */
+  SineFitter();
+
+  /**
+   * @brief Destroy the SineFitter object
+   *
+   */
+  ~SineFitter();
+
+  /**
+   * @brief 清空采样和拟合结果
+   *
+   */
+  void Reset();
+
+  /**
+   * @brief 加入一个采样并更新拟合
+   *
+   * @param t 采样时刻(s)
+   * @param angle 旋转角(rad)，可以是(-pi~pi)内的包裹角，可在扇叶间跳变
+   */
+  void Update(double t, double angle);
+
+  /**
+   * @brief 拟合结果是否可用
+   *
+   * @return true 可用
+   * @return false 采样不足
+   */
+  bool Ready() const;
+
+  /**
+   * @brief 拟合曲线在 t 时刻的角速度
+   *
+   * @param t 时刻(s)
+   * @return double 角速度(rad/s)
+   */
+  double Speed(double t) const;
+
+  /**
+   * @brief 对拟合曲线在 [t, t + horizon] 上做闭式积分
+   *
+   * @param t 起始时刻(s)
+   * @param horizon 预测时长(s)
+   * @return double 旋转过的角度(rad)
+   */
+  double PredictRotatedAngle(double t, double horizon) const;
+
+  double GetAmplitude() const;
+  double GetOmega() const;
+  double GetOffset() const;
+  std::size_t Size() const;
+};
@@ -1,24 +1,53 @@
 #include "aim_assitant.hpp"
 
 #include "armor.hpp"
+#include "tbb/parallel_invoke.h"
 
-void AimAssitant::Sort(const cv::Mat& frame) {
-  cv::Point2f image_center(frame.cols / 2, frame.rows / 2);
-  auto weight = [image_center](Armor armor) {
-    double center_dis = cv::norm(armor.ImageCenter() - image_center);
-    auto corner_points = armor.ImageVertices();
-    std::vector<cv::Point2f> cvt_points;
-    cv::warpPerspective(corner_points, cvt_points, armor.trans_,
-                        armor.face_size_);
-    double diff = 0;
-    for (std::size_t i = 0; i < corner_points.size(); i++)
-      diff += cv::norm((corner_points[i] - cvt_points[i]));
-    return center_dis += diff / 4;
-  };
-
-  std::sort(armors_.begin(), armors_.end(), [weight](Armor iti, Armor itj) {
-    return weight(iti) > weight(itj);
-  });
+namespace {
+
+/* 记录从 start 到现在的耗时 */
+std::chrono::microseconds Elapsed(std::chrono::steady_clock::time_point start,
+                                  component::metrics::Histogram& histogram) {
+  const auto cost = std::chrono::steady_clock::now() - start;
+  histogram.Record(cost);
+  return std::chrono::duration_cast<std::chrono::microseconds>(cost);
+}
+
+}  // namespace
+
+void AimAssitant::Sort(tbb::concurrent_vector<Armor>& armors,
+                       const cv::Mat& frame) {
+  selector_.Select(armors, frame.size());
+}
+
+void AimAssitant::AimArmor(const cv::Mat& frame, bool snipe) {
+  const auto start = std::chrono::steady_clock::now();
+  armor_result_.clear();
+  tbb::concurrent_vector<Armor> armors;
+  if (snipe) {
+    armors = s_detector_.Detect(frame);
+  } else {
+    armors = a_detector_.Detect(frame);
+    for (auto& armor : armors) classifier_.ClassifyModel(armor, frame);
+    Sort(armors, frame);
+  }
+
+  if (!armors.empty()) {
+    a_predictor_.SetArmor(armors.front());
+    armor_result_ = a_predictor_.Predict();
+  }
+  armor_cost_ = Elapsed(start, armor_latency_);
+}
+
+void AimAssitant::AimBuff(const cv::Mat& frame) {
+  const auto start = std::chrono::steady_clock::now();
+  buff_result_.clear();
+  auto buffs = b_detector_.Detect(frame);
+  if (!buffs.empty()) {
+    b_predictor_.SetBuff(buffs.back());
+    buff_result_ = b_predictor_.Predict();
+  }
+  buff_cost_ = Elapsed(start, buff_latency_);
 }
 
 AimAssitant::AimAssitant() { SPDLOG_TRACE("Constructed."); }
@@ -42,6 +71,10 @@ void AimAssitant::LoadParams(const std::string& armor_param,
   b_predictor_.LoadParams(buff_pre_param);
 }
 
+void AimAssitant::LoadSelectParams(const std::string& select_param) {
+  selector_.LoadParams(select_param);
+}
+
 void AimAssitant::SetEnemyTeam(game::Team enemy_team) {
   a_detector_.SetEnemyTeam(enemy_team);
   b_detector_.SetTeam(enemy_team);
@@ -90,27 +123,38 @@ void AimAssitant::SetRace(game::Race race) { b_predictor_.SetRace(race); }
 
 void AimAssitant::SetTime(double time) { b_predictor_.SetTime(time); }
 
+void AimAssitant::SetConcurrent(bool concurrent) {
+  concurrent_ = concurrent;
+  SPDLOG_INFO("Concurrent aiming : {}", concurrent_);
+}
+
 const tbb::concurrent_vector<Armor>& AimAssitant::Aim(const cv::Mat& frame) {
   armors_.clear();
   if (method_ == component::AimMethod::kUNKNOWN) {
     method_ = component::AimMethod::kARMOR;
   }
 
-  if (method_ == component::AimMethod::kBUFF) {
-    auto buffs = b_detector_.Detect(frame);
-    b_predictor_.SetBuff(buffs.back());
-    armors_ = b_predictor_.Predict();
+  if (concurrent_ && method_ != component::AimMethod::kSNIPE) {
+    /* 两条流水线互不共享状态，在同一个 arena 中并行，内部的并行算法共用线程 */
+    const auto start = std::chrono::steady_clock::now();
+    arena_.execute([&] {
+      tbb::parallel_invoke([&] { AimArmor(frame, false); },
+                           [&] { AimBuff(frame); });
+    });
+    aim_cost_ = Elapsed(start, aim_latency_);
+    SPDLOG_DEBUG("Armor : {}us, Buff : {}us, Wall : {}us", armor_cost_.count(),
+                 buff_cost_.count(), aim_cost_.count());
+
+    if (method_ == component::AimMethod::kBUFF)
+      armors_ = buff_result_;
+    else
+      armors_ = armor_result_;
+  } else if (method_ == component::AimMethod::kBUFF) {
+    AimBuff(frame);
+    armors_ = buff_result_;
   } else {
-    if (method_ == component::AimMethod::kARMOR) {
-      armors_ = a_detector_.Detect(frame);
-      for (auto& armor : armors_) classifier_.ClassifyModel(armor, frame);
-      Sort(frame);
-    } else if (method_ == component::AimMethod::kSNIPE) {
-      armors_ = s_detector_.Detect(frame);
-    }
-
-    a_predictor_.SetArmor(armors_.front());
-    armors_ = a_predictor_.Predict();
+    AimArmor(frame, method_ == component::AimMethod::kSNIPE);
+    armors_ = armor_result_;
   }
   return armors_;
 }
@@ -126,4 +170,12 @@ void AimAssitant::VisualizeResult(const cv::Mat& frame, int add_label) {
     s_detector_.VisualizeResult(frame, add_label);
     a_predictor_.VisualizePrediction(frame, add_label);
   }
+  if (concurrent_ && add_label > 1) {
+    std::string label =
+        cv::format("Armor %ld us, Buff %ld us, Aim %ld us",
+                   static_cast<long>(armor_cost_.count()),
+                   static_cast<long>(buff_cost_.count()),
+                   static_cast<long>(aim_cost_.count()));
+    draw::VisualizeLabel(frame, label, 4);
+  }
 }
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <chrono>
+
 #include "armor_classifier.hpp"
 #include "armor_detector.hpp"
 #include "armor_predictor.hpp"
 #include "buff_detector.hpp"
 #include "buff_predictor.hpp"
 #include "common.hpp"
+#include "metrics.hpp"
 #include "snipe_detector.hpp"
+#include "target_selector.hpp"
+#include "tbb/task_arena.h"
 
 class AimAssitant {
  private:
@@ -16,12 +21,28 @@ class AimAssitant {
   BuffPredictor b_predictor_;
   SnipeDetector s_detector_;
   ArmorClassifier classifier_;
+  TargetSelector selector_;
 
   tbb::concurrent_vector<Armor> armors_;
   component::AimMethod method_ = component::AimMethod::kUNKNOWN;
   game::Arm arm_ = game::Arm::kUNKNOWN;
 
-  void Sort(const cv::Mat& frame);
+  /* 并发模式下装甲板和能量机关流水线同时运行，切换方法时只切换输出 */
+  bool concurrent_ = false;
+  tbb::task_arena arena_;
+  tbb::concurrent_vector<Armor> armor_result_, buff_result_;
+  /* 各流水线本帧的耗时，单级不到 1ms，按 us 计并记入直方图以比较分布 */
+  std::chrono::microseconds armor_cost_{0}, buff_cost_{0}, aim_cost_{0};
+  component::metrics::Histogram &armor_latency_ =
+      component::metrics::GetHistogram("aim.armor");
+  component::metrics::Histogram &buff_latency_ =
+      component::metrics::GetHistogram("aim.buff");
+  component::metrics::Histogram &aim_latency_ =
+      component::metrics::GetHistogram("aim.concurrent");
+
+  void Sort(tbb::concurrent_vector<Armor>& armors, const cv::Mat& frame);
+  void AimArmor(const cv::Mat& frame, bool snipe);
+  void AimBuff(const cv::Mat& frame);
 
  public:
   AimAssitant();
@@ -32,6 +53,7 @@ class AimAssitant {
                   const std::string& snipe_param,
                   const std::string& armor_pre_param,
                   const std::string& buff_pre_param);
+  void LoadSelectParams(const std::string& select_param);
   void SetClassiferParam(const std::string model_path,
                          const std::string lable_path,
                          const cv::Size& input_size);
@@ -40,6 +62,7 @@ class AimAssitant {
   void SetArm(game::Arm arm);
   void SetRace(game::Race race);
   void SetTime(double time);
+  void SetConcurrent(bool concurrent);
 
   const tbb::concurrent_vector<Armor>& Aim(const cv::Mat& frame);
 
@@ -0,0 +1,181 @@
+#include "target_selector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "spdlog/spdlog.h"
+
+namespace {
+
+const std::size_t kTOP_K = 3;
+const double kDISPERSION = 6.;
+const double kTRACK_GATE = 40.; /* 同一目标相邻两帧中心的最大像素距离 */
+const int kMAX_AGE = 30;
+
+const TargetFeature kWEIGHTS{-1., -0.5, 1., 1., 0.5, 1.};
+
+double Priority(game::Model model) {
+  switch (model) {
+    case game::Model::kHERO:
+    case game::Model::kBUFF:
+      return 1.;
+    case game::Model::kINFANTRY:
+    case game::Model::kSENTRY:
+      return 0.8;
+    case game::Model::kOUTPOST:
+      return 0.6;
+    case game::Model::kENGINEER:
+      return 0.3;
+    case game::Model::kDRONE:
+      return 0.2;
+    default:
+      return 0.5;
+  }
+}
+
+}  // namespace
+
+LinearPolicy::LinearPolicy() : weights_(kWEIGHTS) {
+  SPDLOG_TRACE("Constructed.");
+}
+
+LinearPolicy::LinearPolicy(const TargetFeature &weights) : weights_(weights) {
+  SPDLOG_TRACE("Constructed.");
+}
+
+LinearPolicy::~LinearPolicy() { SPDLOG_TRACE("Destructed."); }
+
+double LinearPolicy::Score(const TargetFeature &feature) const {
+  return weights_.center_dist * feature.center_dist +
+         weights_.skew * feature.skew + weights_.size * feature.size +
+         weights_.priority * feature.priority +
+         weights_.track_age * feature.track_age +
+         weights_.hit_prob * feature.hit_prob;
+}
+
+int TargetSelector::TrackAge(const Armor &armor) const {
+  int age = 0;
+  double min_dist = kTRACK_GATE;
+  for (auto &track : tracks_) {
+    if (track.model != armor.GetModel()) continue;
+    const double dist = cv::norm(track.center - armor.ImageCenter());
+    if (dist < min_dist) {
+      min_dist = dist;
+      age = track.age;
+    }
+  }
+  return age + 1;
+}
+
+TargetFeature TargetSelector::Extract(const Armor &armor,
+                                      const cv::Size &frame_size) {
+  const cv::Point2f frame_center(frame_size.width / 2.f,
+                                 frame_size.height / 2.f);
+  const std::vector<cv::Point2f> &pts = armor.image_vertices_;
+  const int age = TrackAge(armor);
+  next_tracks_.push_back({armor.ImageCenter(), armor.GetModel(), age});
+
+  TargetFeature feature;
+  feature.center_dist = cv::norm(armor.ImageCenter() - frame_center) /
+                        cv::norm(cv::Point2f(frame_center));
+  feature.priority = priority_[static_cast<std::size_t>(armor.GetModel())];
+  feature.track_age = std::min(age, kMAX_AGE) / static_cast<double>(kMAX_AGE);
+  if (pts.size() != 4) {
+    feature.skew = feature.size = feature.hit_prob = 0.;
+    return feature;
+  }
+
+  /* 依次为四条边，0、2 和 1、3 分别为对边 */
+  double edges[4];
+  for (int i = 0; i < 4; ++i) edges[i] = cv::norm(pts[(i + 1) % 4] - pts[i]);
+  const double a = (edges[0] + edges[2]) / 2., b = (edges[1] + edges[3]) / 2.;
+  feature.skew = (a > 0. ? std::abs(edges[0] - edges[2]) / (2. * a) : 0.) +
+                 (b > 0. ? std::abs(edges[1] - edges[3]) / (2. * b) : 0.);
+
+  double area = 0.;
+  for (int i = 0; i < 4; ++i) area += pts[i].cross(pts[(i + 1) % 4]);
+  feature.size = std::sqrt(std::abs(area) / 2. / frame_size.area());
+
+  /* 瞄准点服从各向同性高斯分布时落入装甲板的概率 */
+  const double sigma = std::sqrt(2.) * dispersion_;
+  feature.hit_prob = std::erf(a / 2. / sigma) * std::erf(b / 2. / sigma);
+  return feature;
+}
+
+TargetSelector::TargetSelector()
+    : policy_(new LinearPolicy()), top_k_(kTOP_K), dispersion_(kDISPERSION) {
+  for (std::size_t i = 0; i < kMODELS; ++i)
+    priority_[i] = Priority(static_cast<game::Model>(i));
+  SPDLOG_TRACE("Constructed.");
+}
+
+TargetSelector::~TargetSelector() { SPDLOG_TRACE("Destructed."); }
+
+bool TargetSelector::LoadParams(const std::string &params_path) {
+  cv::FileStorage fs(params_path,
+                     cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+  if (!fs.isOpened()) {
+    SPDLOG_ERROR("Can not load params.");
+    return false;
+  }
+
+  if (!fs["top_k"].empty()) top_k_ = static_cast<int>(fs["top_k"]);
+  if (!fs["dispersion"].empty()) dispersion_ = fs["dispersion"];
+
+  cv::FileNode node = fs["priority"];
+  for (auto it = node.begin(); it != node.end(); ++it) {
+    const game::Model model = game::StringToModel((*it).name());
+    priority_[static_cast<std::size_t>(model)] = static_cast<double>(*it);
+  }
+
+  node = fs["weights"];
+  if (!node.empty()) {
+    TargetFeature weights = kWEIGHTS;
+    if (!node["center_dist"].empty()) weights.center_dist = node["center_dist"];
+    if (!node["skew"].empty()) weights.skew = node["skew"];
+    if (!node["size"].empty()) weights.size = node["size"];
+    if (!node["priority"].empty()) weights.priority = node["priority"];
+    if (!node["track_age"].empty()) weights.track_age = node["track_age"];
+    if (!node["hit_prob"].empty()) weights.hit_prob = node["hit_prob"];
+    policy_.reset(new LinearPolicy(weights));
+  }
+  SPDLOG_DEBUG("Loaded params.");
+  return true;
+}
+
+void TargetSelector::SetPolicy(std::unique_ptr<SelectionPolicy> policy) {
+  if (policy) policy_ = std::move(policy);
+}
+
+std::size_t TargetSelector::Select(tbb::concurrent_vector<Armor> &armors,
+                                   const cv::Size &frame_size) {
+  const std::size_t n = armors.size();
+  features_.resize(n);
+  scores_.resize(n);
+  order_.resize(n);
+  next_tracks_.clear();
+
+  for (std::size_t i = 0; i < n; ++i) {
+    features_[i] = Extract(armors[i], frame_size);
+    scores_[i] = policy_->Score(features_[i]);
+  }
+  tracks_.swap(next_tracks_);
+
+  const std::size_t k = std::min(top_k_, n);
+  std::iota(order_.begin(), order_.end(), 0);
+  std::partial_sort(order_.begin(), order_.begin() + k, order_.end(),
+                    [this](std::size_t i, std::size_t j) {
+                      return scores_[i] > scores_[j];
+                    });
+
+  if (!std::is_sorted(order_.begin(), order_.end())) {
+    tbb::concurrent_vector<Armor> sorted;
+    sorted.reserve(n);
+    for (auto i : order_) sorted.push_back(armors[i]);
+    armors.swap(sorted);
+  }
+  return k;
+}
+
+std::size_t TargetSelector::GetTopK() const { return top_k_; }
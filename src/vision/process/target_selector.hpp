@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "armor.hpp"
+#include "common.hpp"
+#include "tbb/concurrent_vector.h"
+
+/* 候选目标的特征，每帧每个装甲板只计算一次 */
+struct TargetFeature {
+  double center_dist; /* 到画面中心的距离，按半对角线归一化 */
+  double skew;        /* 对边长度差异，越大越偏离正对 */
+  double size;        /* 面积占画面的比例 */
+  double priority;    /* 兵种优先级 */
+  double track_age;   /* 连续跟踪的帧数，归一化到 [0, 1] */
+  double hit_prob;    /* 按瞄准散布估计的命中概率 */
+};
+
+/**
+ * @brief 目标打分策略，分数越高越优先
+ *
+ */
+class SelectionPolicy {
+ public:
+  virtual ~SelectionPolicy() = default;
+
+  virtual double Score(const TargetFeature &feature) const = 0;
+};
+
+/**
+ * @brief 特征的线性加权
+ *
+ */
+class LinearPolicy : public SelectionPolicy {
+ private:
+  TargetFeature weights_;
+
+ public:
+  LinearPolicy();
+  explicit LinearPolicy(const TargetFeature &weights);
+  ~LinearPolicy();
+
+  double Score(const TargetFeature &feature) const override;
+};
+
+/**
+ * @brief 目标选择
+ *
+ * 每个装甲板只提取一次特征并打分，再部分排序取出前 K 个，避免在比较函数中
+ * 重复计算。策略可替换，参数和线性策略的权重可从 JSON 载入。
+ */
+class TargetSelector {
+ private:
+  struct Track {
+    cv::Point2f center;
+    game::Model model;
+    int age;
+  };
+
+  static const std::size_t kMODELS =
+      static_cast<std::size_t>(game::Model::kBUFF) + 1;
+
+  std::unique_ptr<SelectionPolicy> policy_;
+  std::size_t top_k_;
+  double dispersion_; /* 瞄准散布的标准差(px) */
+  std::array<double, kMODELS> priority_;
+
+  std::vector<Track> tracks_, next_tracks_;
+  std::vector<TargetFeature> features_;
+  std::vector<double> scores_;
+  std::vector<std::size_t> order_;
+
+  int TrackAge(const Armor &armor) const;
+  TargetFeature Extract(const Armor &armor, const cv::Size &frame_size);
+
+ public:
+  TargetSelector();
+  ~TargetSelector();
+
+  /**
+   * @brief 从 JSON 载入参数和线性策略的权重
+   *
+   * @param params_path 参数路径
+   * @return true 载入成功
+   * @return false 载入失败，保持原参数
+   */
+  bool LoadParams(const std::string &params_path);
+
+  /**
+   * @brief 替换打分策略
+   *
+   * @param policy 策略
+   */
+  void SetPolicy(std::unique_ptr<SelectionPolicy> policy);
+
+  /**
+   * @brief 对装甲板打分，将前 K 个按分数降序排到最前
+   *
+   * @param armors 装甲板
+   * @param frame_size 画面尺寸
+   * @return std::size_t 选出的目标数量
+   */
+  std::size_t Select(tbb::concurrent_vector<Armor> &armors,
+                     const cv::Size &frame_size);
+
+  std::size_t GetTopK() const;
+};
@@ -0,0 +1,94 @@
+#include "visualizer.hpp"
+
+#include "spdlog/spdlog.h"
+#include "thread_policy.hpp"
+#include "trace.hpp"
+
+namespace {
+
+/* 只缓存最新的两帧，显示跟不上时丢弃旧帧 */
+const std::size_t kQUEUE_SIZE = 2;
+const int kPOP_TIMEOUT = 100; /* ms，超时后检查线程是否需要退出 */
+
+}  // namespace
+
+void Visualizer::Draw(Snapshot &snapshot) {
+  TRACE_SPAN("visualize");
+  /* 单线程顺序绘制，不与其他线程同时写同一张图 */
+  if (verbose_ > 2) {
+    for (auto &bar : snapshot.bars)
+      bar.VisualizeObject(snapshot.frame, true, draw::kGREEN,
+                          cv::MARKER_CROSS);
+  }
+  for (auto &armor : snapshot.armors)
+    armor.VisualizeObject(snapshot.frame, verbose_ > 2);
+  for (std::size_t i = 0; i < snapshot.labels.size(); ++i)
+    draw::VisualizeLabel(snapshot.frame, snapshot.labels[i],
+                        static_cast<int>(i) + 1);
+}
+
+void Visualizer::ThreadShow() {
+  SPDLOG_DEBUG("[ThreadShow] Started.");
+  component::thread_policy::Apply("ThreadShow");
+
+  bool paused = false;
+  Snapshot snapshot;
+  while (running_) {
+    if (queue_.Pop(snapshot, kPOP_TIMEOUT) && !paused) {
+      component::trace::SetFrame(snapshot.frame_id);
+      /* 原图可能仍在录制队列中，绘制在副本上 */
+      snapshot.frame = snapshot.frame.clone();
+      Draw(snapshot);
+      if (server_) server_->Post(snapshot.frame);
+      if (!headless_) cv::imshow(window_, snapshot.frame);
+    }
+    if (headless_) continue;
+
+    /* 没有新快照时也处理按键，空格暂停画面，主循环不受影响 */
+    const int key = cv::waitKey(1);
+    if (' ' == key)
+      paused = !paused;
+    else if (key >= 0)
+      key_ = key;
+  }
+  SPDLOG_DEBUG("[ThreadShow] Stoped.");
+}
+
+Visualizer::Visualizer(const std::string &window, bool headless,
+                       std::size_t decimation, int verbose,
+                       component::DebugServer *server)
+    : window_(window),
+      headless_(headless),
+      server_(server),
+      decimation_(decimation > 0 ? decimation : 1),
+      verbose_(verbose),
+      count_(0),
+      queue_(kQUEUE_SIZE),
+      drop_count_(component::metrics::GetCounter("visualizer.dropped")),
+      key_(-1),
+      running_(!headless || server) {
+  if (running_)
+    thread_ = std::thread(&Visualizer::ThreadShow, this);
+  else
+    SPDLOG_INFO("Headless, visualization disabled.");
+  SPDLOG_TRACE("Constructed.");
+}
+
+Visualizer::~Visualizer() {
+  running_ = false;
+  queue_.Interrupt();
+  if (thread_.joinable()) thread_.join();
+  SPDLOG_TRACE("Destructed.");
+}
+
+bool Visualizer::Wanted() {
+  if (headless_ && !(server_ && server_->Streaming())) return false;
+  return count_++ % decimation_ == 0;
+}
+
+void Visualizer::Post(Snapshot &&snapshot) {
+  if (!running_) return;
+  if (queue_.Push(std::move(snapshot))) drop_count_.Add();
+}
+
+int Visualizer::TakeKey() { return key_.exchange(-1); }
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "armor.hpp"
+#include "debug_server.hpp"
+#include "drop_queue.hpp"
+#include "light_bar.hpp"
+#include "metrics.hpp"
+#include "opencv2/opencv.hpp"
+#include "tbb/concurrent_vector.h"
+
+/**
+ * @brief 在单独线程中绘制并显示调试画面
+ *
+ * 视觉主循环只提交快照，绘制、imshow 与 waitKey 都在显示线程中进行。队列
+ * 满时丢弃最旧的快照，显示过慢不会拖慢主循环。无界面时若有 DebugServer，
+ * 只在有客户端观看时绘制并推流，否则不接收快照。
+ */
+class Visualizer {
+ public:
+  /* 一帧的检测结果，提交后由显示线程独占 */
+  struct Snapshot {
+    cv::Mat frame; /* 显示线程绘制在副本上，提交后生产方不应再写入 */
+    uint64_t frame_id;
+    tbb::concurrent_vector<LightBar> bars;
+    tbb::concurrent_vector<Armor> armors;
+    std::vector<std::string> labels;
+  };
+
+ private:
+  std::string window_;
+  bool headless_;
+  component::DebugServer *server_;
+  std::size_t decimation_;
+  int verbose_;
+  uint64_t count_;
+
+  component::DropQueue<Snapshot> queue_;
+  component::metrics::Counter &drop_count_;
+  std::atomic<int> key_;
+  std::atomic<bool> running_;
+  std::thread thread_;
+
+  void ThreadShow();
+  void Draw(Snapshot &snapshot);
+
+ public:
+  /**
+   * @brief Construct a new Visualizer object
+   *
+   * @param window 窗口名
+   * @param headless 无界面，不绘制
+   * @param decimation 每隔几帧显示一帧
+   * @param verbose 绘制的详细程度，大于 2 时绘制灯条并标注装甲板
+   * @param server 推流的服务，可为空
+   */
+  Visualizer(const std::string &window, bool headless,
+             std::size_t decimation = 1, int verbose = 10,
+             component::DebugServer *server = nullptr);
+
+  /**
+   * @brief Destroy the Visualizer object
+   *
+   */
+  ~Visualizer();
+
+  /**
+   * @brief 本帧是否需要提交，每帧调用一次。无界面且无人观看推流，或被抽掉
+   * 时为 false，此时不必生成快照
+   *
+   * @return true 需要提交
+   * @return false 不需要
+   */
+  bool Wanted();
+
+  /**
+   * @brief 提交快照，不阻塞
+   *
+   * @param snapshot 快照
+   */
+  void Post(Snapshot &&snapshot);
+
+  /**
+   * @brief 取走显示窗口中最近一次的按键，空格由显示线程用于暂停
+   *
+   * @return int 按键，没有时为 -1
+   */
+  int TakeKey();
+};
@@ -0,0 +1,21 @@
+#include "ballistic_table.hpp"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+/* 查表为双线性插值，单次应在 1us 以内 */
+void BallisticTableSolve(benchmark::State &state) {
+  BallisticTable table;
+  table.Init(15.);
+  int i = 0;
+  for (auto _ : state) {
+    double pitch, time;
+    table.Solve(1. + i++ % 900 * 0.01, 0.3, pitch, time);
+    benchmark::DoNotOptimize(pitch);
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BallisticTableSolve);
@@ -0,0 +1,95 @@
+#include "camera_model.hpp"
+
+#include <random>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+const std::string kCAM_PATH = "../../../runtime/MV-CA016-10UC-6mm.json";
+const int kPOINTS = 1000;
+
+struct Fixture {
+  cv::Mat cam_mat, distor_coff;
+  CameraModel camera;
+  std::vector<cv::Point2f> points;
+  std::vector<cv::Vec3d> rot_vecs, trans_vecs;
+  cv::Mat object_points = (cv::Mat_<double>(4, 3) << -67.5, -60., 16., 67.5,
+                           -60., 0., 67.5, 60., 0., -67.5, 60., 16.);
+
+  Fixture() {
+    cv::FileStorage fs(kCAM_PATH,
+                       cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+    cam_mat = fs["cam_mat"].mat();
+    distor_coff = fs["distor_coff"].mat();
+    camera.Init(cam_mat, distor_coff, cv::Size(640, 480));
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> u(0.f, 639.f), v(0.f, 479.f);
+    /* 相机前方 1~8m 的随机装甲板 */
+    std::uniform_real_distribution<double> lateral(-0.3, 0.3), depth(1., 8.);
+    std::uniform_real_distribution<double> angle(-0.5, 0.5);
+    for (int i = 0; i < kPOINTS; ++i) {
+      points.emplace_back(u(gen), v(gen));
+      const double z = depth(gen) * 1000.;
+      rot_vecs.emplace_back(angle(gen), angle(gen), angle(gen) / 5.);
+      trans_vecs.emplace_back(lateral(gen) * z, lateral(gen) * z * 0.75, z);
+    }
+  }
+};
+
+void CameraModelUndistort(benchmark::State &state) {
+  Fixture fixture;
+  cv::Point2f result;
+  for (auto _ : state) {
+    for (const auto &point : fixture.points)
+      benchmark::DoNotOptimize(fixture.camera.Undistort(point, result));
+  }
+  state.SetItemsProcessed(state.iterations() * kPOINTS);
+}
+
+void OpenCVUndistort(benchmark::State &state) {
+  Fixture fixture;
+  std::vector<cv::Point2f> result;
+  for (auto _ : state) {
+    cv::undistortPoints(fixture.points, result, fixture.cam_mat,
+                        fixture.distor_coff, cv::noArray(), fixture.cam_mat);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kPOINTS);
+}
+
+/* 每次投影一块装甲板的四个角点 */
+void CameraModelProject(benchmark::State &state) {
+  Fixture fixture;
+  std::vector<cv::Point2f> result;
+  for (auto _ : state) {
+    for (int i = 0; i < kPOINTS; ++i) {
+      fixture.camera.Project(fixture.object_points, fixture.rot_vecs[i],
+                             fixture.trans_vecs[i], result);
+      benchmark::DoNotOptimize(result.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kPOINTS);
+}
+
+void OpenCVProject(benchmark::State &state) {
+  Fixture fixture;
+  std::vector<cv::Point2f> result;
+  for (auto _ : state) {
+    for (int i = 0; i < kPOINTS; ++i) {
+      cv::projectPoints(fixture.object_points, fixture.rot_vecs[i],
+                        fixture.trans_vecs[i], fixture.cam_mat,
+                        fixture.distor_coff, result);
+      benchmark::DoNotOptimize(result.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kPOINTS);
+}
+
+}  // namespace
+
+BENCHMARK(CameraModelUndistort);
+BENCHMARK(OpenCVUndistort);
+BENCHMARK(CameraModelProject);
+BENCHMARK(OpenCVProject);
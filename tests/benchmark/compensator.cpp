@@ -0,0 +1,38 @@
+#include "compensator.hpp"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+const std::string kCAM_PATH = "../../../runtime/MV-CA016-10UC-6mm.json";
+
+/* 并行解算时耗时不应随装甲板数量线性增长 */
+void CompensatorApply(benchmark::State &state) {
+  cv::FileStorage fs(kCAM_PATH,
+                     cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+  const cv::Mat cam_mat = fs["cam_mat"].mat();
+  const cv::Mat distor_coff = fs["distor_coff"].mat();
+  Compensator compensator(kCAM_PATH);
+  const cv::Mat frame(480, 640, CV_8UC3);
+
+  tbb::concurrent_vector<Armor> armors;
+  for (int i = 0; i < state.range(0); ++i) {
+    Armor armor;
+    armor.SetModel(game::Model::kINFANTRY);
+    cv::projectPoints(
+        armor.PhysicVertices(), cv::Vec3d(0., 0.3, 0.),
+        cv::Vec3d(600. * (i % 4 - 1.5), 200. * (i / 4 - 1), 2000. + 300. * i),
+        cam_mat, distor_coff, armor.image_vertices_);
+    armor.image_center_ =
+        (armor.image_vertices_[0] + armor.image_vertices_[2]) / 2.;
+    armors.push_back(armor);
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(compensator.Apply(armors, frame, {0., 0., 0.}));
+  }
+}
+
+}  // namespace
+
+BENCHMARK(CompensatorApply)->Arg(1)->Arg(4)->Arg(12);
@@ -0,0 +1,36 @@
+#include "crc16.hpp"
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+typedef uint16_t (*Calc)(const uint8_t *, std::size_t, uint16_t);
+
+/* 从单帧长度到录像数据块的长度 */
+void PacketSizes(benchmark::internal::Benchmark *bench) {
+  for (int len : {8, 15, 31, 64, 256, 1024, 4096}) bench->Arg(len);
+}
+
+void CRC16(benchmark::State &state, Calc calc) {
+  std::vector<uint8_t> buff(state.range(0));
+  std::mt19937 rng(0);
+  for (auto &byte : buff) byte = rng();
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(calc(buff.data(), buff.size(), UINT16_MAX));
+  state.SetBytesProcessed(state.iterations() * buff.size());
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(CRC16, Bytewise, crc16::CRC16_CalcBytewise)
+    ->Apply(PacketSizes);
+BENCHMARK_CAPTURE(CRC16, Slicing4, crc16::CRC16_CalcSlicing4)
+    ->Apply(PacketSizes);
+BENCHMARK_CAPTURE(CRC16, Slicing8, crc16::CRC16_CalcSlicing8)
+    ->Apply(PacketSizes);
+BENCHMARK_CAPTURE(CRC16, CLMUL, crc16::CRC16_CalcCLMUL)->Apply(PacketSizes);
+BENCHMARK_CAPTURE(CRC16, Dispatch, crc16::CRC16_Calc)->Apply(PacketSizes);
@@ -0,0 +1,54 @@
+#include "frame_parser.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "crc16.hpp"
+
+namespace {
+
+const uint8_t kID = 0xA5;
+
+struct __attribute__((packed)) Package {
+  uint8_t id;
+  uint32_t seq;
+  int64_t stamp;
+  uint16_t crc16;
+};
+
+/* 参数为每次写入的字节数，对应串口单次读到的长度 */
+void FrameParserParse(benchmark::State &state) {
+  const std::size_t chunk = state.range(0);
+  std::vector<uint8_t> stream;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    Package pack;
+    pack.id = kID;
+    pack.seq = i;
+    pack.stamp = i;
+    pack.crc16 = crc16::CRC16_Calc((uint8_t *)&pack, sizeof(pack) - 2,
+                                   UINT16_MAX);
+    const uint8_t *bytes = (const uint8_t *)&pack;
+    stream.insert(stream.end(), bytes, bytes + sizeof(pack));
+    /* 不含帧头的垃圾数据 */
+    if (i % 13 == 0) stream.insert(stream.end(), {0x00, 0x5A, 0xFF});
+  }
+
+  FrameParser parser;
+  std::size_t frames = 0;
+  parser.Register(&kID, sizeof(kID), sizeof(Package),
+                  [&frames](const uint8_t *) { ++frames; });
+  for (auto _ : state) {
+    for (std::size_t n = 0; n < stream.size(); n += chunk) {
+      parser.Feed(stream.data() + n, std::min(chunk, stream.size() - n));
+      parser.Parse();
+    }
+  }
+  benchmark::DoNotOptimize(frames);
+  state.SetBytesProcessed(state.iterations() * stream.size());
+  state.SetItemsProcessed(frames);
+}
+
+}  // namespace
+
+BENCHMARK(FrameParserParse)->Arg(16)->Arg(256);
@@ -0,0 +1,79 @@
+#include <cstdio>
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "hot_log.hpp"
+#include "spdlog/async.h"
+#include "spdlog/sinks/basic_file_sink.h"
+
+namespace {
+
+/* 一帧内按对象输出的日志数量，约为 20 个轮廓各 4 条加数个目标 */
+const int kCONTOURS = 20;
+const int kARMORS = 4;
+const char kPATH[] = "benchmark_log.log";
+
+/* 模拟一帧内检测、解算与预测各处的日志 */
+void LogFrame(int mode) {
+  for (int i = 0; i < kCONTOURS; ++i) {
+    const double value = i * 0.001;
+    if (mode == 0) {
+      SPDLOG_INFO("c_area is {}", value);
+      SPDLOG_INFO("angle is {}", value);
+      SPDLOG_INFO("bar_area is {}", value);
+      SPDLOG_INFO("aspect_ratio is {}", value);
+    } else {
+      HOT_LOG_EVERY_N(SPDLOG_INFO, 64, "c_area is {}", value);
+      HOT_LOG_EVERY_N(SPDLOG_INFO, 64, "angle is {}", value);
+      HOT_LOG_EVERY_N(SPDLOG_INFO, 64, "bar_area is {}", value);
+      HOT_LOG_EVERY_N(SPDLOG_INFO, 64, "aspect_ratio is {}", value);
+    }
+  }
+  for (int i = 0; i < kARMORS; ++i) {
+    if (mode == 0) {
+      SPDLOG_WARN("x : {}, y : {}, z : {} ", i, i + 1., i + 2.);
+      SPDLOG_WARN("Error frames count : {}", i);
+      SPDLOG_WARN("Predicted.");
+    } else {
+      HOT_LOG_EVERY_N(SPDLOG_INFO, 64, "x : {}, y : {}, z : {} ", i, i + 1.,
+                      i + 2.);
+      HOT_LOG_EVERY_MS(SPDLOG_WARN, 1000, "Error frames count : {}", i);
+      HOT_LOG(SPDLOG_TRACE, "Predicted.");
+    }
+  }
+}
+
+/**
+ * @brief 每次迭代为一帧
+ *
+ * range(0): 0 为原先的同步写文件并每条刷盘，1 为异步日志器，2 为异步日志器
+ * 加限频与采样。定义 DISABLE_HOT_LOG 编译时 2 即为编译掉热路径日志后的开销。
+ */
+void LogPerFrame(benchmark::State &state) {
+  const int mode = state.range(0);
+  auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(kPATH, true);
+  sink->set_pattern("%+");
+  auto last = spdlog::default_logger();
+
+  std::shared_ptr<spdlog::logger> logger;
+  if (mode == 0) {
+    logger = std::make_shared<spdlog::logger>("benchmark", sink);
+    logger->flush_on(spdlog::level::debug);
+  } else {
+    if (!spdlog::thread_pool()) spdlog::init_thread_pool(8192, 1);
+    logger = std::make_shared<spdlog::async_logger>(
+        "benchmark", sink, spdlog::thread_pool(),
+        spdlog::async_overflow_policy::overrun_oldest);
+    logger->flush_on(spdlog::level::err);
+  }
+  spdlog::set_default_logger(logger);
+
+  for (auto _ : state) LogFrame(mode == 0 ? 0 : mode - 1);
+
+  spdlog::set_default_logger(last);
+  std::remove(kPATH);
+}
+
+}  // namespace
+
+BENCHMARK(LogPerFrame)->Arg(0)->Arg(1)->Arg(2);
@@ -0,0 +1,29 @@
+#include "mailbox.hpp"
+
+#include <thread>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+/* 一次往返包含两次投递与唤醒，单程延迟约为一半 */
+void MailboxPingPong(benchmark::State &state) {
+  component::Mailbox<int> ping, pong;
+  std::thread echo([&] {
+    int value;
+    while (ping.Wait(value, -1)) pong.Post(value);
+  });
+
+  int value = 0;
+  for (auto _ : state) {
+    ping.Post(value);
+    pong.Wait(value, -1);
+    ++value;
+  }
+  ping.Interrupt();
+  echo.join();
+}
+
+}  // namespace
+
+BENCHMARK(MailboxPingPong)->UseRealTime();
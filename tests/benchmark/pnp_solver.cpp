@@ -0,0 +1,116 @@
+#include "pnp_solver.hpp"
+
+#include <chrono>
+#include <random>
+
+#include "armor.hpp"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+const std::string kCAM_PATH = "../../../runtime/MV-CA016-10UC-6mm.json";
+
+/* 距离 3m、偏转约 20° 的小装甲板 */
+class PnpFixture : public benchmark::Fixture {
+ public:
+  cv::Mat cam_mat, distor_coff, object_points;
+  std::vector<cv::Point2f> image_points;
+  Pose truth;
+  PnpSolver solver;
+
+  void SetUp(const benchmark::State &) override {
+    cv::FileStorage fs(kCAM_PATH,
+                       cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+    cam_mat = fs["cam_mat"].mat();
+    distor_coff = fs["distor_coff"].mat();
+
+    Armor armor;
+    armor.SetModel(game::Model::kINFANTRY);
+    object_points = armor.PhysicVertices();
+
+    truth.rot_vec = cv::Vec3d(0.1, 0.35, 0.);
+    truth.trans_vec = cv::Vec3d(200., -50., 3000.);
+    cv::projectPoints(object_points, truth.rot_vec, truth.trans_vec, cam_mat,
+                      distor_coff, image_points);
+    solver.SetCamera(cam_mat, distor_coff);
+  }
+};
+
+/* 相机前方的随机位姿，与 tests/vision/pnp_solver.cpp 中的分布相同 */
+void PnpSpeedup(benchmark::State &state) {
+  cv::FileStorage fs(kCAM_PATH,
+                     cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+  const cv::Mat cam_mat = fs["cam_mat"].mat();
+  const cv::Mat distor_coff = fs["distor_coff"].mat();
+  Armor armor;
+  armor.SetModel(game::Model::kINFANTRY);
+  const cv::Mat object_points = armor.PhysicVertices();
+  PnpSolver solver;
+  solver.SetCamera(cam_mat, distor_coff);
+
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> angle(-0.6, 0.6);
+  std::uniform_real_distribution<double> lateral(-800., 800.);
+  std::uniform_real_distribution<double> depth(1000., 6000.);
+  std::vector<Pose> guesses(100);
+  std::vector<std::vector<cv::Point2f>> image_points(guesses.size());
+  for (std::size_t i = 0; i < guesses.size(); ++i) {
+    const cv::Vec3d rot_vec(angle(gen) / 2., angle(gen), 0.);
+    const cv::Vec3d trans_vec(lateral(gen), lateral(gen) / 4., depth(gen));
+    cv::projectPoints(object_points, rot_vec, trans_vec, cam_mat, distor_coff,
+                      image_points[i]);
+    guesses[i] = {rot_vec + cv::Vec3d(0.02, 0.02, 0.),
+                  trans_vec + cv::Vec3d(5., 5., 20.)};
+  }
+
+  std::chrono::nanoseconds cost_fast(0), cost_iter(0);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < guesses.size(); ++i) {
+      Pose pose;
+      auto start = std::chrono::steady_clock::now();
+      solver.Solve(object_points, image_points[i], &guesses[i], pose);
+      cost_fast += std::chrono::steady_clock::now() - start;
+      benchmark::DoNotOptimize(pose);
+
+      cv::Mat rot_vec, trans_vec;
+      start = std::chrono::steady_clock::now();
+      cv::solvePnP(object_points, image_points[i], cam_mat, distor_coff,
+                   rot_vec, trans_vec, false, cv::SOLVEPNP_ITERATIVE);
+      cost_iter += std::chrono::steady_clock::now() - start;
+      benchmark::DoNotOptimize(trans_vec);
+    }
+  }
+  /* 目标为不低于 5 倍 */
+  state.counters["speedup"] =
+      static_cast<double>(cost_iter.count()) / cost_fast.count();
+  state.counters["fallback"] = solver.FallbackRatio();
+}
+
+}  // namespace
+
+BENCHMARK(PnpSpeedup);
+
+BENCHMARK_F(PnpFixture, SolvePnPIterative)(benchmark::State &state) {
+  for (auto _ : state) {
+    cv::Mat rot_vec, trans_vec;
+    cv::solvePnP(object_points, image_points, cam_mat, distor_coff, rot_vec,
+                 trans_vec, false, cv::SOLVEPNP_ITERATIVE);
+    benchmark::DoNotOptimize(trans_vec);
+  }
+}
+
+BENCHMARK_F(PnpFixture, PnpSolverCold)(benchmark::State &state) {
+  for (auto _ : state) {
+    Pose pose;
+    solver.Solve(object_points, image_points, nullptr, pose);
+    benchmark::DoNotOptimize(pose);
+  }
+}
+
+BENCHMARK_F(PnpFixture, PnpSolverWarm)(benchmark::State &state) {
+  for (auto _ : state) {
+    Pose pose;
+    solver.Solve(object_points, image_points, &truth, pose);
+    benchmark::DoNotOptimize(pose);
+  }
+}
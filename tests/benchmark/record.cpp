@@ -0,0 +1,46 @@
+#include <cstdio>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "record.hpp"
+
+namespace {
+
+const char kPATH[] = "benchmark_record.rec";
+const int kFRAMES = 32; /* 轮流使用的图像，模拟相机每帧新的缓冲 */
+
+/**
+ * @brief 每次迭代为一帧 640x480 的图像和一条指令
+ *
+ * range(0): 0 为在视觉主循环中直接写文件，1 为放入 record::Writer 的队列。
+ * 队列满时 Writer 丢弃最旧的帧，主循环的耗时与磁盘速度无关。
+ */
+void RecordPerFrame(benchmark::State &state) {
+  const int mode = state.range(0);
+  std::vector<cv::Mat> frames;
+  for (int i = 0; i < kFRAMES; ++i)
+    frames.emplace_back(480, 640, CV_8UC3, cv::Scalar(i, i, i));
+
+  uint64_t frame_id = 0;
+  if (mode == 0) {
+    std::FILE *file = std::fopen(kPATH, "wb");
+    for (auto _ : state) {
+      const auto &frame = frames[frame_id++ % kFRAMES];
+      std::fwrite(frame.data, frame.elemSize(), frame.total(), file);
+      std::fwrite(&frame_id, sizeof(frame_id), 1, file);
+    }
+    std::fclose(file);
+  } else {
+    component::record::Writer writer(kPATH);
+    for (auto _ : state) {
+      const auto stamp = std::chrono::steady_clock::now();
+      writer.Write(frames[frame_id++ % kFRAMES], stamp, frame_id);
+      writer.Write(component::record::Type::kCOMMAND, stamp, frame_id);
+    }
+  }
+  std::remove(kPATH);
+}
+
+}  // namespace
+
+BENCHMARK(RecordPerFrame)->Arg(0)->Arg(1);
@@ -0,0 +1,32 @@
+#include "sine_fitter.hpp"
+
+#include <cmath>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+const double kA = 0.9;
+const double kW = 1.95;
+const double kB = 2.090 - kA;
+
+double Angle(double t) {
+  return std::remainder(kB * t - kA / kW * std::cos(kW * t), 2. * CV_PI);
+}
+
+/* 缓冲区填满后每帧的开销，即单帧拟合的上界 */
+void SineFitterUpdate(benchmark::State &state) {
+  SineFitter fitter;
+  double t = 0.;
+  for (; t < 4.; t += 0.01) fitter.Update(t, Angle(t));
+
+  for (auto _ : state) {
+    fitter.Update(t, Angle(t));
+    t += 0.03;
+    benchmark::DoNotOptimize(fitter.GetOmega());
+  }
+}
+
+}  // namespace
+
+BENCHMARK(SineFitterUpdate);
@@ -0,0 +1,28 @@
+#include "target_selector.hpp"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+const cv::Size kFRAME_SIZE(640, 480);
+
+/* 参数为候选装甲板数量 */
+void TargetSelectorSelect(benchmark::State &state) {
+  TargetSelector selector;
+  tbb::concurrent_vector<Armor> armors;
+  for (int i = 0; i < state.range(0); ++i) {
+    Armor armor(cv::RotatedRect(cv::Point2f(50.f * i + 20.f, 30.f * i + 40.f),
+                                cv::Size2f(20.f + 3.f * i, 10.f + 1.5f * i),
+                                0.f));
+    armor.SetModel(game::Model::kINFANTRY);
+    armors.push_back(armor);
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(selector.Select(armors, kFRAME_SIZE));
+  }
+}
+
+}  // namespace
+
+BENCHMARK(TargetSelectorSelect)->Arg(4)->Arg(12);
@@ -0,0 +1,48 @@
+#include "thread_policy.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+#include "metrics.hpp"
+
+namespace {
+
+const char kPATH[] = "thread_policy_benchmark.json";
+
+/* 1ms 周期唤醒的延迟，参数为实时优先级，0 为默认调度 */
+void WakeupJitter(benchmark::State &state) {
+  const int priority = static_cast<int>(state.range(0));
+  std::ofstream(kPATH) << "{\"threads\": [{\"name\": \"Jitter\", "
+                          "\"cpus\": [0], \"priority\": "
+                       << priority << "}]}";
+  component::thread_policy::Load(kPATH);
+  std::remove(kPATH);
+
+  /* 在单独的线程中测量，调度策略不影响之后的测试 */
+  component::metrics::Histogram histogram;
+  bool applied = false;
+  std::thread thread([&] {
+    if (priority > 0) applied = component::thread_policy::Apply("Jitter");
+    auto next = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+      next += std::chrono::milliseconds(1);
+      std::this_thread::sleep_until(next);
+      histogram.Record(std::chrono::steady_clock::now() - next);
+    }
+  });
+  thread.join();
+
+  const auto summary = histogram.Collect();
+  state.counters["p50_ns"] = summary.p50;
+  state.counters["p99_ns"] = summary.p99;
+  state.counters["max_ns"] = summary.max;
+  /* 没有实时调度权限时只绑核 */
+  state.counters["fifo"] = applied;
+}
+
+}  // namespace
+
+BENCHMARK(WakeupJitter)->Arg(0)->Arg(50)->Iterations(500)->UseRealTime();
@@ -0,0 +1,20 @@
+#include "trace.hpp"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+void TraceSpan(benchmark::State &state) {
+  component::trace::Enable(state.range(0));
+  for (auto _ : state) {
+    TRACE_SPAN("benchmark");
+    benchmark::ClobberMemory();
+  }
+  component::trace::Enable(false);
+  component::trace::Clear();
+}
+
+}  // namespace
+
+/* 0 为关闭时的开销 */
+BENCHMARK(TraceSpan)->Arg(0)->Arg(1);
@@ -0,0 +1,108 @@
+#include "debug_server.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+int Connect(int port, const std::string &path) {
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+  const std::string request = "GET " + path + " HTTP/1.0\r\n\r\n";
+  send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+  return fd;
+}
+
+/* 读到对端关闭、超时或出现 until 为止 */
+std::string Read(int fd, const std::string &until = "") {
+  std::string response;
+  char buff[4096];
+  while (until.empty() || response.find(until) == std::string::npos) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    if (poll(&pfd, 1, 1000) <= 0) break;
+    const ssize_t len = recv(fd, buff, sizeof(buff), 0);
+    if (len <= 0) break;
+    response.append(buff, len);
+  }
+  return response;
+}
+
+std::string Get(int port, const std::string &path) {
+  const int fd = Connect(port, path);
+  if (fd < 0) return "";
+  const std::string response = Read(fd);
+  close(fd);
+  return response;
+}
+
+}  // namespace
+
+TEST(TestDebugServer, TestEndpoints) {
+  component::metrics::Exporter exporter("", "",
+                                        std::chrono::milliseconds(10));
+  component::metrics::GetCounter("test.server").Add();
+  component::DebugServer server("127.0.0.1", 0, &exporter);
+  ASSERT_GT(server.GetPort(), 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  std::string response = Get(server.GetPort(), "/metrics");
+  EXPECT_EQ(response.compare(0, 15, "HTTP/1.0 200 OK"), 0);
+  EXPECT_NE(response.find("application/json"), std::string::npos);
+  EXPECT_NE(response.find("\"test.server\""), std::string::npos);
+
+  response = Get(server.GetPort(), "/");
+  EXPECT_NE(response.find("<img src=\"/stream\""), std::string::npos);
+
+  response = Get(server.GetPort(), "/nothing");
+  EXPECT_EQ(response.compare(0, 12, "HTTP/1.0 404"), 0);
+
+  component::DebugServer occupied("127.0.0.1", server.GetPort());
+  EXPECT_EQ(occupied.GetPort(), -1);
+}
+
+TEST(TestDebugServer, TestStream) {
+  const cv::Mat frame(480, 1280, CV_8UC3, cv::Scalar(0, 128, 255));
+  const auto start = std::chrono::steady_clock::now();
+  {
+    component::DebugServer server("127.0.0.1", 0, nullptr, 100.);
+    ASSERT_GT(server.GetPort(), 0);
+    /* 没有客户端时不编码 */
+    EXPECT_FALSE(server.Post(frame));
+
+    const int fd = Connect(server.GetPort(), "/stream");
+    ASSERT_GE(fd, 0);
+    std::string response = Read(fd, "boundary=frame\r\n\r\n");
+    EXPECT_NE(response.find("multipart/x-mixed-replace"), std::string::npos);
+    for (int i = 0; i < 100 && !server.Streaming(); ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_TRUE(server.Streaming());
+
+    /* 超过限定帧率的帧被丢弃 */
+    EXPECT_TRUE(server.Post(frame));
+    EXPECT_FALSE(server.Post(frame));
+
+    response = Read(fd, "\xFF\xD9");
+    EXPECT_NE(response.find("--frame\r\nContent-Type: image/jpeg"),
+              std::string::npos);
+    EXPECT_NE(response.find("\xFF\xD8"), std::string::npos);
+    /* 客户端未断开时析构也应及时返回 */
+    close(fd);
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+}
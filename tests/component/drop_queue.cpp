@@ -0,0 +1,36 @@
+#include "drop_queue.hpp"
+
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+TEST(TestComponent, TestDropQueue) {
+  component::DropQueue<std::unique_ptr<int>> queue(2);
+  std::unique_ptr<int> value;
+  EXPECT_FALSE(queue.Pop(value, 0));
+
+  /* 满时丢弃最旧的，保留最新的两个 */
+  EXPECT_FALSE(queue.Push(std::make_unique<int>(1)));
+  EXPECT_FALSE(queue.Push(std::make_unique<int>(2)));
+  EXPECT_TRUE(queue.Push(std::make_unique<int>(3)));
+  EXPECT_EQ(queue.Size(), 2u);
+  EXPECT_EQ(queue.Dropped(), 1u);
+
+  ASSERT_TRUE(queue.Pop(value, 0));
+  EXPECT_EQ(*value, 2);
+  ASSERT_TRUE(queue.Pop(value, 0));
+  EXPECT_EQ(*value, 3);
+  EXPECT_FALSE(queue.Pop(value, 10));
+
+  std::thread consumer([&queue] {
+    std::unique_ptr<int> value;
+    EXPECT_TRUE(queue.Pop(value, 1000));
+    EXPECT_EQ(*value, 4);
+    EXPECT_FALSE(queue.Pop(value, 1000));
+  });
+  queue.Push(std::make_unique<int>(4));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  queue.Interrupt();
+  consumer.join();
+}
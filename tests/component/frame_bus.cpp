@@ -0,0 +1,148 @@
+#include "frame_bus.hpp"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const char kNAME[] = "/qdu_rm_ai.test_bus";
+
+struct Target {
+  float x, y;
+  int id;
+};
+
+cv::Mat MakeFrame(uint64_t frame_id) {
+  return cv::Mat(3, 4, CV_8UC3, cv::Scalar(frame_id, frame_id + 1, 0));
+}
+
+}  // namespace
+
+TEST(TestFrameBus, TestPublish) {
+  component::FrameWriter writer(kNAME, 3 * 4 * 3);
+  ASSERT_TRUE(writer.Ok());
+  component::FrameReader reader;
+  ASSERT_TRUE(reader.Open(kNAME));
+
+  component::FrameReader::View view;
+  EXPECT_FALSE(reader.Wait(view, 10));
+
+  const auto stamp = std::chrono::steady_clock::now();
+  EXPECT_EQ(writer.Publish(MakeFrame(7), stamp, 7), 1u);
+  ASSERT_TRUE(reader.Wait(view, 10));
+  EXPECT_EQ(view.frame_id, 7u);
+  EXPECT_EQ(view.stamp, stamp);
+  ASSERT_EQ(view.image.rows, 3);
+  ASSERT_EQ(view.image.cols, 4);
+  EXPECT_EQ(view.image.data[0], 7);
+  EXPECT_EQ(view.image.data[1], 8);
+  EXPECT_TRUE(reader.Valid(view));
+
+  /* 超过帧槽容量 */
+  EXPECT_EQ(writer.Publish(cv::Mat(4, 4, CV_8UC3), stamp, 8), 0u);
+}
+
+TEST(TestFrameBus, TestSlowReader) {
+  component::FrameWriter writer(kNAME, 3 * 4 * 3, 4);
+  component::FrameReader reader;
+  ASSERT_TRUE(reader.Open(kNAME));
+  const auto stamp = std::chrono::steady_clock::now();
+
+  /* 落后超过一圈时跳到最新，写者不受影响 */
+  for (uint64_t i = 1; i <= 10; ++i) writer.Publish(MakeFrame(i), stamp, i);
+  component::FrameReader::View view;
+  ASSERT_TRUE(reader.Wait(view, 0));
+  EXPECT_EQ(view.frame_id, 10u);
+  EXPECT_EQ(reader.Dropped(), 9u);
+
+  /* 一圈以内按顺序读 */
+  writer.Publish(MakeFrame(11), stamp, 11);
+  writer.Publish(MakeFrame(12), stamp, 12);
+  ASSERT_TRUE(reader.Wait(view, 0));
+  EXPECT_EQ(view.frame_id, 11u);
+  ASSERT_TRUE(reader.Wait(view, 0, true));
+  EXPECT_EQ(view.frame_id, 12u);
+  EXPECT_EQ(reader.Dropped(), 9u);
+
+  /* 视图所在的帧槽被覆盖后失效 */
+  cv::Mat copy;
+  EXPECT_TRUE(reader.Copy(view, copy));
+  for (uint64_t i = 13; i <= 16; ++i) writer.Publish(MakeFrame(i), stamp, i);
+  EXPECT_FALSE(reader.Valid(view));
+  EXPECT_FALSE(reader.Copy(view, copy));
+}
+
+TEST(TestFrameBus, TestDetections) {
+  component::FrameWriter writer(kNAME, 3 * 4 * 3, 4, sizeof(Target) * 2);
+  component::FrameReader reader;
+  ASSERT_TRUE(reader.Open(kNAME));
+
+  const std::vector<Target> targets = {{1.f, 2.f, 3}, {4.f, 5.f, 6}};
+  EXPECT_TRUE(reader.PublishDetections(5, cv::Size(640, 480), targets));
+  EXPECT_FALSE(reader.PublishDetections(6, cv::Size(640, 480),
+                                        std::vector<Target>(3)));
+  EXPECT_TRUE(reader.PublishDetections(7, cv::Size(640, 480),
+                                       std::vector<Target>()));
+
+  std::vector<Target> result;
+  cv::Size size;
+  ASSERT_TRUE(writer.ReadDetections(5, size, result));
+  EXPECT_EQ(size.width, 640);
+  ASSERT_EQ(result.size(), 2u);
+  EXPECT_EQ(result[1].id, 6);
+  EXPECT_FALSE(writer.ReadDetections(6, size, result));
+  EXPECT_TRUE(writer.ReadDetections(7, size, result));
+  EXPECT_TRUE(result.empty());
+
+  /* 帧号相差一圈的结果覆盖旧的 */
+  EXPECT_TRUE(reader.PublishDetections(9, cv::Size(640, 480), targets));
+  EXPECT_FALSE(writer.ReadDetections(5, size, result));
+}
+
+TEST(TestFrameBus, TestProcesses) {
+  auto writer = std::make_unique<component::FrameWriter>(kNAME, 3 * 4 * 3);
+  /* 读者从打开时的最新帧之后开始读，打开后通知父进程再发布 */
+  int ready[2];
+  ASSERT_EQ(pipe(ready), 0);
+  const pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    close(ready[0]);
+    component::FrameReader reader;
+    component::FrameReader::View view;
+    int received = 0;
+    if (reader.Open(kNAME)) {
+      const char byte = 1;
+      if (write(ready[1], &byte, 1) != 1) _exit(1);
+      close(ready[1]);
+      while (reader.Wait(view, 1000))
+        if (view.image.data[0] == view.frame_id && reader.Valid(view))
+          ++received;
+    }
+    /* 写者关闭后 Wait 返回 false */
+    _exit(received == 5 && reader.Closed() ? 0 : 1);
+  }
+
+  close(ready[1]);
+  char byte = 0;
+  /* 子进程打开失败时管道被关闭，read 返回 0 */
+  const bool opened = read(ready[0], &byte, 1) == 1;
+  close(ready[0]);
+  EXPECT_TRUE(opened);
+  for (uint64_t i = 1; i <= 5; ++i) {
+    writer->Publish(MakeFrame(i), std::chrono::steady_clock::now(), i);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  writer.reset();
+
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+}
@@ -0,0 +1,78 @@
+#include "log.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hot_log.hpp"
+#include "spdlog/async.h"
+#include "spdlog/sinks/ostream_sink.h"
+
+namespace {
+
+std::size_t CountLines(const std::string &text) {
+  std::size_t lines = 0;
+  for (char c : text) lines += c == '\n';
+  return lines;
+}
+
+}  // namespace
+
+TEST(TestLog, TestHotLog) {
+  std::ostringstream out;
+  auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(out);
+  sink->set_pattern("%v");
+  auto last = spdlog::default_logger();
+  spdlog::set_default_logger(std::make_shared<spdlog::logger>("hot", sink));
+
+  for (int i = 0; i < 100; ++i) HOT_LOG_EVERY_N(SPDLOG_INFO, 10, "{}", i);
+  EXPECT_EQ(CountLines(out.str()), 10u);
+  EXPECT_EQ(out.str().substr(0, 5), "0\n10\n");
+
+  /* 多线程同时到达时每个周期只输出一次 */
+  out.str("");
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([] {
+      for (int i = 0; i < 1000; ++i)
+        HOT_LOG_EVERY_MS(SPDLOG_INFO, 60000, "throttled");
+    });
+  for (auto &thread : threads) thread.join();
+  EXPECT_EQ(out.str(), "throttled\n");
+
+  out.str("");
+  HOT_LOG(SPDLOG_INFO, "hot");
+  EXPECT_EQ(out.str(), "hot\n");
+
+  spdlog::set_default_logger(last);
+}
+
+TEST(TestLog, TestAsyncLogger) {
+  const std::string path = "async_test.log";
+  component::Logger::SetLogger(path, component::Logger::FMT::kFMT_DEFAULT);
+  ASSERT_NE(std::dynamic_pointer_cast<spdlog::async_logger>(
+                spdlog::default_logger()),
+            nullptr);
+
+  for (int i = 0; i < 10; ++i) SPDLOG_INFO("async {}", i);
+
+  /* 关闭时排空队列并刷盘 */
+  spdlog::shutdown();
+  std::ifstream file(path);
+  std::stringstream content;
+  content << file.rdbuf();
+  EXPECT_EQ(CountLines(content.str()), 10u);
+  EXPECT_NE(content.str().find("async 9"), std::string::npos);
+
+  /* 关闭后可以重新设置 */
+  component::Logger::SetLogger(path, component::Logger::FMT::kFMT_DEFAULT);
+  SPDLOG_INFO("reopened");
+  spdlog::shutdown();
+  spdlog::set_default_logger(std::make_shared<spdlog::logger>(
+      "default", std::make_shared<spdlog::sinks::stdout_color_sink_mt>()));
+  std::remove(path.c_str());
+}
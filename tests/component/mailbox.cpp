@@ -0,0 +1,56 @@
+#include "mailbox.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(TestComponent, TestMailbox) {
+  component::Mailbox<int> mailbox;
+  int value = 0;
+  EXPECT_FALSE(mailbox.TryTake(value));
+  EXPECT_FALSE(mailbox.Wait(value, 0));
+
+  /* 只保留最新值 */
+  mailbox.Post(1);
+  mailbox.Post(2);
+  mailbox.Post(3);
+  EXPECT_TRUE(mailbox.Wait(value, 0));
+  EXPECT_EQ(value, 3);
+  EXPECT_FALSE(mailbox.Wait(value, 10));
+
+  mailbox.Interrupt();
+  EXPECT_FALSE(mailbox.Wait(value, 1000));
+}
+
+TEST(TestComponent, TestMailboxWake) {
+  typedef component::Mailbox<int>::Clock Clock;
+  component::Mailbox<int> mailbox;
+
+  /* 模拟发送线程：被唤醒后取到的值只增不减，且一定能取到最后一个 */
+  const int kPOSTS = 2000;
+  std::vector<int> values;
+  bool stamp_ok = true;
+  std::thread consumer([&] {
+    int value = -1;
+    Clock::time_point stamp;
+    while (value != kPOSTS - 1) {
+      if (!mailbox.Wait(value, 1000, &stamp)) break;
+      if (stamp > Clock::now()) stamp_ok = false;
+      values.push_back(value);
+    }
+  });
+
+  for (int i = 0; i < kPOSTS; ++i) {
+    mailbox.Post(i);
+    if (i % 100 == 0) std::this_thread::yield();
+  }
+  consumer.join();
+
+  ASSERT_FALSE(values.empty());
+  EXPECT_EQ(values.back(), kPOSTS - 1);
+  EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+  EXPECT_EQ(std::adjacent_find(values.begin(), values.end()), values.end());
+  EXPECT_TRUE(stamp_ok);
+}
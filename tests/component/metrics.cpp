@@ -0,0 +1,103 @@
+#include "metrics.hpp"
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "timer.hpp"
+
+TEST(TestMetrics, TestHistogram) {
+  using component::metrics::Histogram;
+  for (uint64_t value : {0ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull,
+                         ~0ull}) {
+    const std::size_t bucket = Histogram::BucketOf(value);
+    ASSERT_LT(bucket, Histogram::kBUCKETS);
+    EXPECT_LE(Histogram::LowerBound(bucket), value);
+    if (bucket + 1 < Histogram::kBUCKETS) {
+      EXPECT_GT(Histogram::LowerBound(bucket + 1), value);
+    }
+  }
+
+  Histogram histogram;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&histogram] {
+      for (uint64_t i = 1; i <= 10000; ++i) histogram.Record(i * 100);
+    });
+  for (auto &thread : threads) thread.join();
+
+  const auto summary = histogram.Collect();
+  EXPECT_EQ(summary.count, 40000u);
+  EXPECT_DOUBLE_EQ(summary.max, 1e6);
+  EXPECT_NEAR(summary.mean, 500050., 1.);
+  EXPECT_NEAR(summary.p50, 5e5, 5e5 * 0.07);
+  EXPECT_NEAR(summary.p99, 9.9e5, 9.9e5 * 0.07);
+  EXPECT_EQ(histogram.Collect().count, 0u);
+}
+
+TEST(TestMetrics, TestExporter) {
+  const std::string socket_path = "/tmp/test_metrics.sock";
+  unlink(socket_path.c_str());
+  const int receiver = socket(AF_UNIX, SOCK_DGRAM, 0);
+  ASSERT_GE(receiver, 0);
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+  ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)),
+            0);
+  /* 导出器不发送时 recv 超时失败，而不是挂住整个测试 */
+  const timeval timeout = {2, 0};
+  ASSERT_EQ(setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+                       sizeof(timeout)),
+            0);
+
+  auto &counter = component::metrics::GetCounter("test.frames");
+  component::metrics::GetGauge("test.fps").Set(200.);
+  {
+    METRICS_LATENCY("test.stage");
+    counter.Add(3);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  {
+    component::metrics::Exporter exporter(
+        "", socket_path, std::chrono::milliseconds(20));
+    char buff[4096];
+    const ssize_t len = recv(receiver, buff, sizeof(buff) - 1, 0);
+    ASSERT_GT(len, 0);
+    buff[len] = '\0';
+    const std::string line(buff);
+    EXPECT_NE(line.find("\"test.frames\":{\"total\":3"), std::string::npos);
+    EXPECT_NE(line.find("\"test.fps\":200"), std::string::npos);
+    EXPECT_NE(line.find("\"test.stage\":{\"count\":1"), std::string::npos);
+    EXPECT_NE(exporter.Last().find("\"test.frames\""), std::string::npos);
+  }
+  /* 析构不应等待一个完整周期以上 */
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+  close(receiver);
+  unlink(socket_path.c_str());
+}
+
+TEST(TestMetrics, TestRecorder) {
+  const auto start = std::chrono::steady_clock::now();
+  {
+    component::Recorder recorder(0, "test.recorder");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+      threads.emplace_back([&recorder] {
+        for (int i = 0; i < 1000; ++i) recorder.Record();
+      });
+    for (auto &thread : threads) thread.join();
+  }
+  /* 析构时立即退出，不再挂起 */
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(500));
+}
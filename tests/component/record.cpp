@@ -0,0 +1,109 @@
+#include "record.hpp"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const char kPATH[] = "record_test.rec";
+
+struct Sample {
+  float q[4];
+};
+
+const auto kSTART = std::chrono::steady_clock::time_point(
+    std::chrono::seconds(100));
+
+std::chrono::steady_clock::time_point At(int ms) {
+  return kSTART + std::chrono::milliseconds(ms);
+}
+
+cv::Mat MakeFrame(uint64_t frame_id) {
+  return cv::Mat(6, 8, CV_8UC3, cv::Scalar(frame_id, 0, 255));
+}
+
+/* 块很小，十帧会分布在多个块中 */
+void WriteRecording(component::record::Codec codec) {
+  component::record::Writer writer(kPATH, codec, 4096);
+  ASSERT_TRUE(writer.Ok());
+  for (int i = 0; i < 10; ++i) {
+    writer.Write(MakeFrame(i + 1), At(i * 10), i + 1);
+    for (int j = 0; j < 10; ++j) {
+      const Sample sample = {{float(i * 10 + j), 0.f, 0.f, 1.f}};
+      writer.Write(component::record::Type::kMCU, At(i * 10 + j), sample);
+    }
+    writer.Write(component::record::Type::kCOMMAND, At(i * 10 + 5), i);
+  }
+}
+
+}  // namespace
+
+TEST(TestRecord, TestRaw) {
+  WriteRecording(component::record::Codec::kRAW);
+
+  component::record::Reader reader;
+  ASSERT_TRUE(reader.Open(kPATH));
+  ASSERT_EQ(reader.Size(component::record::Type::kFRAME), 10u);
+  ASSERT_EQ(reader.Size(component::record::Type::kMCU), 100u);
+  EXPECT_EQ(reader.Size(component::record::Type::kCOMMAND), 10u);
+  EXPECT_EQ(reader.Size(component::record::Type::kREFEREE), 0u);
+
+  cv::Mat frame;
+  uint64_t frame_id = 0;
+  ASSERT_TRUE(reader.GetFrame(3, frame, frame_id));
+  EXPECT_EQ(frame_id, 4u);
+  EXPECT_EQ(frame.rows, 6);
+  EXPECT_EQ(frame.cols, 8);
+  EXPECT_EQ(frame.data[0], 4);
+  EXPECT_EQ(frame.data[2], 255);
+  EXPECT_EQ(reader.At(component::record::Type::kFRAME, 3).stamp, At(30));
+  EXPECT_FALSE(reader.GetFrame(10, frame, frame_id));
+
+  /* 按时刻查找 */
+  EXPECT_EQ(reader.Find(component::record::Type::kFRAME, At(25)), 3u);
+  EXPECT_EQ(reader.Find(component::record::Type::kFRAME, At(30)), 3u);
+  EXPECT_EQ(reader.Find(component::record::Type::kFRAME, At(91)), 10u);
+  const std::size_t index = reader.Find(component::record::Type::kMCU, At(42));
+  Sample sample;
+  ASSERT_TRUE(reader.Get(component::record::Type::kMCU, index, sample));
+  EXPECT_FLOAT_EQ(sample.q[0], 42.f);
+  int command;
+  ASSERT_TRUE(reader.Get(component::record::Type::kCOMMAND, 9, command));
+  EXPECT_EQ(command, 9);
+  EXPECT_FALSE(reader.Get(component::record::Type::kMCU, 0, command));
+
+  /* 异常退出时未写完的块只读取完整的记录 */
+  struct stat st;
+  ASSERT_EQ(stat(kPATH, &st), 0);
+  ASSERT_EQ(truncate(kPATH, st.st_size * 2 / 3), 0);
+  component::record::Reader truncated;
+  ASSERT_TRUE(truncated.Open(kPATH));
+  EXPECT_GT(truncated.Size(component::record::Type::kFRAME), 0u);
+  EXPECT_LT(truncated.Size(component::record::Type::kFRAME), 10u);
+  std::remove(kPATH);
+}
+
+TEST(TestRecord, TestJpeg) {
+  WriteRecording(component::record::Codec::kJPEG);
+
+  component::record::Reader reader;
+  ASSERT_TRUE(reader.Open(kPATH));
+  ASSERT_EQ(reader.Size(component::record::Type::kFRAME), 10u);
+  cv::Mat frame;
+  uint64_t frame_id = 0;
+  ASSERT_TRUE(reader.GetFrame(9, frame, frame_id));
+  EXPECT_EQ(frame_id, 10u);
+  EXPECT_EQ(frame.rows, 6);
+  EXPECT_EQ(frame.cols, 8);
+  std::remove(kPATH);
+
+  component::record::Writer disabled("");
+  EXPECT_FALSE(disabled.Ok());
+  disabled.Write(MakeFrame(1), At(0), 1);
+  EXPECT_FALSE(reader.Open("not_exist.rec"));
+}
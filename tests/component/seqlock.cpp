@@ -0,0 +1,79 @@
+#include "seqlock.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+/* 与下位机数据大小相近，每次写入的所有字段相同 */
+struct Sample {
+  float q[4];
+  float gyro[12];
+  uint32_t seq;
+  float speed;
+};
+
+Sample MakeSample(uint32_t seq) {
+  Sample sample;
+  for (auto &q : sample.q) q = static_cast<float>(seq);
+  for (auto &g : sample.gyro) g = static_cast<float>(seq);
+  sample.seq = seq;
+  sample.speed = static_cast<float>(seq);
+  return sample;
+}
+
+bool IsTorn(const Sample &sample) {
+  for (auto q : sample.q)
+    if (q != static_cast<float>(sample.seq)) return true;
+  for (auto g : sample.gyro)
+    if (g != static_cast<float>(sample.seq)) return true;
+  return sample.speed != static_cast<float>(sample.seq);
+}
+
+}  // namespace
+
+TEST(TestComponent, TestSeqLock) {
+  component::SeqLock<Sample> lock;
+  EXPECT_EQ(lock.Version(), 0u);
+  EXPECT_EQ(lock.Load().seq, 0u);
+
+  lock.Store(MakeSample(42));
+  EXPECT_EQ(lock.Version(), 1u);
+  EXPECT_EQ(lock.Load().seq, 42u);
+
+  /* 浮点数在 2^24 以内可以精确表示序号 */
+  const uint32_t kWRITES = 2000000;
+  const int kREADERS = 3;
+  std::atomic<bool> done(false);
+  std::atomic<uint64_t> torn(0), reads(0), regress(0);
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kREADERS; ++i)
+    readers.emplace_back([&] {
+      uint32_t last = 0;
+      while (!done.load(std::memory_order_relaxed)) {
+        const Sample sample = lock.Load();
+        if (IsTorn(sample)) ++torn;
+        if (sample.seq < last) ++regress;
+        last = sample.seq;
+        ++reads;
+      }
+    });
+
+  std::thread writer([&] {
+    for (uint32_t i = 43; i < 43 + kWRITES; ++i) lock.Store(MakeSample(i));
+    done = true;
+  });
+
+  writer.join();
+  for (auto &reader : readers) reader.join();
+
+  EXPECT_EQ(torn, 0u);
+  EXPECT_EQ(regress, 0u);
+  EXPECT_GT(reads, 0u);
+  EXPECT_EQ(lock.Version(), kWRITES + 1);
+  EXPECT_EQ(lock.Load().seq, 42u + kWRITES);
+}
@@ -0,0 +1,88 @@
+#include "thread_policy.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "tbb/global_control.h"
+#include "tbb/parallel_for.h"
+
+namespace {
+
+const char kPATH[] = "thread_policy_test.json";
+
+void WriteConfig(int priority) {
+  std::ofstream file(kPATH);
+  file << "{\"lock_memory\": 0, \"tbb_cpus\": [0], \"threads\": ["
+       << "{\"name\": \"Pinned\", \"cpus\": [0], \"priority\": " << priority
+       << "}, {\"name\": \"Late\", \"cpus\": [0]}]}";
+}
+
+bool PinnedTo(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  sched_getaffinity(0, sizeof(set), &set);
+  return CPU_COUNT(&set) == 1 && CPU_ISSET(cpu, &set);
+}
+
+}  // namespace
+
+TEST(TestThreadPolicy, TestLoad) {
+  WriteConfig(0);
+  ASSERT_TRUE(component::thread_policy::Load(kPATH));
+  EXPECT_FALSE(component::thread_policy::Load("not_exist.json"));
+
+  component::thread_policy::Policy policy;
+  ASSERT_TRUE(component::thread_policy::Find("Pinned", policy));
+  EXPECT_EQ(policy.cpus, std::vector<int>{0});
+  EXPECT_EQ(policy.priority, 0);
+  ASSERT_TRUE(component::thread_policy::Find("TbbWorker", policy));
+  EXPECT_EQ(policy.cpus, std::vector<int>{0});
+  EXPECT_FALSE(component::thread_policy::Find("Unknown", policy));
+
+  EXPECT_EQ(tbb::global_control::active_value(
+                tbb::global_control::max_allowed_parallelism),
+            1u);
+  int sum = 0;
+  tbb::parallel_for(0, 100, [&sum](int i) { sum += i; });
+  EXPECT_EQ(sum, 4950);
+
+  std::thread thread([] {
+    EXPECT_TRUE(component::thread_policy::Apply("Pinned"));
+    EXPECT_TRUE(PinnedTo(0));
+    char name[16];
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    EXPECT_STREQ(name, "Pinned");
+  });
+  thread.join();
+  std::remove(kPATH);
+}
+
+TEST(TestThreadPolicy, TestLateLoad) {
+  /* 先登记后加载，加载时对已登记的线程生效 */
+  std::atomic<int> step(0);
+  std::thread thread([&step] {
+    /* 先放开到所有核，多核时可以确认之后的绑定来自 Load */
+    cpu_set_t all;
+    CPU_ZERO(&all);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) CPU_SET(cpu, &all);
+    sched_setaffinity(0, sizeof(all), &all);
+    component::thread_policy::Apply("LateWorker");
+    step = 1;
+    while (step != 2) std::this_thread::yield();
+    EXPECT_TRUE(PinnedTo(0));
+  });
+  while (step != 1) std::this_thread::yield();
+
+  std::ofstream(kPATH) << "{\"threads\": [{\"name\": \"LateWorker\", "
+                          "\"cpus\": [0]}]}";
+  EXPECT_TRUE(component::thread_policy::Load(kPATH));
+  step = 2;
+  thread.join();
+  std::remove(kPATH);
+}
@@ -0,0 +1,76 @@
+#include "trace.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const std::string kPATH = "trace_test.json";
+
+std::size_t Count(const std::string &str, const std::string &pattern) {
+  std::size_t count = 0;
+  for (auto pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + 1))
+    ++count;
+  return count;
+}
+
+std::string ReadAll(const std::string &path) {
+  std::ifstream file(path);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+}  // namespace
+
+TEST(TestTrace, TestDump) {
+  component::trace::Clear();
+  component::trace::Enable(false);
+  { TRACE_SPAN("disabled"); }
+
+  component::trace::Enable(true);
+  std::thread worker([] {
+    component::trace::SetThreadName("worker");
+    for (uint64_t frame = 1; frame <= 10; ++frame) {
+      component::trace::SetFrame(frame);
+      TRACE_SPAN("outer");
+      TRACE_SPAN("inner");
+    }
+  });
+  worker.join();
+  component::trace::Enable(false);
+
+  ASSERT_TRUE(component::trace::Dump(kPATH));
+  const std::string json = ReadAll(kPATH);
+  EXPECT_EQ(json.front(), '{');
+  EXPECT_EQ(Count(json, "\"name\":\"outer\""), 10u);
+  EXPECT_EQ(Count(json, "\"name\":\"inner\""), 10u);
+  EXPECT_EQ(Count(json, "\"name\":\"disabled\""), 0u);
+  EXPECT_EQ(Count(json, "\"depth\":1"), 10u);
+  EXPECT_EQ(Count(json, "\"frame\":10,"), 2u);
+  EXPECT_EQ(Count(json, "\"args\":{\"name\":\"worker\"}"), 1u);
+
+  component::trace::Clear();
+  ASSERT_TRUE(component::trace::Dump(kPATH));
+  EXPECT_EQ(Count(ReadAll(kPATH), "\"ph\":\"X\""), 0u);
+}
+
+TEST(TestTrace, TestNameOnly) {
+  /* 只命名、未记录的线程仍可导出名称，不需要事件缓冲区 */
+  component::trace::Enable(false);
+  std::thread idle([] {
+    component::trace::SetThreadName("idle");
+    TRACE_SPAN("disabled");
+  });
+  idle.join();
+
+  ASSERT_TRUE(component::trace::Dump(kPATH));
+  const std::string json = ReadAll(kPATH);
+  EXPECT_EQ(Count(json, "\"args\":{\"name\":\"idle\"}"), 1u);
+  EXPECT_EQ(Count(json, "\"name\":\"disabled\""), 0u);
+}
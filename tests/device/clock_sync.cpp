@@ -0,0 +1,62 @@
+#include "clock_sync.hpp"
+
+#include <cmath>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+/* 模拟的下位机时钟：偏差 12.3s，快 50ppm */
+const double kOFFSET = 12.3e6;
+const double kDRIFT = 50e-6;
+
+int64_t McuClock(int64_t host) {
+  return static_cast<int64_t>(std::llround(host * (1. + kDRIFT) + kOFFSET));
+}
+
+}  // namespace
+
+TEST(TestClockSync, TestInvalid) {
+  ClockSync sync;
+  EXPECT_FALSE(sync.Synced());
+  EXPECT_FALSE(sync.Update(100, 50, 40, 200));
+  EXPECT_FALSE(sync.Update(100, 0, 1000, 200));
+  EXPECT_FALSE(sync.Synced());
+
+  ASSERT_TRUE(sync.Update(100, 1150, 1160, 210));
+  EXPECT_TRUE(sync.Synced());
+  EXPECT_EQ(sync.ToMcu(155), 1155);
+  EXPECT_EQ(sync.ToHost(1155), 155);
+  EXPECT_EQ(sync.OneWayDelay().count(), 50);
+}
+
+TEST(TestClockSync, TestConvergence) {
+  ClockSync sync;
+  std::mt19937 rng(7);
+  /* 串口单程至少 150us，偶尔因排队多出几毫秒 */
+  std::exponential_distribution<double> queue(1. / 300.);
+  std::uniform_real_distribution<double> spike(0., 1.);
+
+  /* 每 100ms 对时一次 */
+  int64_t host = 1000000;
+  for (int i = 0; i < 6000; ++i, host += 100000) {
+    const double up = 150. + queue(rng) + (spike(rng) < 0.05 ? 5000. : 0.);
+    const double down = 150. + queue(rng) + (spike(rng) < 0.05 ? 5000. : 0.);
+    const int64_t mcu_rx = McuClock(host + static_cast<int64_t>(up));
+    const int64_t mcu_tx = mcu_rx + 20;
+    const int64_t host_rx =
+        host + static_cast<int64_t>(up) + 20 + static_cast<int64_t>(down);
+    ASSERT_TRUE(sync.Update(host, mcu_rx, mcu_tx, host_rx));
+  }
+
+  const ClockSync::Estimate estimate = sync.GetEstimate();
+  EXPECT_NEAR(estimate.drift, kDRIFT, 2e-6);
+  EXPECT_LT(estimate.rtt, 500.);
+  EXPECT_NEAR(sync.OneWayDelay().count(), 150, 100);
+
+  /* 往后一秒的换算误差 */
+  const int64_t later = host + 1000000;
+  EXPECT_NEAR(sync.ToMcu(later), McuClock(later), 50);
+  EXPECT_NEAR(sync.ToHost(McuClock(later)), later, 50);
+}
@@ -0,0 +1,73 @@
+#include "codec.hpp"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+TEST(TestCodec, TestRoundTrip) {
+  Protocol_UpDataMCU_t data;
+  std::memset(&data, 0, sizeof(data));
+  data.quat.q0 = 0.5f;
+  data.quat.q3 = -0.5f;
+  data.ball_speed = 15.5f;
+
+  std::array<uint8_t, codec::McuPacket::kSIZE> buff;
+  ASSERT_EQ(codec::Encode<codec::McuPacket>(data, buff), buff.size());
+  EXPECT_EQ(buff[0], AI_ID_MCU);
+  EXPECT_TRUE(crc16::CRC16_Verify(buff.data(), buff.size()));
+
+  const codec::View<codec::McuPacket> view(buff.data());
+  ASSERT_TRUE(view.Verify());
+  EXPECT_FLOAT_EQ(CODEC_GET(view, quat.q0), 0.5f);
+  EXPECT_FLOAT_EQ(CODEC_GET(view, quat.q3), -0.5f);
+  EXPECT_FLOAT_EQ(CODEC_GET(view, ball_speed), 15.5f);
+  EXPECT_EQ(std::memcmp(&data, buff.data() + 1, sizeof(data)), 0);
+
+  buff[3] ^= 0x10;
+  EXPECT_FALSE(view.Verify());
+  buff[3] ^= 0x10;
+  buff[0] = AI_ID_REF;
+  EXPECT_FALSE(view.Verify());
+}
+
+TEST(TestCodec, TestLegacyLayout) {
+  /* 与直接填写协议结构体的结果逐字节一致 */
+  Protocol_DownPackage_t command;
+  std::memset(&command, 0, sizeof(command));
+  command.data.gimbal.yaw = 1.f;
+  command.data.gimbal.pit = -2.f;
+  command.data.notice = AI_NOTICE_FIRE;
+  command.crc16 = crc16::CRC16_Calc((uint8_t *)&command.data,
+                                    sizeof(command.data), UINT16_MAX);
+
+  std::array<uint8_t, codec::CommandPacket::kSIZE> buff;
+  ASSERT_EQ(codec::Encode<codec::CommandPacket>(command.data, buff),
+            sizeof(command));
+  EXPECT_EQ(std::memcmp(&command, buff.data(), sizeof(command)), 0);
+
+  SyncEcho echo;
+  echo.id = kID_SYNC_ECHO;
+  echo.data = {7, 100, 200, 300};
+  echo.crc16 = crc16::CRC16_Calc((uint8_t *)&echo, sizeof(echo) - 2,
+                                 UINT16_MAX);
+
+  std::array<uint8_t, codec::EchoPacket::kSIZE> echo_buff;
+  ASSERT_EQ(codec::Encode<codec::EchoPacket>(echo.data, echo_buff),
+            sizeof(echo));
+  EXPECT_EQ(std::memcmp(&echo, echo_buff.data(), sizeof(echo)), 0);
+
+  const codec::View<codec::EchoPacket> view(echo_buff.data());
+  EXPECT_EQ(CODEC_GET(view, seq), 7u);
+  EXPECT_EQ(CODEC_GET(view, mcu_tx), 300);
+  EXPECT_EQ(view.GetCRC(), echo.crc16);
+}
+
+TEST(TestCodec, TestSmallBuffer) {
+  SyncPingData ping = {1, 2};
+  uint8_t buff[codec::PingPacket::kSIZE];
+  EXPECT_EQ(codec::Encode<codec::PingPacket>(ping, buff, sizeof(buff) - 1),
+            0u);
+  EXPECT_EQ(codec::Encode<codec::PingPacket>(ping, buff, sizeof(buff)),
+            sizeof(buff));
+}
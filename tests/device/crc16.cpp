@@ -0,0 +1,57 @@
+#include "crc16.hpp"
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+/* 逐位计算的参考实现 */
+uint16_t Reference(const uint8_t *buf, std::size_t len, uint16_t crc) {
+  while (len--) {
+    crc ^= *buf++;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 1) ? (crc >> 1) ^ 0x8408 : crc >> 1;
+  }
+  return crc;
+}
+
+}  // namespace
+
+TEST(TestCRC16, TestCheckValue) {
+  const uint8_t check[] = "123456789";
+  EXPECT_EQ(crc16::CRC16_Calc(check, 9, UINT16_MAX), 0x6f91);
+  EXPECT_EQ(crc16::CRC16_Calc(check, 0, 0x1234), 0x1234);
+}
+
+TEST(TestCRC16, TestBitExact) {
+  std::mt19937 rng(42);
+  std::vector<uint8_t> buff(1024 + 16);
+  for (auto &byte : buff) byte = rng();
+
+  /* 覆盖各种长度、非对齐的起始地址与初值 */
+  for (std::size_t len = 0; len <= 1024; len += (len < 80 ? 1 : 37)) {
+    const std::size_t offset = rng() % 16;
+    const uint16_t init = rng();
+    const uint8_t *data = buff.data() + offset;
+    const uint16_t expected = Reference(data, len, init);
+
+    ASSERT_EQ(crc16::CRC16_CalcBytewise(data, len, init), expected) << len;
+    ASSERT_EQ(crc16::CRC16_CalcSlicing4(data, len, init), expected) << len;
+    ASSERT_EQ(crc16::CRC16_CalcSlicing8(data, len, init), expected) << len;
+    ASSERT_EQ(crc16::CRC16_CalcCLMUL(data, len, init), expected) << len;
+    ASSERT_EQ(crc16::CRC16_Calc(data, len, init), expected) << len;
+  }
+}
+
+TEST(TestCRC16, TestVerify) {
+  uint8_t frame[35];
+  for (std::size_t i = 0; i < sizeof(frame) - 2; ++i) frame[i] = i * 7;
+  const uint16_t crc = crc16::CRC16_Calc(frame, sizeof(frame) - 2, UINT16_MAX);
+  frame[sizeof(frame) - 2] = crc & 0xff;
+  frame[sizeof(frame) - 1] = crc >> 8;
+  EXPECT_TRUE(crc16::CRC16_Verify(frame, sizeof(frame)));
+  frame[3] ^= 1;
+  EXPECT_FALSE(crc16::CRC16_Verify(frame, sizeof(frame)));
+}
@@ -0,0 +1,123 @@
+#include "frame_parser.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "crc16.hpp"
+#include "gtest/gtest.h"
+#include "serial.hpp"
+
+namespace {
+
+const uint8_t kID = 0xA5;
+
+struct __attribute__((packed)) Package {
+  uint8_t id;
+  uint32_t seq;
+  int64_t stamp; /* 发送时刻(ns) */
+  uint16_t crc16;
+};
+
+int64_t Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Package Pack(uint32_t seq, int64_t stamp) {
+  Package pack;
+  pack.id = kID;
+  pack.seq = seq;
+  pack.stamp = stamp;
+  pack.crc16 = crc16::CRC16_Calc((uint8_t *)&pack, sizeof(pack) - 2,
+                                 UINT16_MAX);
+  return pack;
+}
+
+}  // namespace
+
+TEST(TestFrameParser, TestResync) {
+  std::vector<uint32_t> seqs;
+  FrameParser parser;
+  parser.Register(&kID, sizeof(kID), sizeof(Package),
+                  [&](const uint8_t *frame) {
+                    seqs.push_back(((const Package *)frame)->seq);
+                  });
+
+  std::vector<uint8_t> stream = {0x00, kID, 0x13, kID};
+  for (uint32_t i = 0; i < 8; ++i) {
+    Package pack = Pack(i, i * 1000);
+    if (i == 3) pack.stamp ^= 1; /* 校验失败 */
+    const uint8_t *bytes = (const uint8_t *)&pack;
+    stream.insert(stream.end(), bytes, bytes + sizeof(pack));
+    if (i == 5) stream.push_back(kID); /* 残缺的帧头 */
+  }
+
+  /* 逐字节写入，模拟任意的分包 */
+  for (auto byte : stream) {
+    parser.Feed(&byte, 1);
+    parser.Parse();
+  }
+  EXPECT_EQ(seqs, std::vector<uint32_t>({0, 1, 2, 4, 5, 6, 7}));
+  EXPECT_EQ(parser.GetFrames(), 7u);
+  EXPECT_GE(parser.GetCRCErrors(), 1u);
+  EXPECT_EQ(parser.Buffered(), 0u);
+}
+
+TEST(TestFrameParser, TestPty) {
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  ASSERT_GE(master, 0);
+  ASSERT_EQ(grantpt(master), 0);
+  ASSERT_EQ(unlockpt(master), 0);
+
+  Serial com(ptsname(master));
+  ASSERT_TRUE(com.IsOpen());
+
+  const uint32_t kFRAMES = 20000, kCORRUPT = 97;
+  std::thread writer([&] {
+    std::vector<uint8_t> buff;
+    for (uint32_t i = 0; i < kFRAMES; ++i) {
+      Package pack = Pack(i, Now());
+      if (i % kCORRUPT == 0) pack.seq ^= 0x100;
+      const uint8_t *bytes = (const uint8_t *)&pack;
+      buff.assign(bytes, bytes + sizeof(pack));
+      /* 不含帧头的垃圾数据，避免与 CRC16 偶然碰撞 */
+      if (i % 13 == 0) buff.insert(buff.end(), {0x00, 0x5A, 0xFF});
+      for (std::size_t n = 0; n < buff.size();) {
+        const ssize_t ret = write(master, buff.data() + n, buff.size() - n);
+        if (ret > 0) n += ret;
+      }
+    }
+  });
+
+  std::vector<uint32_t> seqs;
+  FrameParser parser;
+  parser.Register(&kID, sizeof(kID), sizeof(Package),
+                  [&](const uint8_t *frame) {
+                    seqs.push_back(((const Package *)frame)->seq);
+                  });
+
+  const uint32_t expected = kFRAMES - (kFRAMES + kCORRUPT - 1) / kCORRUPT;
+  uint8_t buff[256];
+  while (seqs.size() < expected && com.Poll(1000)) {
+    std::size_t len;
+    while ((len = com.Recv(buff, sizeof(buff))) > 0) {
+      parser.Feed(buff, len);
+      parser.Parse();
+    }
+  }
+  writer.join();
+  com.Close();
+  close(master);
+
+  ASSERT_EQ(seqs.size(), expected);
+  EXPECT_TRUE(std::is_sorted(seqs.begin(), seqs.end()));
+  EXPECT_TRUE(std::none_of(seqs.begin(), seqs.end(),
+                           [&](uint32_t seq) { return seq % kCORRUPT == 0; }));
+}
@@ -0,0 +1,110 @@
+#include "imu_history.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const Clock::time_point kSTART = Clock::now();
+
+/* 绕 z 轴转过 yaw 的姿态 */
+ImuSample Yaw(double yaw, int ms) {
+  return {kSTART + std::chrono::milliseconds(ms),
+          {static_cast<float>(std::cos(yaw / 2.)), 0.f, 0.f,
+           static_cast<float>(std::sin(yaw / 2.))}};
+}
+
+double YawOf(const ImuSample &sample) {
+  return 2. * std::atan2(sample.q[3], sample.q[0]);
+}
+
+Clock::time_point At(double ms) {
+  return kSTART + std::chrono::duration_cast<Clock::duration>(
+                      std::chrono::duration<double, std::milli>(ms));
+}
+
+}  // namespace
+
+TEST(TestImuHistory, TestInterpolation) {
+  ImuHistory history;
+  ImuSample sample;
+  EXPECT_FALSE(history.GetAt(At(0.), sample));
+
+  history.Push(Yaw(0., 0));
+  history.Push(Yaw(M_PI / 2., 10));
+  EXPECT_EQ(history.Size(), 2u);
+
+  ASSERT_TRUE(history.GetAt(At(5.), sample));
+  EXPECT_NEAR(YawOf(sample), M_PI / 4., 1e-5);
+  ASSERT_TRUE(history.GetAt(At(2.5), sample));
+  EXPECT_NEAR(YawOf(sample), M_PI / 8., 1e-5);
+
+  /* 超出范围时取最近的样本 */
+  ASSERT_TRUE(history.GetAt(At(-5.), sample));
+  EXPECT_NEAR(YawOf(sample), 0., 1e-6);
+  ASSERT_TRUE(history.GetAt(At(50.), sample));
+  EXPECT_NEAR(YawOf(sample), M_PI / 2., 1e-6);
+
+  /* 四元数符号相反时沿较短的弧插值 */
+  ImuSample flipped = Yaw(M_PI, 20);
+  for (auto &q : flipped.q) q = -q;
+  history.Push(flipped);
+  ASSERT_TRUE(history.GetAt(At(15.), sample));
+  const ImuSample expected = Yaw(M_PI * 3. / 4., 15);
+  double dot = 0.;
+  for (int i = 0; i < 4; ++i) dot += sample.q[i] * expected.q[i];
+  EXPECT_NEAR(std::abs(dot), 1., 1e-6);
+}
+
+TEST(TestImuHistory, TestOverwrite) {
+  ImuHistory history;
+  const int kSAMPLES = ImuHistory::kCAPACITY * 3;
+  for (int i = 0; i < kSAMPLES; ++i) history.Push(Yaw(i * 1e-3, i));
+  EXPECT_EQ(history.Size(), ImuHistory::kCAPACITY);
+
+  ImuSample sample;
+  ASSERT_TRUE(history.GetAt(At(0.), sample));
+  EXPECT_NEAR(YawOf(sample), (kSAMPLES - ImuHistory::kCAPACITY) * 1e-3, 1e-5);
+  ASSERT_TRUE(history.GetAt(At(kSAMPLES - 1.5), sample));
+  EXPECT_NEAR(YawOf(sample), (kSAMPLES - 1.5) * 1e-3, 1e-5);
+}
+
+TEST(TestImuHistory, TestConcurrent) {
+  ImuHistory history;
+  const int kSAMPLES = 200000;
+  std::atomic<bool> done(false);
+  std::atomic<int> errors(0);
+
+  /* yaw 与时间成正比，任意时刻的插值结果都可以直接验证 */
+  std::thread writer([&] {
+    for (int i = 0; i < kSAMPLES; ++i) history.Push(Yaw(i * 1e-5, i));
+    done = true;
+  });
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 2; ++r)
+    readers.emplace_back([&] {
+      ImuSample latest, sample;
+      while (!done) {
+        if (!history.GetLatest(latest)) continue;
+        const double ms =
+            std::chrono::duration<double, std::milli>(latest.stamp - kSTART)
+                .count() -
+            20.5;
+        if (ms < 0. || !history.GetAt(At(ms), sample)) continue;
+        /* 读者被长时间挂起时目标样本可能已被覆盖，此时结果是最旧的样本 */
+        if (sample.stamp != At(ms)) continue;
+        if (std::abs(YawOf(sample) - ms * 1e-5) > 1e-5) ++errors;
+      }
+    });
+
+  writer.join();
+  for (auto &reader : readers) reader.join();
+  EXPECT_EQ(errors, 0);
+}
@@ -1,5 +1,11 @@
 #include "serial.hpp"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+
 #include "gtest/gtest.h"
 
 const std::string msg = "hello\n";
@@ -17,4 +23,25 @@ TEST(TestSerial, TestConfig) {
   ASSERT_TRUE(com.Config(true, StopBits::kSTOP_BITS_1, DataLength::kDATA_LEN_7,
                          true, BaudRate::kBAUD_RATE_460800))
       << "Can not config serial port.";
-}
\ No newline at end of file
+}
+TEST(TestSerial, TestHangup) {
+  const int master = posix_openpt(O_RDWR | O_NOCTTY);
+  ASSERT_GE(master, 0);
+  ASSERT_EQ(grantpt(master), 0);
+  ASSERT_EQ(unlockpt(master), 0);
+
+  Serial com;
+  com.Open(ptsname(master));
+  ASSERT_TRUE(com.IsOpen());
+  ASSERT_EQ(write(master, msg.c_str(), msg.length()), ssize_t(msg.length()));
+  ASSERT_TRUE(com.Poll(100));
+
+  /* 对端关闭后不再报告可读，未打开时每次都等待超时，不会空转 */
+  close(master);
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 4; ++i) EXPECT_FALSE(com.Poll(20));
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(60));
+  EXPECT_FALSE(com.IsOpen());
+  EXPECT_EQ(com.Trans(msg.c_str(), msg.length()), 0u);
+}
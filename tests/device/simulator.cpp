@@ -0,0 +1,41 @@
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "mcu_simulator.hpp"
+#include "robot.hpp"
+
+TEST(TestSimulator, TestRobot) {
+  McuSimulator simulator;
+  SimulatorConfig config;
+  config.corrupt = 1e-4;
+  config.jitter_us = 200.;
+  config.speed = 16.;
+  ASSERT_TRUE(simulator.Start(config));
+
+  {
+    Robot robot(simulator.GetPath());
+    /* 模拟器能区分对时请求与指令 */
+    robot.EnableClockSync(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    EXPECT_FLOAT_EQ(robot.GetBalletSpeed(), 16.f);
+    EXPECT_EQ(robot.GetEnemyTeam(), game::Team::kBLUE);
+    EXPECT_TRUE(robot.GetClockSync().Synced());
+
+    Protocol_DownData_t data;
+    std::memset(&data, 0, sizeof(data));
+    robot.Pack(data, 1.);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  Protocol_DownData_t command;
+  EXPECT_TRUE(simulator.GetLastCommand(command));
+
+  const McuSimulator::Stats stats = simulator.GetStats();
+  simulator.Stop();
+  EXPECT_GT(stats.mcu_sent, 400u);
+  EXPECT_GE(stats.commands, 1u);
+  EXPECT_GE(stats.pings, 1u);
+}
@@ -0,0 +1,173 @@
+#include "ballistic_table.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const double kG = 9.80665;
+const double kSPEED = 15.;
+
+/* 参考积分器：以时间为自变量、步长 0.1ms 的四阶 Runge-Kutta */
+struct Shot {
+  double height, time;
+};
+
+Shot Shoot(double speed, double drag, double pitch, double distance) {
+  const double dt = 1e-4;
+  double s[4] = {0., 0., speed * std::cos(pitch), speed * std::sin(pitch)};
+  auto derive = [drag](const double *x, double *d) {
+    const double v = std::hypot(x[2], x[3]);
+    d[0] = x[2], d[1] = x[3];
+    d[2] = -drag * v * x[2], d[3] = -kG - drag * v * x[3];
+  };
+
+  double t = 0.;
+  while (t < 5.) {
+    double k[4][4], tmp[4], next[4];
+    derive(s, k[0]);
+    for (int i = 0; i < 4; ++i) tmp[i] = s[i] + k[0][i] * dt / 2.;
+    derive(tmp, k[1]);
+    for (int i = 0; i < 4; ++i) tmp[i] = s[i] + k[1][i] * dt / 2.;
+    derive(tmp, k[2]);
+    for (int i = 0; i < 4; ++i) tmp[i] = s[i] + k[2][i] * dt;
+    derive(tmp, k[3]);
+    for (int i = 0; i < 4; ++i)
+      next[i] = s[i] + dt / 6. * (k[0][i] + 2. * k[1][i] + 2. * k[2][i] +
+                                  k[3][i]);
+
+    if (next[0] >= distance) {
+      const double alpha = (distance - s[0]) / (next[0] - s[0]);
+      return {s[1] + alpha * (next[1] - s[1]), t + alpha * dt};
+    }
+    std::copy(next, next + 4, s);
+    t += dt;
+  }
+  return {NAN, NAN};
+}
+
+}  // namespace
+
+TEST(TestVision, TestBallisticTableDrag) {
+  BallisticTable table(BallisticTable::kDRAG_17MM);
+  ASSERT_FALSE(table.Ready());
+  ASSERT_TRUE(table.Init(kSPEED));
+
+  int solved = 0, total = 0;
+  double max_height_err = 0., max_time_err = 0.;
+  for (double x = 0.5; x < 10.; x += 0.37) {
+    for (double y = -1.5; y < 1.5; y += 0.23) {
+      double pitch, time;
+      ++total;
+      if (!table.Solve(x, y, pitch, time)) continue;
+      ++solved;
+      const Shot shot = Shoot(kSPEED, BallisticTable::kDRAG_17MM, pitch, x);
+      max_height_err = std::max(max_height_err, std::abs(shot.height - y));
+      max_time_err = std::max(max_time_err, std::abs(shot.time - time));
+    }
+  }
+  EXPECT_GT(solved, total * 9 / 10);
+  EXPECT_LT(max_height_err, 5e-3);
+  EXPECT_LT(max_time_err, 1e-3);
+
+  /* 阻力使同一目标所需的出射角大于真空中的出射角 */
+  double pitch, time;
+  ASSERT_TRUE(table.Solve(8., 0., pitch, time));
+  EXPECT_GT(pitch, 0.5 * std::asin(kG * 8. / (kSPEED * kSPEED)));
+}
+
+TEST(TestVision, TestBallisticTableSetDrag) {
+  BallisticTable table;
+  ASSERT_TRUE(table.Init(kSPEED));
+  double pitch_17mm, pitch_42mm, time;
+  ASSERT_TRUE(table.Solve(8., 0., pitch_17mm, time));
+
+  /* 42mm 弹丸的阻力系数约为 17mm 的一半，更换后立即按当前弹速重建 */
+  table.SetDrag(BallisticTable::kDRAG_42MM);
+  ASSERT_TRUE(table.Ready());
+  EXPECT_DOUBLE_EQ(table.Speed(), kSPEED);
+  ASSERT_TRUE(table.Solve(8., 0., pitch_42mm, time));
+  EXPECT_LT(pitch_42mm, pitch_17mm);
+  const Shot shot = Shoot(kSPEED, BallisticTable::kDRAG_42MM, pitch_42mm, 8.);
+  EXPECT_NEAR(shot.height, 0., 5e-3);
+}
+
+TEST(TestVision, TestBallisticTableVacuum) {
+  BallisticTable table(0.);
+  ASSERT_TRUE(table.Init(kSPEED));
+
+  const double v_2 = kSPEED * kSPEED;
+  for (double x = 1.; x < 10.; x += 0.71) {
+    for (double y = -1.; y < 1.; y += 0.29) {
+      double pitch, time;
+      ASSERT_TRUE(table.Solve(x, y, pitch, time));
+      const double expect = std::atan2(
+          v_2 - std::sqrt(v_2 * v_2 - kG * (kG * x * x + 2. * y * v_2)),
+          kG * x);
+      const double vx = kSPEED * std::cos(pitch);
+      const double hit = x * std::tan(pitch) - kG * x * x / (2. * vx * vx);
+      EXPECT_NEAR(pitch, expect, 1e-3);
+      EXPECT_NEAR(hit, y, 1e-3);
+      EXPECT_NEAR(time, x / (kSPEED * std::cos(expect)), 1e-3);
+    }
+  }
+
+  double pitch, time;
+  EXPECT_FALSE(table.Solve(-1., 0., pitch, time));
+  EXPECT_FALSE(table.Solve(20., 0., pitch, time));
+}
+
+TEST(TestVision, TestBallisticTableRebuild) {
+  BallisticTable table;
+  ASSERT_TRUE(table.Init(kSPEED));
+
+  table.Update(kSPEED + 0.1);
+  EXPECT_FALSE(table.Rebuilding());
+
+  double pitch_slow, pitch_fast, time;
+  ASSERT_TRUE(table.Solve(6., 0.5, pitch_slow, time));
+
+  table.Update(25.);
+  /* 重建期间旧表仍可查询 */
+  EXPECT_TRUE(table.Solve(6., 0.5, pitch_fast, time));
+
+  const auto start = std::chrono::steady_clock::now();
+  while (table.Rebuilding() &&
+         std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ASSERT_FALSE(table.Rebuilding());
+  EXPECT_DOUBLE_EQ(table.Speed(), 25.);
+
+  ASSERT_TRUE(table.Solve(6., 0.5, pitch_fast, time));
+  EXPECT_LT(pitch_fast, pitch_slow);
+}
+
+TEST(TestVision, TestBallisticTableSyncUpdate) {
+  /* 回放时第一次设置弹速后立即可用，不依赖建表线程 */
+  BallisticTable table;
+  table.Update(kSPEED, true);
+  EXPECT_FALSE(table.Rebuilding());
+  ASSERT_TRUE(table.Ready());
+  EXPECT_DOUBLE_EQ(table.Speed(), kSPEED);
+
+  double pitch, time;
+  EXPECT_TRUE(table.Solve(6., 0.5, pitch, time));
+  table.Update(25., true);
+  EXPECT_DOUBLE_EQ(table.Speed(), 25.);
+}
+
+TEST(TestVision, TestBallisticTableUnreachable) {
+  /* 5m/s 时真空中的最大射程约 2.5m */
+  BallisticTable table;
+  ASSERT_TRUE(table.Init(5.));
+
+  double pitch, time;
+  EXPECT_TRUE(table.Solve(1., 0., pitch, time));
+  EXPECT_FALSE(table.Solve(8., 0., pitch, time));
+  EXPECT_FALSE(table.Solve(2., 2.5, pitch, time));
+  /* 第 0 列没有弹道经过 */
+  EXPECT_FALSE(table.Solve(0.01, 0., pitch, time));
+}
@@ -0,0 +1,69 @@
+#include "camera_model.hpp"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const std::vector<std::string> kCAM_PATHS = {
+    "../../../runtime/MV-CA016-10UC-6mm.json",
+    "../../../runtime/MV-CA016-10UC-6mm_1.json",
+};
+const int kPOINTS = 10000;
+
+}  // namespace
+
+TEST(TestVision, TestCameraModel) {
+  for (const auto &path : kCAM_PATHS) {
+    cv::FileStorage fs(path,
+                       cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+    ASSERT_TRUE(fs.isOpened());
+    const cv::Mat cam_mat = fs["cam_mat"].mat();
+    const cv::Mat distor_coff = fs["distor_coff"].mat();
+
+    CameraModel camera;
+    ASSERT_TRUE(camera.Init(cam_mat, distor_coff, cv::Size(640, 480)));
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> u(0.f, 639.f), v(0.f, 479.f);
+    std::vector<cv::Point2f> points, expect, result(kPOINTS);
+    for (int i = 0; i < kPOINTS; ++i) points.emplace_back(u(gen), v(gen));
+
+    cv::undistortPoints(points, expect, cam_mat, distor_coff, cv::noArray(),
+                        cam_mat);
+    for (int i = 0; i < kPOINTS; ++i)
+      ASSERT_TRUE(camera.Undistort(points[i], result[i]));
+
+    double max_err = 0.;
+    for (int i = 0; i < kPOINTS; ++i)
+      max_err = std::max(max_err, cv::norm(result[i] - expect[i]));
+    EXPECT_LT(max_err, 0.01) << path;
+
+    cv::Point2f out;
+    EXPECT_FALSE(camera.Undistort(cv::Point2f(-1.f, 10.f), out));
+    EXPECT_FALSE(camera.Undistort(cv::Point2f(10.f, 1000.f), out));
+
+    /* 相机前方 1~8m 的随机装甲板角点 */
+    std::uniform_real_distribution<double> lateral(-0.3, 0.3), depth(1., 8.);
+    std::uniform_real_distribution<double> angle(-0.5, 0.5);
+    const cv::Mat object_points = (cv::Mat_<double>(4, 3) << -67.5, -60., 16.,
+                                   67.5, -60., 0., 67.5, 60., 0., -67.5, 60.,
+                                   16.);
+    max_err = 0.;
+    for (int i = 0; i < kPOINTS; ++i) {
+      const double z = depth(gen) * 1000.;
+      const cv::Vec3d rot_vec(angle(gen), angle(gen), angle(gen) / 5.);
+      const cv::Vec3d trans_vec(lateral(gen) * z, lateral(gen) * z * 0.75, z);
+
+      cv::projectPoints(object_points, rot_vec, trans_vec, cam_mat, distor_coff,
+                        expect);
+      camera.Project(object_points, rot_vec, trans_vec, result);
+
+      ASSERT_EQ(result.size(), expect.size());
+      for (std::size_t j = 0; j < result.size(); ++j)
+        max_err = std::max(max_err, cv::norm(result[j] - expect[j]));
+    }
+    EXPECT_LT(max_err, 1e-3) << path;
+  }
+}
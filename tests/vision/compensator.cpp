@@ -2,7 +2,80 @@
 
 #include "gtest/gtest.h"
 
+namespace {
+
+const std::string kCAM_PATH = "../../../runtime/MV-CA016-10UC-6mm.json";
+
+/* 按给定位姿投影出一块小装甲板 */
+Armor MakeArmor(const cv::Vec3d &trans_vec, const cv::Mat &cam_mat,
+                const cv::Mat &distor_coff) {
+  Armor armor;
+  armor.SetModel(game::Model::kINFANTRY);
+  cv::projectPoints(armor.PhysicVertices(), cv::Vec3d(0., 0.3, 0.), trans_vec,
+                    cam_mat, distor_coff, armor.image_vertices_);
+  armor.image_center_ =
+      (armor.image_vertices_[0] + armor.image_vertices_[2]) / 2.;
+  return armor;
+}
+
+}  // namespace
+
 TEST(TestVision, TestCompensator) {
   Compensator compensator;
   ASSERT_EQ(1, 1);
-}
\ No newline at end of file
+}
+
+TEST(TestVision, TestCompensatorUnsolved) {
+  cv::FileStorage fs(kCAM_PATH,
+                     cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+  ASSERT_TRUE(fs.isOpened());
+  const cv::Mat cam_mat = fs["cam_mat"].mat();
+  const cv::Mat distor_coff = fs["distor_coff"].mat();
+  Compensator compensator(kCAM_PATH);
+  const cv::Mat frame(480, 640, CV_8UC3);
+
+  /* 角点不足的装甲板在画面中心，仍排在解算成功的装甲板之后 */
+  tbb::concurrent_vector<Armor> armors;
+  armors.push_back(MakeArmor(cv::Vec3d(0., 0., 2000.), cam_mat, distor_coff));
+  armors.back().image_vertices_.resize(2);
+  armors.push_back(
+      MakeArmor(cv::Vec3d(500., 0., 3000.), cam_mat, distor_coff));
+
+  EXPECT_EQ(compensator.Apply(armors, frame, {0., 0., 0.}), 1u);
+  ASSERT_EQ(armors.size(), 2u);
+  EXPECT_FALSE(armors.front().GetTransVec().empty());
+  EXPECT_TRUE(armors.back().GetTransVec().empty());
+}
+
+TEST(TestVision, TestCompensatorApply) {
+  cv::FileStorage fs(kCAM_PATH,
+                     cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+  ASSERT_TRUE(fs.isOpened());
+  const cv::Mat cam_mat = fs["cam_mat"].mat();
+  const cv::Mat distor_coff = fs["distor_coff"].mat();
+  Compensator compensator(kCAM_PATH);
+  const cv::Mat frame(480, 640, CV_8UC3);
+
+  tbb::concurrent_vector<Armor> armors;
+  for (int i = 0; i < 12; ++i)
+    armors.push_back(MakeArmor(
+        cv::Vec3d(600. * (i % 4 - 1.5), 200. * (i / 4 - 1), 2000. + 300. * i),
+        cam_mat, distor_coff));
+
+  /* 经过目标选择的前 10 个保持原顺序，其余不解算 */
+  std::vector<cv::Point2f> centers;
+  for (const auto &armor : armors) centers.push_back(armor.ImageCenter());
+  EXPECT_EQ(compensator.Apply(armors, frame, {0., 0., 0.}, 10), 10u);
+  ASSERT_EQ(armors.size(), 12u);
+  for (std::size_t i = 0; i < 12; ++i) {
+    EXPECT_EQ(armors[i].ImageCenter(), centers[i]);
+    EXPECT_EQ(armors[i].GetTransVec().empty(), i >= 10);
+  }
+
+  /* 未经选择时解算全部，按到画面中心的距离排序 */
+  EXPECT_EQ(compensator.Apply(armors, frame, {0., 0., 0.}), 12u);
+  const cv::Point2f center(frame.cols / 2, frame.rows / 2);
+  for (std::size_t i = 1; i < armors.size(); ++i)
+    EXPECT_LE(cv::norm(armors[i - 1].ImageCenter() - center),
+              cv::norm(armors[i].ImageCenter() - center));
+}
@@ -0,0 +1,49 @@
+#include "filter_tuner.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "spdlog/spdlog.h"
+
+TEST(TestVision, TestFilterTuner) {
+  spdlog::set_level(spdlog::level::err);
+  FilterTuner tuner;
+  std::mt19937 gen(0);
+  std::normal_distribution<double> noise(0., 1.);
+
+  for (int i = 0; i < 300; ++i)
+    tuner.AddMeasurement({100. + 2. * i + noise(gen), 200. + noise(gen)});
+
+  tuner.GridSearch(cv::Vec2d(1e-4, 1.), cv::Vec2d(1e-2, 1e2), 8);
+  tuner.RandomSearch(cv::Vec2d(1e-4, 1.), cv::Vec2d(1e-2, 1e2), 64);
+  const TunerResult &best = tuner.Run();
+
+  ASSERT_EQ(tuner.GetResults().size(), 1u + 8u * 8u + 64u);
+  ASSERT_EQ(best.config.method, Method::kKF);
+
+  const TunerResult baseline = tuner.Replay({Method::kEKF, 0., 0.});
+  EXPECT_LT(best.rmse, baseline.rmse);
+  EXPECT_GT(best.frames, 0u);
+}
+
+TEST(TestVision, TestFilterTunerLoadLog) {
+  spdlog::set_level(spdlog::level::err);
+  const char path[] = "filter_tuner_test.csv";
+  {
+    std::ofstream file(path);
+    file << "stamp,x,y\n"
+         << "0.00,1.0,2.0\n"
+         << "0.01,,2.1\n"
+         << "# comment\n"
+         << "0.02,1.2,2.2\n"
+         << "0.03,1e999,2.3\n";
+  }
+
+  /* 表头、空字段与越界的行被跳过，不会抛出异常 */
+  FilterTuner tuner;
+  EXPECT_TRUE(tuner.LoadLog(path));
+  EXPECT_EQ(tuner.GetFrames(), 2u);
+  std::remove(path);
+}
@@ -0,0 +1,80 @@
+#include "pnp_solver.hpp"
+
+#include <random>
+
+#include "armor.hpp"
+#include "gtest/gtest.h"
+
+namespace {
+
+const std::string kCAM_PATH = "../../../runtime/MV-CA016-10UC-6mm.json";
+const int kPOSES = 500;
+
+struct Sample {
+  Pose truth, guess;
+  std::vector<cv::Point2f> image_points;
+};
+
+/* 在相机前方随机生成装甲板位姿，并给出带噪声的投影和上一帧位姿 */
+std::vector<Sample> MakeSamples(const cv::Mat &object_points,
+                                const cv::Mat &cam_mat,
+                                const cv::Mat &distor_coff) {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<double> angle(-0.6, 0.6);
+  std::uniform_real_distribution<double> lateral(-800., 800.);
+  std::uniform_real_distribution<double> depth(1000., 6000.);
+  std::normal_distribution<double> noise(0., 0.3);
+
+  std::vector<Sample> samples;
+  while (samples.size() < kPOSES) {
+    Sample sample;
+    sample.truth.rot_vec = cv::Vec3d(angle(gen) / 2., angle(gen), 0.);
+    sample.truth.trans_vec =
+        cv::Vec3d(lateral(gen), lateral(gen) / 4., depth(gen));
+    sample.guess.rot_vec = sample.truth.rot_vec + cv::Vec3d(0.02, 0.02, 0.);
+    sample.guess.trans_vec = sample.truth.trans_vec + cv::Vec3d(5., 5., 20.);
+
+    cv::projectPoints(object_points, sample.truth.rot_vec,
+                      sample.truth.trans_vec, cam_mat, distor_coff,
+                      sample.image_points);
+    for (auto &pt : sample.image_points)
+      pt += cv::Point2f(noise(gen), noise(gen));
+    samples.emplace_back(sample);
+  }
+  return samples;
+}
+
+}  // namespace
+
+TEST(TestVision, TestPnpSolver) {
+  cv::FileStorage fs(kCAM_PATH,
+                     cv::FileStorage::READ | cv::FileStorage::FORMAT_JSON);
+  ASSERT_TRUE(fs.isOpened());
+  cv::Mat cam_mat = fs["cam_mat"].mat(), distor_coff = fs["distor_coff"].mat();
+
+  Armor armor;
+  armor.SetModel(game::Model::kINFANTRY);
+  const cv::Mat object_points = armor.PhysicVertices();
+
+  PnpSolver solver;
+  solver.SetCamera(cam_mat, distor_coff);
+  auto samples = MakeSamples(object_points, cam_mat, distor_coff);
+
+  double err_fast = 0., err_iter = 0.;
+  for (auto &sample : samples) {
+    Pose pose;
+    ASSERT_TRUE(
+        solver.Solve(object_points, sample.image_points, &sample.guess, pose));
+    err_fast += cv::norm(pose.trans_vec - sample.truth.trans_vec);
+
+    cv::Mat rot_vec, trans_vec;
+    cv::solvePnP(object_points, sample.image_points, cam_mat, distor_coff,
+                 rot_vec, trans_vec, false, cv::SOLVEPNP_ITERATIVE);
+    err_iter += cv::norm(cv::Vec3d(trans_vec) - sample.truth.trans_vec);
+  }
+  err_fast /= samples.size(), err_iter /= samples.size();
+
+  /* 耗时对比见 tests/benchmark/pnp_solver.cpp */
+  EXPECT_LT(err_fast, err_iter * 1.05 + 1.);
+  EXPECT_LT(solver.FallbackRatio(), 0.05);
+}
@@ -0,0 +1,89 @@
+#include "sine_fitter.hpp"
+
+#include <cmath>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const double kA = 0.9;
+const double kW = 1.95;
+const double kB = 2.090 - kA;
+const double kPHASE = 0.7;
+const double kHORIZON = 0.15;
+
+double Angle(double t) { return kB * t - kA / kW * std::cos(kW * t + kPHASE); }
+
+double Wrap(double angle) { return std::remainder(angle, 2. * CV_PI); }
+
+}  // namespace
+
+TEST(TestVision, TestSineFitter) {
+  SineFitter fitter;
+  std::mt19937 gen(0);
+  std::normal_distribution<double> noise(0., 0.005);
+
+  double max_err = 0.;
+  for (double t = 0.; t < 12.; t += 0.01) {
+    fitter.Update(t, Wrap(Angle(t) + noise(gen)));
+    if (t > 4.) {
+      ASSERT_TRUE(fitter.Ready());
+      const double err = std::abs(fitter.PredictRotatedAngle(t, kHORIZON) -
+                                  (Angle(t + kHORIZON) - Angle(t)));
+      max_err = std::max(max_err, err);
+    }
+  }
+  EXPECT_LT(max_err, 0.01);
+  EXPECT_NEAR(fitter.GetOmega(), kW, 0.02);
+  EXPECT_NEAR(fitter.GetAmplitude(), kA, 0.05);
+  EXPECT_NEAR(fitter.GetOffset(), kB, 0.05);
+}
+
+TEST(TestVision, TestSineFitterBladeSwitch) {
+  SineFitter fitter;
+  std::mt19937 gen(0);
+  std::normal_distribution<double> noise(0., 0.005);
+
+  /* 每 2s 切换一次扇叶，角度跳变整数个扇叶间隔 */
+  double max_err = 0.;
+  for (double t = 0.; t < 12.; t += 0.01) {
+    const double blade = std::floor(t / 2.) * 3. * 2. * CV_PI / 5.;
+    fitter.Update(t, Wrap(Angle(t) + blade + noise(gen)));
+    if (t > 4.) {
+      ASSERT_TRUE(fitter.Ready());
+      const double err = std::abs(fitter.PredictRotatedAngle(t, kHORIZON) -
+                                  (Angle(t + kHORIZON) - Angle(t)));
+      max_err = std::max(max_err, err);
+    }
+  }
+  EXPECT_LT(max_err, 0.01);
+  EXPECT_NEAR(fitter.GetOmega(), kW, 0.02);
+}
+
+TEST(TestVision, TestSineFitterDropout) {
+  SineFitter fitter;
+  std::mt19937 gen(0);
+  std::normal_distribution<double> noise(0., 0.005);
+
+  /* 转速在 kW * t + kPHASE = 5π/2 时最高，其前后丢失 0.4s，期间转过的角度
+   * 超过半个扇叶间隔，必须重新拟合而不是按扇叶间隔错误展开 */
+  const double peak = (2.5 * CV_PI - kPHASE) / kW;
+  const double lost = peak - 0.2, found = peak + 0.2;
+  ASSERT_GT(kB + kA * std::sin(kW * peak + kPHASE), 2.);
+
+  double max_err = 0.;
+  for (double t = 0.; t < found + 8.; t += 0.01) {
+    if (t > lost && t < found) continue;
+    const bool resumed = t >= found && t < found + 0.01;
+    fitter.Update(t, Wrap(Angle(t) + noise(gen)));
+    if (resumed) EXPECT_FALSE(fitter.Ready());
+    if (t > found + 4.) {
+      ASSERT_TRUE(fitter.Ready());
+      const double err = std::abs(fitter.PredictRotatedAngle(t, kHORIZON) -
+                                  (Angle(t + kHORIZON) - Angle(t)));
+      max_err = std::max(max_err, err);
+    }
+  }
+  EXPECT_LT(max_err, 0.01);
+}
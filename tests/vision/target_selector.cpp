@@ -0,0 +1,56 @@
+#include "target_selector.hpp"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const cv::Size kFRAME_SIZE(640, 480);
+const std::string kPARAM = "../../../runtime/RMUT2022_Select.json";
+
+Armor MakeArmor(const cv::Point2f &center, float width, game::Model model) {
+  Armor armor(cv::RotatedRect(center, cv::Size2f(width, width * 0.5f), 0.f));
+  armor.SetModel(model);
+  return armor;
+}
+
+/* 只看兵种优先级的策略 */
+class PriorityPolicy : public SelectionPolicy {
+ public:
+  double Score(const TargetFeature &feature) const override {
+    return feature.priority;
+  }
+};
+
+}  // namespace
+
+TEST(TestVision, TestTargetSelector) {
+  TargetSelector selector;
+  ASSERT_TRUE(selector.LoadParams(kPARAM));
+  ASSERT_EQ(selector.GetTopK(), 3u);
+
+  tbb::concurrent_vector<Armor> armors;
+  armors.push_back(MakeArmor({600.f, 50.f}, 40.f, game::Model::kINFANTRY));
+  armors.push_back(MakeArmor({330.f, 250.f}, 60.f, game::Model::kINFANTRY));
+  armors.push_back(MakeArmor({100.f, 400.f}, 20.f, game::Model::kENGINEER));
+  armors.push_back(MakeArmor({200.f, 240.f}, 60.f, game::Model::kHERO));
+
+  ASSERT_EQ(selector.Select(armors, kFRAME_SIZE), 3u);
+  ASSERT_EQ(armors.size(), 4u);
+  EXPECT_EQ(armors[0].ImageCenter(), cv::Point2f(330.f, 250.f));
+  EXPECT_EQ(armors[1].GetModel(), game::Model::kHERO);
+  EXPECT_EQ(armors[3].GetModel(), game::Model::kENGINEER);
+
+  selector.SetPolicy(std::unique_ptr<SelectionPolicy>(new PriorityPolicy));
+  selector.Select(armors, kFRAME_SIZE);
+  EXPECT_EQ(armors[0].GetModel(), game::Model::kHERO);
+
+  /* 候选多于 top_k 时只选出 top_k 个，其余仍保留 */
+  TargetSelector fast;
+  tbb::concurrent_vector<Armor> batch;
+  for (int i = 0; i < 12; ++i)
+    batch.push_back(MakeArmor({50.f * i + 20.f, 30.f * i + 40.f},
+                              20.f + 3.f * i, game::Model::kINFANTRY));
+  const std::size_t selected = fast.Select(batch, kFRAME_SIZE);
+  ASSERT_EQ(selected, fast.GetTopK());
+  EXPECT_EQ(batch.size(), 12u);
+}